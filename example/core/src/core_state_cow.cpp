@@ -0,0 +1,176 @@
+//============================================================================
+// vSMC/example/core/src/core_state_cow.cpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c); 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION); HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE);
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#include <vsmc/core/state_cow.hpp>
+#include <vsmc/core/state_matrix.hpp>
+#include <vsmc/resample/resample.hpp>
+#include <vsmc/rng/engine.hpp>
+
+static const std::size_t CoreStateCOWDim = 4;
+
+using CoreStateCOW = vsmc::StateCOW<CoreStateCOWDim, double>;
+
+using CoreStateCOWMatrix =
+    vsmc::StateMatrix<vsmc::RowMajor, CoreStateCOWDim, double>;
+
+inline bool core_state_cow_check(const std::string &name, bool passed)
+{
+    std::cout << std::left << std::setw(50) << name;
+    std::cout << std::right << std::setw(10) << (passed ? "Passed" : "Failed");
+    std::cout << std::endl;
+
+    return passed;
+}
+
+template <typename State>
+inline void core_state_cow_fill(State &state)
+{
+    for (std::size_t i = 0; i != state.size(); ++i)
+        for (std::size_t d = 0; d != CoreStateCOWDim; ++d)
+            state.state(i, d) = static_cast<double>(i * 10 + d);
+}
+
+inline bool core_state_cow_equal(
+    const CoreStateCOW &scow, const CoreStateCOWMatrix &smat)
+{
+    for (std::size_t i = 0; i != scow.size(); ++i)
+        for (std::size_t d = 0; d != CoreStateCOWDim; ++d)
+            if (scow.cstate(i, d) != smat.state(i, d))
+                return false;
+
+    return true;
+}
+
+// Resampling with repeated parents shares rows, writing to a child copies
+// only its own row, and the rows no longer referred to are reused
+inline bool core_state_cow_share()
+{
+    const std::size_t N = 8;
+    const std::size_t index[N] = {0, 0, 0, 1, 1, 2, 2, 3};
+    CoreStateCOW scow(N);
+    core_state_cow_fill(scow);
+
+    std::vector<const double *> rows;
+    for (std::size_t i = 0; i != N; ++i)
+        rows.push_back(scow.crow_data(i));
+    const std::vector<const double *> dead(rows.begin() + 4, rows.end());
+
+    scow.copy(N, index);
+
+    bool shared = true;
+    for (std::size_t i = 0; i != N; ++i) {
+        shared = shared && scow.crow_data(i) == rows[index[i]];
+        shared = shared && scow.shared(i) == (i != 7);
+    }
+    for (std::size_t i = 0; i != N; ++i)
+        for (std::size_t d = 0; d != CoreStateCOWDim; ++d)
+            shared = shared && scow.cstate(i, d) == index[i] * 10 + d;
+
+    scow.state(1, 0) = -1;
+    bool detached = true;
+    detached = detached && scow.crow_data(1) != scow.crow_data(0);
+    detached = detached && scow.crow_data(0) == scow.crow_data(2);
+    detached = detached && !scow.shared(1) && scow.shared(0);
+    detached = detached && scow.cstate(1, 0) == -1;
+    detached = detached && scow.cstate(0, 0) == 0 && scow.cstate(2, 0) == 0;
+    for (std::size_t d = 1; d != CoreStateCOWDim; ++d)
+        detached = detached && scow.cstate(1, d) == d;
+
+    const bool reused = std::find(dead.begin(), dead.end(),
+                            scow.crow_data(1)) != dead.end();
+
+    bool passed = true;
+    passed = core_state_cow_check("Share rows of repeated parents", shared) &&
+        passed;
+    passed = core_state_cow_check("Detach a written child", detached) &&
+        passed;
+    passed = core_state_cow_check("Reuse dropped rows", reused) && passed;
+
+    return passed;
+}
+
+// A sequence of resampling and writes gives the same states as StateMatrix,
+// and a copy of the object is unaffected by the writes to the original
+inline bool core_state_cow_matrix(std::size_t N)
+{
+    vsmc::RNG rng;
+    std::uniform_real_distribution<double> runif(0, 1);
+    vsmc::ResampleMultinomial resample;
+    vsmc::Vector<double> weight(N);
+    vsmc::Vector<std::size_t> rep(N);
+    vsmc::Vector<std::size_t> index(N);
+
+    CoreStateCOW scow(N);
+    CoreStateCOWMatrix smat(N);
+    core_state_cow_fill(scow);
+    core_state_cow_fill(smat);
+
+    bool passed = true;
+    for (std::size_t iter = 0; iter != 20; ++iter) {
+        double sum = 0;
+        for (std::size_t i = 0; i != N; ++i)
+            sum += weight[i] = runif(rng);
+        for (std::size_t i = 0; i != N; ++i)
+            weight[i] /= sum;
+        resample(N, N, rng, weight.data(), rep.data());
+        vsmc::resample_trans_rep_index(N, N, rep.data(), index.data());
+        scow.copy(N, index.data());
+        smat.copy(N, index.data());
+
+        const CoreStateCOW clone(scow);
+        const CoreStateCOWMatrix snapshot(smat);
+        for (std::size_t i = 0; i != N; ++i) {
+            if (runif(rng) < 0.3) {
+                const std::size_t d = i % CoreStateCOWDim;
+                const double v = runif(rng);
+                scow.state(i, d) += v;
+                smat.state(i, d) += v;
+            }
+        }
+        passed = passed && core_state_cow_equal(scow, smat);
+        passed = passed && core_state_cow_equal(clone, snapshot);
+    }
+
+    return core_state_cow_check("Same as StateMatrix", passed);
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t N = 10000;
+    if (argc > 1)
+        N = static_cast<std::size_t>(std::atoi(argv[1]));
+
+    bool passed = true;
+    passed = core_state_cow_share() && passed;
+    passed = core_state_cow_matrix(N) && passed;
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
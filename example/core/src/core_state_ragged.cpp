@@ -0,0 +1,162 @@
+//============================================================================
+// vSMC/example/core/src/core_state_ragged.cpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c); 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION); HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE);
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#include <vsmc/core/particle.hpp>
+#include <vsmc/core/state_ragged.hpp>
+
+using CoreStateRagged = vsmc::StateRagged<double>;
+
+// StateRagged has a fixed number of particles, which Particle::resize shall
+// not mistake its per-particle resizing for
+static_assert(!vsmc::internal::is_state_resize<CoreStateRagged>::value,
+    "**StateRagged** MISTAKEN FOR A RESIZABLE STATE");
+
+inline bool core_state_ragged_check(const std::string &name, bool passed)
+{
+    std::cout << std::left << std::setw(50) << name;
+    std::cout << std::right << std::setw(10) << (passed ? "Passed" : "Failed");
+    std::cout << std::endl;
+
+    return passed;
+}
+
+inline double core_state_ragged_value(std::size_t i, std::size_t k)
+{
+    return static_cast<double>(i * 1000 + k);
+}
+
+// The particles have the lengths and contents of the original particles
+// index[i], in an arena with segments left unused by resizing
+inline bool core_state_ragged_equal(const CoreStateRagged &sragged,
+    const vsmc::Vector<std::size_t> &dim,
+    const vsmc::Vector<std::size_t> &index)
+{
+    for (std::size_t i = 0; i != sragged.size(); ++i) {
+        if (sragged.dim(i) != dim[index[i]])
+            return false;
+        for (std::size_t k = 0; k != sragged.dim(i); ++k)
+            if (sragged.state(i, k) != core_state_ragged_value(index[i], k))
+                return false;
+    }
+
+    return true;
+}
+
+inline void core_state_ragged_fill(CoreStateRagged &sragged,
+    vsmc::Vector<std::size_t> &dim, std::mt19937 &rng)
+{
+    std::uniform_int_distribution<std::size_t> rlen(0, 8);
+    const std::size_t N = sragged.size();
+    dim.resize(N);
+    for (std::size_t i = 0; i != N; ++i) {
+        dim[i] = rlen(rng);
+        sragged.resize_row(i, dim[i]);
+        for (std::size_t k = 0; k != dim[i]; ++k)
+            sragged.state(i, k) = core_state_ragged_value(i, k);
+    }
+}
+
+inline bool core_state_ragged_copy(std::size_t N)
+{
+    std::mt19937 rng;
+    std::uniform_int_distribution<std::size_t> rindex(0, N / 2);
+    vsmc::Vector<std::size_t> dim;
+    vsmc::Vector<std::size_t> identity(N);
+    for (std::size_t i = 0; i != N; ++i)
+        identity[i] = i;
+
+    // Each particle is resized beyond its capacity, leaving its first
+    // segment unused
+    CoreStateRagged sragged(N, 2);
+    core_state_ragged_fill(sragged, dim, rng);
+    const bool filled = core_state_ragged_equal(sragged, dim, identity);
+
+    // Parents drawn from the first half, such that some are repeated and the
+    // others skipped
+    vsmc::Vector<std::size_t> index(N);
+    for (std::size_t i = 0; i != N; ++i)
+        index[i] = rindex(rng);
+    std::sort(index.begin(), index.end());
+    const CoreStateRagged clone(sragged);
+    sragged.copy(N, index.data());
+    const bool copied = core_state_ragged_equal(sragged, dim, index) &&
+        core_state_ragged_equal(clone, dim, identity);
+
+    // Compaction after resizing keeps the values
+    CoreStateRagged compacted(clone);
+    for (std::size_t i = 0; i < N; i += 3) {
+        compacted.resize_row(i, dim[i] + 10);
+        compacted.resize_row(i, dim[i]);
+    }
+    const std::size_t arena_size = compacted.arena_size();
+    compacted.compact();
+    bool repacked = core_state_ragged_equal(compacted, dim, identity);
+    repacked = repacked && compacted.arena_size() < arena_size;
+    repacked = repacked &&
+        compacted.arena_size() ==
+            std::accumulate(dim.begin(), dim.end(),
+                static_cast<std::size_t>(0));
+
+    // Changing all lengths keeps the common prefixes, and zero fills the rest
+    vsmc::Vector<std::size_t> len(N);
+    for (std::size_t i = 0; i != N; ++i)
+        len[i] = (dim[i] + i) % 9;
+    compacted.resize_rows(len.begin());
+    bool resized = true;
+    for (std::size_t i = 0; i != N; ++i) {
+        resized = resized && compacted.dim(i) == len[i];
+        for (std::size_t k = 0; k != len[i]; ++k) {
+            const double v =
+                k < dim[i] ? core_state_ragged_value(i, k) : 0.0;
+            resized = resized && compacted.state(i, k) == v;
+        }
+    }
+
+    bool passed = true;
+    passed = core_state_ragged_check("Resize particles", filled) && passed;
+    passed =
+        core_state_ragged_check("Copy with repeated parents", copied) &&
+        passed;
+    passed = core_state_ragged_check("Compact", repacked) && passed;
+    passed = core_state_ragged_check("Resize all particles", resized) &&
+        passed;
+
+    return passed;
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t N = 10000;
+    if (argc > 1)
+        N = static_cast<std::size_t>(std::atoi(argv[1]));
+
+    return core_state_ragged_copy(N) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,140 @@
+//============================================================================
+// vSMC/example/core/src/core_state_tuple.cpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c); 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION); HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE);
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#include <vsmc/core/state_tuple.hpp>
+#include <vsmc/resample/resample.hpp>
+#include <vsmc/rng/engine.hpp>
+
+template <vsmc::MatrixLayout Layout>
+using CoreStateTuple = vsmc::StateTuple<Layout, double, int, float, char>;
+
+inline bool core_state_tuple_check(const std::string &name, bool passed)
+{
+    std::cout << std::left << std::setw(50) << name;
+    std::cout << std::right << std::setw(10) << (passed ? "Passed" : "Failed");
+    std::cout << std::endl;
+
+    return passed;
+}
+
+template <vsmc::MatrixLayout Layout>
+inline void core_state_tuple_fill(CoreStateTuple<Layout> &stuple)
+{
+    for (std::size_t i = 0; i != stuple.size(); ++i) {
+        stuple.template state<0>(i) = static_cast<double>(i) + 0.5;
+        stuple.template state<1>(i) = static_cast<int>(i) * 2;
+        stuple.template state<2>(i) = static_cast<float>(i) * 0.25f;
+        stuple.template state<3>(i) = static_cast<char>(i % 128);
+    }
+}
+
+inline bool core_state_tuple_equal(const CoreStateTuple<vsmc::RowMajor> &aos,
+    const CoreStateTuple<vsmc::ColMajor> &soa)
+{
+    for (std::size_t i = 0; i != aos.size(); ++i) {
+        if (aos.state<0>(i) != soa.state<0>(i))
+            return false;
+        if (aos.state<1>(i) != soa.state<1>(i))
+            return false;
+        if (aos.state<2>(i) != soa.state<2>(i))
+            return false;
+        if (aos.state<3>(i) != soa.state<3>(i))
+            return false;
+    }
+
+    return true;
+}
+
+// AoS and SoA layouts give the same states after the same resampling, which
+// copies a parent either as a tuple or column by column
+inline bool core_state_tuple_copy(std::size_t N)
+{
+    vsmc::RNG rng;
+    std::uniform_real_distribution<double> runif(0, 1);
+    vsmc::ResampleSystematic resample;
+    vsmc::Vector<double> weight(N);
+    vsmc::Vector<std::size_t> rep(N);
+    vsmc::Vector<std::size_t> index(N);
+
+    CoreStateTuple<vsmc::RowMajor> aos(N);
+    CoreStateTuple<vsmc::ColMajor> soa(N);
+    core_state_tuple_fill(aos);
+    core_state_tuple_fill(soa);
+
+    bool copied = true;
+    bool identity = true;
+    for (std::size_t iter = 0; iter != 10; ++iter) {
+        double sum = 0;
+        for (std::size_t i = 0; i != N; ++i)
+            sum += weight[i] = runif(rng) * runif(rng);
+        for (std::size_t i = 0; i != N; ++i)
+            weight[i] /= sum;
+        resample(N, N, rng, weight.data(), rep.data());
+        vsmc::resample_trans_rep_index(N, N, rep.data(), index.data());
+        for (std::size_t i = 0; i != N; ++i)
+            identity = identity && index[i] == i;
+
+        const CoreStateTuple<vsmc::RowMajor> parents(aos);
+        aos.copy(N, index.data());
+        soa.copy(N, index.data());
+        copied = copied && core_state_tuple_equal(aos, soa);
+        for (std::size_t i = 0; i != N; ++i)
+            copied = copied && aos.state<1>(i) == parents.state<1>(index[i]);
+
+        for (std::size_t i = 0; i != N; ++i) {
+            aos.state<0>(i) += runif(rng);
+            soa.state<0>(i) = aos.state<0>(i);
+        }
+    }
+
+    // Packing a particle of one layout and unpacking it into the other
+    bool packed = true;
+    for (std::size_t i = 0; i != N; ++i)
+        soa.state_unpack(N - 1 - i, aos.state_pack(i));
+    for (std::size_t i = 0; i != N; ++i)
+        packed = packed && aos.state_pack(i) == soa.state_pack(N - 1 - i);
+
+    bool passed = true;
+    passed = core_state_tuple_check("AoS and SoA copy", copied && !identity) &&
+        passed;
+    passed = core_state_tuple_check("AoS and SoA pack", packed) && passed;
+
+    return passed;
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t N = 10000;
+    if (argc > 1)
+        N = static_cast<std::size_t>(std::atoi(argv[1]));
+
+    return core_state_tuple_copy(N) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -36,6 +36,7 @@
 
 #include <vsmc/core/sampler.hpp>
 #include <vsmc/core/state_matrix.hpp>
+#include <vsmc/core/tempering.hpp>
 #include <vsmc/smp/backend_@smp@.hpp>
 #include <vsmc/utility/program_option.hpp>
 #include <vsmc/utility/stop_watch.hpp>
@@ -406,6 +407,15 @@ class gmm_init : public InitializeSMP<gmm_state, gmm_init>
     }
 };
 
+inline void gmm_proposal_scale(vsmc::Particle<gmm_state> &particle)
+{
+    double alpha = particle.value().alpha();
+    alpha = alpha < 0.02 ? 0.02 : alpha;
+    particle.value().mu_sd(0.15 / alpha);
+    particle.value().lambda_sd((1 + std::sqrt(1 / alpha)) * 0.15);
+    particle.value().weight_sd((1 + std::sqrt(1 / alpha)) * 0.2);
+}
+
 class gmm_move_smc
 {
     public:
@@ -421,25 +431,19 @@ class gmm_move_smc
         std::size_t iter, vsmc::Particle<gmm_state> &particle)
     {
         alpha_setter_(iter, particle);
+        gmm_proposal_scale(particle);
 
-        double alpha = particle.value().alpha();
-        alpha = alpha < 0.02 ? 0.02 : alpha;
-        particle.value().mu_sd(0.15 / alpha);
-        particle.value().lambda_sd((1 + std::sqrt(1 / alpha)) * 0.15);
-        particle.value().weight_sd((1 + std::sqrt(1 / alpha)) * 0.2);
-
-        w_.resize(particle.size());
+        double *const w = particle.arena().allocate<double>(particle.size());
         double coeff = particle.value().alpha_inc();
         for (std::size_t i = 0; i != particle.size(); ++i)
-            w_[i] = coeff * particle.value().state(i, 0).log_likelihood();
-        particle.weight().add_log(w_.data());
+            w[i] = coeff * particle.value().state(i, 0).log_likelihood();
+        particle.weight().add_log(w);
 
         return 0;
     }
 
     private:
     alpha_setter_type alpha_setter_;
-    vsmc::Vector<double> w_;
 };
 
 class gmm_move_mu : public MoveSMP<gmm_state, gmm_move_mu>
@@ -578,12 +582,35 @@ class gmm_alpha_prior
     std::size_t power_;
 };
 
+class gmm_log_likelihood
+{
+    public:
+    void operator()(std::size_t, vsmc::Particle<gmm_state> &particle,
+        double *ll) const
+    {
+        for (std::size_t i = 0; i != particle.size(); ++i)
+            ll[i] = particle.value().state(i, 0).log_likelihood();
+    }
+};
+
+class gmm_alpha_adaptive
+{
+    public:
+    void operator()(
+        std::size_t, double alpha, vsmc::Particle<gmm_state> &particle) const
+    {
+        particle.value().alpha(alpha);
+        gmm_proposal_scale(particle);
+    }
+};
+
 inline int gmm_main(int argc, char **argv)
 {
     std::size_t N = 1000;
     std::size_t n = 100;
     std::size_t c = 4;
     std::size_t power = 2;
+    double cess = 0;
     std::string datafile("gmm.data");
 
     vsmc::ProgramOptionMap option;
@@ -591,6 +618,8 @@ inline int gmm_main(int argc, char **argv)
         .add("n", "Number of iterations", &n, 100)
         .add("c", "Number of components", &c, 4)
         .add("power", "Power of the prior annealing (0 for linear)", &power, 2)
+        .add("cess", "Target CESS of adaptive tempering (0 for fixed schedule)",
+            &cess, 0)
         .add("datafile", "File name of the data", &datafile, "gmm.data");
     option.process(argc, argv);
 
@@ -603,8 +632,14 @@ inline int gmm_main(int argc, char **argv)
     vsmc::Seed::instance().set(101);
     vsmc::Sampler<gmm_state> sampler(N, vsmc::Stratified, 0.5);
     sampler.particle().value().comp_num(c);
+    if (cess > 0) {
+        sampler.move(vsmc::TemperingAdaptive<gmm_state>(
+                         gmm_log_likelihood(), gmm_alpha_adaptive(), cess),
+            false);
+    } else {
+        sampler.move(gmm_move_smc(alpha_setter), false);
+    }
     sampler.init(gmm_init())
-        .move(gmm_move_smc(alpha_setter), false)
         .mcmc(gmm_move_mu(), false)
         .mcmc(gmm_move_lambda(), true)
         .mcmc(gmm_move_weight(), true)
@@ -613,7 +648,13 @@ inline int gmm_main(int argc, char **argv)
 
     vsmc::StopWatch watch;
     watch.start();
-    sampler.initialize(const_cast<char *>(datafile.c_str())).iterate(n);
+    sampler.initialize(const_cast<char *>(datafile.c_str()));
+    if (cess > 0) {
+        while (sampler.particle().value().alpha() < 1)
+            sampler.iterate();
+    } else {
+        sampler.iterate(n);
+    }
     double ps = 0;
     auto ps_integrand = sampler.monitor("path_integrand");
     auto ps_grid = sampler.monitor("path_grid");
@@ -624,6 +665,8 @@ inline int gmm_main(int argc, char **argv)
     }
     watch.stop();
 
+    std::cout << "Number of iterations: " << sampler.iter_size() - 1
+              << std::endl;
     std::cout << "Path sampling estimate: " << ps << std::endl;
     std::cout << "Wallclock Time: " << watch.seconds() << "s" << std::endl;
 
@@ -0,0 +1,189 @@
+//============================================================================
+// vSMC/example/math/src/math_vmath.cpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c); 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION); HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE);
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#include <vsmc/math/math.hpp>
+#include <vsmc/rng/engine.hpp>
+#include <vsmc/utility/stop_watch.hpp>
+
+template <typename T>
+inline long double math_vmath_ulp(T y, long double r)
+{
+    const T t = static_cast<T>(r);
+    if (std::isnan(t) || std::isnan(y))
+        return std::isnan(t) && std::isnan(y) ? 0 : 1e10;
+    if (std::isinf(t) || std::isinf(y))
+        return t == y ? 0 : 1e10;
+
+    const T a = std::abs(t);
+    const long double u =
+        std::nextafter(a, std::numeric_limits<T>::infinity()) - a;
+
+    return std::abs(static_cast<long double>(y) - r) / u;
+}
+
+template <typename T>
+inline void math_vmath_special(vsmc::Vector<T> &a)
+{
+    const T inf = std::numeric_limits<T>::infinity();
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    const T special[] = {0, -static_cast<T>(0), 1, -1, inf, -inf, nan,
+        std::numeric_limits<T>::min(), std::numeric_limits<T>::denorm_min(),
+        std::numeric_limits<T>::max(), -std::numeric_limits<T>::max()};
+    a.insert(a.end(), std::begin(special), std::end(special));
+}
+
+template <typename T, typename Input, typename Ref, typename SIMD,
+    typename STD>
+inline void math_vmath_test(std::size_t N, const std::string &name,
+    Input &&input, Ref &&ref, SIMD &&simd, STD &&stdf)
+{
+    vsmc::RNG rng;
+    vsmc::Vector<T> a(N);
+    vsmc::Vector<T> y1;
+    vsmc::Vector<T> y2;
+    for (std::size_t i = 0; i != N; ++i)
+        a[i] = input(rng);
+    math_vmath_special<T>(a);
+    y1.resize(a.size());
+    y2.resize(a.size());
+
+    vsmc::StopWatch watch1;
+    vsmc::StopWatch watch2;
+    for (std::size_t k = 0; k != 10; ++k) {
+        watch1.start();
+        stdf(a.size(), a.data(), y1.data());
+        watch1.stop();
+        watch2.start();
+        simd(a.size(), a.data(), y2.data());
+        watch2.stop();
+    }
+
+    long double e1 = 0;
+    long double e2 = 0;
+    for (std::size_t i = 0; i != a.size(); ++i) {
+        const long double r = ref(static_cast<long double>(a[i]));
+        e1 = std::max(e1, math_vmath_ulp(y1[i], r));
+        e2 = std::max(e2, math_vmath_ulp(y2[i], r));
+    }
+
+    const double n = static_cast<double>(a.size() * 10);
+    std::cout << std::left << std::setw(20) << name;
+    std::cout << std::right << std::setw(10)
+              << (sizeof(T) == sizeof(float) ? "float" : "double");
+    std::cout << std::right << std::setw(15) << std::fixed
+              << n / watch1.nanoseconds();
+    std::cout << std::right << std::setw(15) << std::fixed
+              << n / watch2.nanoseconds();
+    std::cout << std::right << std::setw(15) << std::fixed
+              << static_cast<double>(e1);
+    std::cout << std::right << std::setw(15) << std::fixed
+              << static_cast<double>(e2);
+    std::cout << std::right << std::setw(15)
+              << (e2 < 1.5 ? "Passed" : "Failed");
+    std::cout << std::endl;
+}
+
+#define VSMC_MATH_VMATH_TEST(T, func, lb, ub, logscale)                       \
+    math_vmath_test<T>(N, #func,                                              \
+        [=](vsmc::RNG &rng) {                                                  \
+            std::uniform_real_distribution<T> runif(lb, ub);                  \
+            return logscale ? std::exp(runif(rng)) : runif(rng);              \
+        },                                                                    \
+        [](long double x) { return std::func(x); },                           \
+        [](std::size_t n, const T *a, T *y) { vsmc::func(n, a, y); },         \
+        [](std::size_t n, const T *a, T *y) { vsmc::func<T>(n, a, y); });
+
+#define VSMC_MATH_VMATH_SINCOS_TEST(T, func, lb, ub)                          \
+    math_vmath_test<T>(N, #func " (sincos)",                                  \
+        [=](vsmc::RNG &rng) {                                                  \
+            std::uniform_real_distribution<T> runif(lb, ub);                  \
+            return runif(rng);                                                \
+        },                                                                    \
+        [](long double x) { return std::func(x); },                           \
+        [](std::size_t n, const T *a, T *y) {                                 \
+            vsmc::Vector<T> z(n);                                             \
+            vsmc::sincos(n, a, y, z.data());                                  \
+            if (std::string(#func) == "cos")                                  \
+                std::copy(z.begin(), z.end(), y);                             \
+        },                                                                    \
+        [](std::size_t n, const T *a, T *y) {                                 \
+            vsmc::Vector<T> z(n);                                             \
+            vsmc::sincos<T>(n, a, y, z.data());                               \
+            if (std::string(#func) == "cos")                                  \
+                std::copy(z.begin(), z.end(), y);                             \
+        });
+
+template <typename T>
+inline void math_vmath(std::size_t N)
+{
+    const T lmax = std::log(std::numeric_limits<T>::max());
+    const T lmin = std::log(std::numeric_limits<T>::denorm_min());
+    const T pi = vsmc::const_pi<T>();
+
+    VSMC_MATH_VMATH_TEST(T, sqrt, lmin, lmax, true);
+    VSMC_MATH_VMATH_TEST(T, exp, lmin, lmax, false);
+    VSMC_MATH_VMATH_TEST(T, exp, -1, 1, false);
+    VSMC_MATH_VMATH_TEST(T, expm1, -40, lmax, false);
+    VSMC_MATH_VMATH_TEST(T, expm1, -1, 1, false);
+    VSMC_MATH_VMATH_TEST(T, log, lmin, lmax, true);
+    VSMC_MATH_VMATH_TEST(T, log, 0.5, 2, false);
+    VSMC_MATH_VMATH_TEST(T, log1p, -1, 1, false);
+    VSMC_MATH_VMATH_TEST(T, log1p, -40, lmax, true);
+    VSMC_MATH_VMATH_SINCOS_TEST(T, sin, -pi, pi);
+    VSMC_MATH_VMATH_SINCOS_TEST(T, sin, -1e4, 1e4);
+    VSMC_MATH_VMATH_SINCOS_TEST(T, cos, -pi, pi);
+    VSMC_MATH_VMATH_SINCOS_TEST(T, cos, -1e4, 1e4);
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t N = 1000000;
+    if (argc > 1)
+        N = static_cast<std::size_t>(std::atoi(argv[1]));
+
+    const int lwid = 20 + 10 + 15 * 5;
+    std::cout << std::string(lwid, '=') << std::endl;
+    std::cout << std::left << std::setw(20) << "Function";
+    std::cout << std::right << std::setw(10) << "Type";
+    std::cout << std::right << std::setw(15) << "N/ns (STD)";
+    std::cout << std::right << std::setw(15) << "N/ns (vSMC)";
+    std::cout << std::right << std::setw(15) << "ULP (STD)";
+    std::cout << std::right << std::setw(15) << "ULP (vSMC)";
+    std::cout << std::right << std::setw(15) << "Test";
+    std::cout << std::endl;
+    std::cout << std::string(lwid, '-') << std::endl;
+    math_vmath<float>(N);
+    std::cout << std::string(lwid, '-') << std::endl;
+    math_vmath<double>(N);
+    std::cout << std::string(lwid, '=') << std::endl;
+
+    return 0;
+}
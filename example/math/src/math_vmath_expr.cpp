@@ -0,0 +1,194 @@
+//============================================================================
+// vSMC/example/math/src/math_vmath_expr.cpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c); 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION); HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE);
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#include <vsmc/math/math.hpp>
+#include <vsmc/rng/engine.hpp>
+#include <vsmc/utility/stop_watch.hpp>
+
+template <typename T>
+inline long double math_vmath_expr_ulp(T y, long double r)
+{
+    const T a = std::abs(static_cast<T>(r));
+    const long double u =
+        std::nextafter(a, std::numeric_limits<T>::infinity()) - a;
+
+    return std::abs(static_cast<long double>(y) - r) / u;
+}
+
+template <typename T, typename Ref, typename Chain, typename Expr>
+inline void math_vmath_expr_test(std::size_t N, const std::string &name,
+    Ref &&ref, Chain &&chain, Expr &&expr)
+{
+    vsmc::RNG rng;
+    std::uniform_real_distribution<T> runif(0, 1);
+    vsmc::Vector<T> a(N);
+    vsmc::Vector<T> b(N);
+    vsmc::Vector<T> y1(N);
+    vsmc::Vector<T> y2(N);
+    for (std::size_t i = 0; i != N; ++i) {
+        a[i] = runif(rng);
+        b[i] = runif(rng);
+    }
+
+    vsmc::StopWatch watch1;
+    vsmc::StopWatch watch2;
+    for (std::size_t k = 0; k != 10; ++k) {
+        watch1.start();
+        chain(N, a.data(), b.data(), y1.data());
+        watch1.stop();
+        watch2.start();
+        expr(N, a.data(), b.data(), y2.data());
+        watch2.stop();
+    }
+
+    long double e1 = 0;
+    long double e2 = 0;
+    for (std::size_t i = 0; i != N; ++i) {
+        const long double r = ref(static_cast<long double>(a[i]),
+            static_cast<long double>(b[i]));
+        e1 = std::max(e1, math_vmath_expr_ulp(y1[i], r));
+        e2 = std::max(e2, math_vmath_expr_ulp(y2[i], r));
+    }
+
+    const double n = static_cast<double>(N * 10);
+    std::cout << std::left << std::setw(30) << name;
+    std::cout << std::right << std::setw(10)
+              << (sizeof(T) == sizeof(float) ? "float" : "double");
+    std::cout << std::right << std::setw(15) << std::fixed
+              << n / watch1.nanoseconds();
+    std::cout << std::right << std::setw(15) << std::fixed
+              << n / watch2.nanoseconds();
+    std::cout << std::right << std::setw(15) << std::fixed
+              << static_cast<double>(e1);
+    std::cout << std::right << std::setw(15) << std::fixed
+              << static_cast<double>(e2);
+    std::cout << std::right << std::setw(15)
+              << (e2 < e1 + 1 ? "Passed" : "Failed");
+    std::cout << std::endl;
+}
+
+template <typename T>
+inline void math_vmath_expr(std::size_t N)
+{
+    using vsmc::vmath::arg;
+    using vsmc::vmath::eval;
+
+    const T c = static_cast<T>(1.5);
+    const T pi2 = vsmc::const_pi_2<T>();
+
+    math_vmath_expr_test<T>(N, "sqrt(-2 * log(a))",
+        [](long double a, long double) {
+            return std::sqrt(-2 * std::log(a));
+        },
+        [](std::size_t n, const T *a, const T *, T *y) {
+            vsmc::log(n, a, y);
+            vsmc::mul(n, static_cast<T>(-2), y, y);
+            vsmc::sqrt(n, y, y);
+        },
+        [](std::size_t n, const T *a, const T *, T *y) {
+            eval(n, y, vsmc::vmath::sqrt(-2 * vsmc::vmath::log(arg(a))));
+        });
+
+    math_vmath_expr_test<T>(N, "exp(c * log(a))",
+        [=](long double a, long double) {
+            return std::exp(c * std::log(a));
+        },
+        [=](std::size_t n, const T *a, const T *, T *y) {
+            vsmc::log(n, a, y);
+            vsmc::mul(n, c, y, y);
+            vsmc::exp(n, y, y);
+        },
+        [=](std::size_t n, const T *a, const T *, T *y) {
+            eval(n, y, vsmc::vmath::exp(c * vsmc::vmath::log(arg(a))));
+        });
+
+    math_vmath_expr_test<T>(N, "log(a) + b",
+        [](long double a, long double b) { return std::log(a) + b; },
+        [](std::size_t n, const T *a, const T *b, T *y) {
+            vsmc::log(n, a, y);
+            vsmc::add(n, y, b, y);
+        },
+        [](std::size_t n, const T *a, const T *b, T *y) {
+            eval(n, y, vsmc::vmath::log(arg(a)) + arg(b));
+        });
+
+    math_vmath_expr_test<T>(N, "1 - 0.0331 * a^4",
+        [](long double a, long double) {
+            return 1 - static_cast<T>(0.0331) * a * a * a * a;
+        },
+        [](std::size_t n, const T *a, const T *, T *y) {
+            vsmc::sqr(n, a, y);
+            vsmc::sqr(n, y, y);
+            vsmc::fma(n, -static_cast<T>(0.0331), y, static_cast<T>(1), y);
+        },
+        [](std::size_t n, const T *a, const T *, T *y) {
+            eval(n, y, 1 - static_cast<T>(0.0331) *
+                    vsmc::vmath::sqr(vsmc::vmath::sqr(arg(a))));
+        });
+
+    math_vmath_expr_test<T>(N, "a * sin(2 * pi * b) + 1",
+        [=](long double a, long double b) {
+            return a * std::sin(pi2 * b) + 1;
+        },
+        [=](std::size_t n, const T *a, const T *b, T *y) {
+            vsmc::mul(n, pi2, b, y);
+            vsmc::sin(n, y, y);
+            vsmc::fma(n, a, y, static_cast<T>(1), y);
+        },
+        [=](std::size_t n, const T *a, const T *b, T *y) {
+            eval(n, y, arg(a) * vsmc::vmath::sin(pi2 * arg(b)) + 1);
+        });
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t N = 1000000;
+    if (argc > 1)
+        N = static_cast<std::size_t>(std::atoi(argv[1]));
+
+    const int lwid = 30 + 10 + 15 * 5;
+    std::cout << std::string(lwid, '=') << std::endl;
+    std::cout << std::left << std::setw(30) << "Expression";
+    std::cout << std::right << std::setw(10) << "Type";
+    std::cout << std::right << std::setw(15) << "N/ns (Chain)";
+    std::cout << std::right << std::setw(15) << "N/ns (Expr)";
+    std::cout << std::right << std::setw(15) << "ULP (Chain)";
+    std::cout << std::right << std::setw(15) << "ULP (Expr)";
+    std::cout << std::right << std::setw(15) << "Test";
+    std::cout << std::endl;
+    std::cout << std::string(lwid, '-') << std::endl;
+    math_vmath_expr<float>(N);
+    std::cout << std::string(lwid, '-') << std::endl;
+    math_vmath_expr<double>(N);
+    std::cout << std::string(lwid, '=') << std::endl;
+
+    return 0;
+}
@@ -138,13 +138,11 @@ class pf_init : public InitializeSMP<pf_state<Layout>, pf_init<Layout>>
 
     void eval_post(vsmc::Particle<pf_state<Layout>> &particle)
     {
-        w_.resize(particle.size());
-        particle.value().read_state(LogL, w_.data());
-        particle.weight().set_log(w_.data());
+        double *const w =
+            particle.arena().template allocate<double>(particle.size());
+        particle.value().read_state(LogL, w);
+        particle.weight().set_log(w);
     }
-
-    private:
-    vsmc::Vector<double> w_;
 };
 
 template <vsmc::MatrixLayout Layout>
@@ -171,13 +169,11 @@ class pf_move : public MoveSMP<pf_state<Layout>, pf_move<Layout>>
 
     void eval_post(std::size_t, vsmc::Particle<pf_state<Layout>> &particle)
     {
-        w_.resize(particle.size());
-        particle.value().read_state(LogL, w_.data());
-        particle.weight().add_log(w_.data());
+        double *const w =
+            particle.arena().template allocate<double>(particle.size());
+        particle.value().read_state(LogL, w);
+        particle.weight().add_log(w);
     }
-
-    private:
-    vsmc::Vector<double> w_;
 };
 
 template <vsmc::MatrixLayout Layout>
@@ -194,7 +190,8 @@ class pf_meval : public MonitorEvalSMP<pf_state<Layout>, pf_meval<Layout>>
 
 template <vsmc::MatrixLayout Layout>
 inline void pf_run(vsmc::ResampleScheme scheme, const std::string &datafile,
-    const std::string &prog, const std::string &name)
+    const std::string &prog, const std::string &name, std::size_t padding = 1,
+    bool double_buffer = false)
 {
     std::size_t N = ParticleNum;
     std::string pf_txt(prog + name + ".txt");
@@ -202,6 +199,8 @@ inline void pf_run(vsmc::ResampleScheme scheme, const std::string &datafile,
 
     vsmc::Seed::instance().set(101);
     vsmc::Sampler<pf_state<Layout>> sampler(N, scheme, 0.5);
+    sampler.particle().value().padding(padding);
+    sampler.particle().value().double_buffer(double_buffer);
     sampler.init(pf_init<Layout>());
     sampler.move(pf_move<Layout>(), false);
     sampler.monitor("pos", 2, pf_meval<Layout>());
@@ -238,6 +237,16 @@ inline void pf_run(vsmc::ResampleScheme scheme, char **argv)
     }
     pf_run<vsmc::RowMajor>(scheme, argv[1], argv[2], "." + resname + ".row");
     pf_run<vsmc::ColMajor>(scheme, argv[1], argv[2], "." + resname + ".col");
+    pf_run<vsmc::RowMajor>(
+        scheme, argv[1], argv[2], "." + resname + ".row.pad", 8);
+    pf_run<vsmc::ColMajor>(
+        scheme, argv[1], argv[2], "." + resname + ".col.pad", 0);
+    pf_run<vsmc::RowMajor>(
+        scheme, argv[1], argv[2], "." + resname + ".row.buf", 1, true);
+    pf_run<vsmc::ColMajor>(
+        scheme, argv[1], argv[2], "." + resname + ".col.buf", 1, true);
+    pf_run<vsmc::RowMajor>(
+        scheme, argv[1], argv[2], "." + resname + ".row.pad.buf", 8, true);
 }
 
 inline int pf_main(int argc, char **argv)
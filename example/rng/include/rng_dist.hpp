@@ -143,6 +143,14 @@ inline vsmc::Vector<RealType> rng_dist_partition(
         n, [&](RealType p) { return -std::log(1 - p) / dist.lambda(); });
 }
 
+template <typename RealType>
+inline vsmc::Vector<RealType> rng_dist_partition(
+    std::size_t n, vsmc::ExponentialZigguratDistribution<RealType> &dist)
+{
+    return rng_dist_partition_quantile<RealType>(
+        n, [&](RealType p) { return -std::log(1 - p) / dist.lambda(); });
+}
+
 template <typename RealType>
 inline vsmc::Vector<RealType> rng_dist_partition(
     std::size_t n, vsmc::ExtremeValueDistribution<RealType> &dist)
@@ -216,6 +224,15 @@ inline vsmc::Vector<RealType> rng_dist_partition(
                dist.mean(), dist.stddev()));
 }
 
+template <typename RealType>
+inline vsmc::Vector<RealType> rng_dist_partition(
+    std::size_t n, vsmc::NormalZigguratDistribution<RealType> &dist)
+{
+    return rng_dist_partition_boost<RealType>(
+        n, boost::math::normal_distribution<RealType>(
+               dist.mean(), dist.stddev()));
+}
+
 template <typename RealType>
 inline vsmc::Vector<RealType> rng_dist_partition(
     std::size_t n, vsmc::ParetoDistribution<RealType> &dist)
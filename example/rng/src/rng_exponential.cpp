@@ -30,6 +30,7 @@
 //============================================================================
 
 #include <vsmc/rng/exponential_distribution.hpp>
+#include <vsmc/rng/exponential_ziggurat_distribution.hpp>
 #include "rng_dist.hpp"
 
 int main(int argc, char **argv)
@@ -37,6 +38,8 @@ int main(int argc, char **argv)
     vsmc::Vector<std::array<double, 1>> params;
     params.push_back({{1.0}});
     VSMC_RNG_DIST_TEST(1, Exponential, std::exponential_distribution);
+    VSMC_RNG_DIST_TEST(
+        1, ExponentialZiggurat, std::exponential_distribution);
 
     return 0;
 }
@@ -0,0 +1,156 @@
+//============================================================================
+// vSMC/example/rng/src/rng_fused.cpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c) 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#include <vsmc/rng/distribution.hpp>
+#include <vsmc/rng/engine.hpp>
+#include <vsmc/utility/stop_watch.hpp>
+
+// Hide the CounterEngine type such that distributions take the generic
+// multi-pass path, generating random integers into an intermediate buffer
+// first and transforming them afterwards
+template <typename RNGType>
+class rng_fused_buffered
+{
+    public:
+    using result_type = typename RNGType::result_type;
+
+    result_type operator()() { return rng_(); }
+
+    void operator()(std::size_t n, result_type *r) { rng_(n, r); }
+
+    static constexpr result_type min() { return RNGType::min(); }
+
+    static constexpr result_type max() { return RNGType::max(); }
+
+    private:
+    RNGType rng_;
+}; // class rng_fused_buffered
+
+template <typename RNGType>
+inline void rng_rand(rng_fused_buffered<RNGType> &rng, std::size_t n,
+    typename RNGType::result_type *r)
+{
+    rng(n, r);
+}
+
+template <typename RealType, typename DistType, typename RNGType>
+inline void rng_fused_test(std::size_t n, const std::string &name,
+    const std::string &rng_name, DistType &dist)
+{
+    RNGType rng_fused;
+    rng_fused_buffered<RNGType> rng_buffered;
+    vsmc::Vector<RealType> r1(n);
+    vsmc::Vector<RealType> r2(n);
+    vsmc::StopWatch watch1;
+    vsmc::StopWatch watch2;
+    bool passed = true;
+    for (std::size_t i = 0; i != 10; ++i) {
+        watch1.start();
+        vsmc::rng_rand(rng_buffered, dist, n, r1.data());
+        watch1.stop();
+
+        watch2.start();
+        vsmc::rng_rand(rng_fused, dist, n, r2.data());
+        watch2.stop();
+
+        for (std::size_t j = 0; j != n; ++j)
+            if (!vsmc::internal::is_equal(r1[j], r2[j]))
+                passed = false;
+    }
+
+    const int nwid = 20;
+    const int twid = 15;
+    double n1 = 10 * n / watch1.nanoseconds();
+    double n2 = 10 * n / watch2.nanoseconds();
+    std::cout << std::left << std::setw(nwid) << name;
+    std::cout << std::left << std::setw(nwid) << rng_name;
+    std::cout << std::right << std::setw(twid) << std::fixed << n1;
+    std::cout << std::right << std::setw(twid) << std::fixed << n2;
+    std::cout << std::right << std::setw(twid) << n2 / n1;
+    std::cout << std::right << std::setw(twid)
+              << (passed ? "Passed" : "Failed");
+    std::cout << std::endl;
+}
+
+template <typename RealType, typename DistType>
+inline void rng_fused_test(
+    std::size_t n, const std::string &name, DistType &&dist)
+{
+    rng_fused_test<RealType, DistType, vsmc::Philox4x32>(
+        n, name, "Philox4x32", dist);
+    rng_fused_test<RealType, DistType, vsmc::Threefry4x64>(
+        n, name, "Threefry4x64", dist);
+#if VSMC_HAS_AES_NI
+    rng_fused_test<RealType, DistType, vsmc::ARS>(n, name, "ARS", dist);
+#endif
+}
+
+template <typename RealType>
+inline void rng_fused(std::size_t n, const std::string &precision)
+{
+    const int nwid = 20;
+    const int twid = 15;
+    const std::size_t lwid = nwid * 2 + twid * 4;
+
+    std::cout << std::string(lwid, '=') << std::endl;
+    std::cout << std::left << std::setw(nwid) << precision;
+    std::cout << std::left << std::setw(nwid) << "RNG";
+    std::cout << std::right << std::setw(twid) << "N/ns (Buffer)";
+    std::cout << std::right << std::setw(twid) << "N/ns (Fused)";
+    std::cout << std::right << std::setw(twid) << "Speedup";
+    std::cout << std::right << std::setw(twid) << "Test";
+    std::cout << std::endl;
+    std::cout << std::string(lwid, '-') << std::endl;
+
+    rng_fused_test<RealType>(n, "U01", vsmc::U01Distribution<RealType>());
+    rng_fused_test<RealType>(
+        n, "Normal(0,1)", vsmc::NormalDistribution<RealType>(0, 1));
+    rng_fused_test<RealType>(
+        n, "Exponential(1)", vsmc::ExponentialDistribution<RealType>(1));
+    rng_fused_test<RealType>(
+        n, "Gamma(0.5,1)", vsmc::GammaDistribution<RealType>(0.5, 1));
+    rng_fused_test<RealType>(
+        n, "Gamma(5,1)", vsmc::GammaDistribution<RealType>(5, 1));
+
+    std::cout << std::string(lwid, '=') << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t N = 1000000;
+    if (argc > 1)
+        N = static_cast<std::size_t>(std::atoi(argv[1]));
+
+    rng_fused<float>(N, "float");
+    rng_fused<double>(N, "double");
+
+    return 0;
+}
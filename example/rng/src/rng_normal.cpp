@@ -30,6 +30,7 @@
 //============================================================================
 
 #include <vsmc/rng/normal_distribution.hpp>
+#include <vsmc/rng/normal_ziggurat_distribution.hpp>
 #include "rng_dist.hpp"
 
 int main(int argc, char **argv)
@@ -37,6 +38,7 @@ int main(int argc, char **argv)
     vsmc::Vector<std::array<double, 2>> params;
     params.push_back({{0.0, 1.0}});
     VSMC_RNG_DIST_TEST(2, Normal, std::normal_distribution);
+    VSMC_RNG_DIST_TEST(2, NormalZiggurat, std::normal_distribution);
 
     return 0;
 }
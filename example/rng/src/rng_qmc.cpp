@@ -0,0 +1,257 @@
+//============================================================================
+// vSMC/example/rng/src/rng_qmc.cpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c); 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION); HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE);
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#include <vsmc/core/state_matrix.hpp>
+#include <vsmc/resample/sqmc.hpp>
+#include <vsmc/rng/engine.hpp>
+#include <vsmc/rng/halton.hpp>
+#include <vsmc/rng/sobol.hpp>
+
+inline bool rng_qmc_check(const std::string &name, bool passed)
+{
+    std::cout << std::left << std::setw(50) << name;
+    std::cout << std::right << std::setw(10) << (passed ? "Passed" : "Failed");
+    std::cout << std::endl;
+
+    return passed;
+}
+
+// The points 1 to 7 of the first three dimensions of Joe and Kuo (2008)
+inline bool rng_qmc_sobol_joe_kuo()
+{
+    const double x[7][3] = {{0.5, 0.5, 0.5}, {0.75, 0.25, 0.25},
+        {0.25, 0.75, 0.75}, {0.375, 0.375, 0.625}, {0.875, 0.875, 0.125},
+        {0.625, 0.125, 0.875}, {0.125, 0.625, 0.375}};
+
+    vsmc::SobolSequence<double> sobol(3);
+    double r[3];
+    sobol(r);
+    bool passed = true;
+    for (std::size_t i = 0; i != 7; ++i) {
+        sobol(r);
+        for (std::size_t d = 0; d != 3; ++d)
+            passed = passed && std::abs(r[d] - x[i][d]) < 1e-9;
+    }
+
+    return rng_qmc_check("Sobol: Joe-Kuo points", passed);
+}
+
+// The first 2^m points of the first two dimensions form a (0, m, 2)-net,
+// that is, each elementary interval of volume 2^{-m} has exactly one point
+template <typename QMCType>
+inline bool rng_qmc_sobol_net(QMCType &sobol, std::size_t m)
+{
+    const std::size_t n = static_cast<std::size_t>(1) << m;
+    vsmc::Vector<double> r(n * 2);
+    sobol.seek(0);
+    sobol(n, r.data());
+    vsmc::Vector<std::size_t> count(n);
+    for (std::size_t a = 0; a <= m; ++a) {
+        const double ka = static_cast<double>(static_cast<std::size_t>(1) << a);
+        const double kb =
+            static_cast<double>(static_cast<std::size_t>(1) << (m - a));
+        std::fill(count.begin(), count.end(), 0);
+        for (std::size_t i = 0; i != n; ++i) {
+            const std::size_t u = static_cast<std::size_t>(r[i * 2] * ka);
+            const std::size_t v = static_cast<std::size_t>(r[i * 2 + 1] * kb);
+            ++count[u * static_cast<std::size_t>(kb) + v];
+        }
+        for (std::size_t k = 0; k != n; ++k)
+            if (count[k] != 1)
+                return false;
+    }
+
+    return true;
+}
+
+inline bool rng_qmc_sobol_net()
+{
+    vsmc::RNG rng;
+    vsmc::SobolSequence<double> sobol(2);
+    bool passed = true;
+    for (std::size_t m = 1; m != 13; ++m)
+        passed = passed && rng_qmc_sobol_net(sobol, m);
+    bool scrambled = true;
+    for (std::size_t m = 1; m != 13; ++m) {
+        sobol.scramble(rng);
+        scrambled = scrambled && rng_qmc_sobol_net(sobol, m);
+    }
+
+    passed = rng_qmc_check("Sobol: (0, m, 2)-net", passed) && passed;
+    passed = rng_qmc_check("Sobol: (0, m, 2)-net, scrambled", scrambled) &&
+        passed;
+
+    return passed;
+}
+
+// The radical inverses of 1 to 8 in bases 2 and 3
+inline bool rng_qmc_halton_radical_inverse()
+{
+    const double x[8][2] = {{1.0 / 2, 1.0 / 3}, {1.0 / 4, 2.0 / 3},
+        {3.0 / 4, 1.0 / 9}, {1.0 / 8, 4.0 / 9}, {5.0 / 8, 7.0 / 9},
+        {3.0 / 8, 2.0 / 9}, {7.0 / 8, 5.0 / 9}, {1.0 / 16, 8.0 / 9}};
+
+    vsmc::HaltonSequence<double> halton(2);
+    double r[2];
+    bool passed = true;
+    for (std::size_t i = 0; i != 8; ++i) {
+        halton(r);
+        for (std::size_t d = 0; d != 2; ++d)
+            passed = passed && std::abs(r[d] - x[i][d]) < 1e-15;
+    }
+
+    return rng_qmc_check("Halton: radical inverses", passed);
+}
+
+// seek(n) gives the same point as generating n points first
+template <typename QMCType>
+inline bool rng_qmc_seek(const std::string &name)
+{
+    using result_type = typename QMCType::result_type;
+
+    const std::size_t dim = 5;
+    const std::size_t n = 1000;
+    vsmc::RNG rng;
+    QMCType qmc(dim);
+    vsmc::Vector<result_type> r1(n * dim);
+    vsmc::Vector<result_type> r2(dim);
+    bool passed = true;
+    for (std::size_t k = 0; k != 2; ++k) {
+        if (k != 0)
+            qmc.scramble(rng);
+        qmc.seek(0);
+        qmc(n, r1.data());
+        for (std::size_t i = 0; i < n; i += 37) {
+            qmc.seek(i);
+            qmc(r2.data());
+            passed = passed &&
+                std::equal(r2.begin(), r2.end(), r1.begin() + i * dim);
+        }
+        qmc.seek(0);
+        qmc.discard(n - 1);
+        qmc(r2.data());
+        passed = passed &&
+            std::equal(r2.begin(), r2.end(), r1.begin() + (n - 1) * dim);
+    }
+
+    return rng_qmc_check(name + ": seek", passed);
+}
+
+// Scrambled points lie strictly within (0, 1)
+template <typename QMCType>
+inline bool rng_qmc_open(const std::string &name, std::size_t n)
+{
+    using result_type = typename QMCType::result_type;
+
+    const std::size_t dim = 8;
+    vsmc::RNG rng;
+    QMCType qmc(dim);
+    qmc.scramble(rng);
+    vsmc::Vector<result_type> r(dim);
+    bool passed = true;
+    for (std::size_t i = 0; i != n; ++i) {
+        qmc(r.data());
+        for (std::size_t d = 0; d != dim; ++d)
+            passed = passed && r[d] > 0 && r[d] < 1;
+    }
+    qmc.seek((static_cast<std::uint64_t>(1) << 25) - 2);
+    for (std::size_t i = 0; i != 4; ++i) {
+        qmc(r.data());
+        for (std::size_t d = 0; d != dim; ++d)
+            passed = passed && r[d] > 0 && r[d] < 1;
+    }
+
+    return rng_qmc_check(name + ": scrambled points in (0, 1)", passed);
+}
+
+// The replication numbers of SQMC resampling sum to N
+template <typename QMCType>
+inline bool rng_qmc_sqmc(const std::string &name, std::size_t M)
+{
+    vsmc::RNG rng;
+    std::uniform_real_distribution<double> runif(0, 1);
+    vsmc::StateMatrix<vsmc::RowMajor, 2, double> state(M);
+    for (std::size_t i = 0; i != M; ++i) {
+        state.state(i, 0) = runif(rng);
+        state.state(i, 1) = runif(rng);
+    }
+    vsmc::Vector<double> weight(M);
+    double sum = 0;
+    for (std::size_t i = 0; i != M; ++i)
+        sum += weight[i] = runif(rng);
+    for (std::size_t i = 0; i != M; ++i)
+        weight[i] /= sum;
+
+    vsmc::ResampleSQMC<QMCType> sqmc(state);
+    vsmc::Vector<std::size_t> rep(M);
+    bool passed = true;
+    for (std::size_t N : {M, M / 2 + 1, M * 2}) {
+        sqmc(M, N, rng, weight.data(), rep.data());
+        passed = passed &&
+            std::accumulate(rep.begin(), rep.end(),
+                static_cast<std::size_t>(0)) == N;
+        vsmc::Vector<std::size_t> order(sqmc.order(), sqmc.order() + N);
+        std::sort(order.begin(), order.end());
+        for (std::size_t k = 0; k != N; ++k)
+            passed = passed && order[k] == k;
+    }
+
+    return rng_qmc_check(name + ": SQMC replications", passed);
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t N = 100000;
+    if (argc > 1)
+        N = static_cast<std::size_t>(std::atoi(argv[1]));
+
+    bool passed = true;
+    passed = rng_qmc_sobol_joe_kuo() && passed;
+    passed = rng_qmc_sobol_net() && passed;
+    passed = rng_qmc_halton_radical_inverse() && passed;
+    passed = rng_qmc_seek<vsmc::SobolSequence<double>>("Sobol") && passed;
+    passed = rng_qmc_seek<vsmc::HaltonSequence<double>>("Halton") && passed;
+    passed = rng_qmc_open<vsmc::SobolSequence<float>>("Sobol<float>", N) &&
+        passed;
+    passed = rng_qmc_open<vsmc::SobolSequence<double>>("Sobol<double>", N) &&
+        passed;
+    passed = rng_qmc_open<vsmc::HaltonSequence<float>>("Halton<float>", N) &&
+        passed;
+    passed =
+        rng_qmc_open<vsmc::HaltonSequence<double>>("Halton<double>", N) &&
+        passed;
+    passed = rng_qmc_sqmc<vsmc::SobolSequence<double>>("Sobol", 1000) &&
+        passed;
+    passed = rng_qmc_sqmc<vsmc::HaltonSequence<double>>("Halton", 1000) &&
+        passed;
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -35,9 +35,14 @@
 #include <vsmc/internal/config.h>
 #include <vsmc/core/monitor.hpp>
 #include <vsmc/core/particle.hpp>
+#include <vsmc/core/random_walk_batch.hpp>
 #include <vsmc/core/sampler.hpp>
 #include <vsmc/core/single_particle.hpp>
+#include <vsmc/core/state_cow.hpp>
 #include <vsmc/core/state_matrix.hpp>
+#include <vsmc/core/state_ragged.hpp>
+#include <vsmc/core/state_tuple.hpp>
+#include <vsmc/core/tempering.hpp>
 #include <vsmc/core/weight.hpp>
 
 #endif // VSMC_CORE_CORE_HPP
@@ -33,6 +33,8 @@
 #define VSMC_CORE_MONITOR_HPP
 
 #include <vsmc/internal/common.hpp>
+#include <vsmc/core/weight.hpp>
+#include <vsmc/utility/scratch_arena.hpp>
 
 #define VSMC_RUNTIME_ASSERT_CORE_MONITOR_ID(func)                             \
     VSMC_RUNTIME_ASSERT(                                                      \
@@ -59,13 +61,22 @@ enum MonitorStage {
 
 /// \brief Monitor for Monte Carlo integration
 /// \ingroup Core
+///
+/// \details
+/// The evaluation object computes the values of each particle in
+/// `result_type`, the same type as the weights of Particle<T>, such that a
+/// single precision particle system evaluates and integrates single
+/// precision values. The integrations are accumulated and recorded in
+/// double precision. The values and the integrations of each evaluation are
+/// temporaries allocated from the scratch arena of the particle system.
 template <typename T>
 class Monitor
 {
     public:
     using value_type = T;
-    using eval_type =
-        std::function<void(std::size_t, std::size_t, Particle<T> &, double *)>;
+    using result_type = WeightValueType<WeightType<T>>;
+    using eval_type = std::function<void(
+        std::size_t, std::size_t, Particle<T> &, result_type *)>;
 
     Monitor(std::size_t dim, const eval_type &eval, bool record_only = false,
         MonitorStage stage = MonitorMCMC)
@@ -249,22 +260,24 @@ class Monitor
 
         VSMC_RUNTIME_ASSERT_CORE_MONITOR_EVAL;
 
-        result_.resize(dim_);
+        ScratchArenaGuard guard(particle.arena());
+        double *const result = particle.arena().template allocate<double>(dim_);
         if (record_only_) {
-            eval_(iter, dim_, particle, result_.data());
-            push_back(iter);
+            result_type *const buffer =
+                particle.arena().template allocate<result_type>(dim_);
+            eval_(iter, dim_, particle, buffer);
+            std::copy_n(buffer, dim_, result);
+            push_back(iter, result);
 
             return;
         }
 
         const std::size_t N = static_cast<std::size_t>(particle.size());
-        buffer_.resize(N * dim_);
-        eval_(iter, dim_, particle, buffer_.data());
-        ::cblas_dgemv(::CblasColMajor, ::CblasNoTrans,
-            static_cast<VSMC_CBLAS_INT>(dim_), static_cast<VSMC_CBLAS_INT>(N),
-            1.0, buffer_.data(), static_cast<VSMC_CBLAS_INT>(dim_),
-            particle.weight().data(), 1, 0.0, result_.data(), 1);
-        push_back(iter);
+        result_type *const buffer =
+            particle.arena().template allocate<result_type>(N * dim_);
+        eval_(iter, dim_, particle, buffer);
+        integrate(N, buffer, particle.weight().data(), result);
+        push_back(iter, result);
     }
 
     /// \brief Clear all records of the index and integrations
@@ -292,13 +305,31 @@ class Monitor
     Vector<std::string> name_;
     Vector<std::size_t> index_;
     Vector<double> record_;
-    Vector<double> result_;
-    Vector<double> buffer_;
 
-    void push_back(std::size_t iter)
+    void integrate(
+        std::size_t N, const float *buffer, const float *w, double *result)
+    {
+        std::fill_n(result, dim_, 0.0);
+        for (std::size_t i = 0; i != N; ++i, buffer += dim_) {
+            const double wi = w[i];
+            for (std::size_t d = 0; d != dim_; ++d)
+                result[d] += wi * buffer[d];
+        }
+    }
+
+    void integrate(
+        std::size_t N, const double *buffer, const double *w, double *result)
+    {
+        ::cblas_dgemv(::CblasColMajor, ::CblasNoTrans,
+            static_cast<VSMC_CBLAS_INT>(dim_), static_cast<VSMC_CBLAS_INT>(N),
+            1.0, buffer, static_cast<VSMC_CBLAS_INT>(dim_), w, 1, 0.0, result,
+            1);
+    }
+
+    void push_back(std::size_t iter, const double *result)
     {
         index_.push_back(iter);
-        record_.insert(record_.end(), result_.begin(), result_.end());
+        record_.insert(record_.end(), result, result + dim_);
     }
 }; // class Monitor
 
@@ -38,10 +38,51 @@
 #include <vsmc/resample/resample.hpp>
 #include <vsmc/rng/rng_set.hpp>
 #include <vsmc/rng/seed.hpp>
+#include <vsmc/utility/scratch_arena.hpp>
 
 namespace vsmc
 {
 
+namespace internal
+{
+
+template <typename... Types>
+class ParticleTouchArgs
+{
+}; // class ParticleTouchArgs
+
+// The types of the trailing arguments after `N` with which T is constructed,
+// FirstTouch if T(N, touch) is supported, and none otherwise
+template <typename T, typename SizeType>
+using ParticleTouchArgsType =
+    typename std::conditional<std::is_constructible<T, SizeType,
+                                  FirstTouch>::value,
+        ParticleTouchArgs<FirstTouch>, ParticleTouchArgs<>>::type;
+
+template <typename T>
+class is_state_resize_impl
+{
+    template <typename U>
+    static std::true_type test(decltype(std::declval<U &>().resize(
+        std::declval<SizeType<U>>())) *);
+
+    template <typename U>
+    static std::false_type test(...);
+
+    public:
+    static constexpr bool value = decltype(test<T>(nullptr))::value;
+}; // class is_state_resize_impl
+
+// Whether the number of particles of a state can be changed, as StateMatrix
+// does
+template <typename T>
+class is_state_resize
+    : public std::integral_constant<bool, is_state_resize_impl<T>::value>
+{
+}; // class is_state_resize
+
+} // namespace vsmc::internal
+
 /// \brief Particle class representing the whole particle set
 /// \ingroup Core
 template <typename T>
@@ -53,17 +94,28 @@ class Particle
     using weight_type = WeightType<T>;
     using rng_set_type = RNGSetType<T>;
     using rng_type = typename rng_set_type::rng_type;
-    using resample_type = std::function<void(
-        std::size_t, std::size_t, rng_type &, const double *, size_type *)>;
+    using weight_value_type = WeightValueType<weight_type>;
+    using resample_type = std::function<void(std::size_t, std::size_t,
+        rng_type &, const weight_value_type *, size_type *)>;
     using sp_type = SingleParticle<T>;
 
-    explicit Particle(size_type N)
-        : size_(N)
-        , value_(N)
-        , weight_(static_cast<SizeType<weight_type>>(N))
-        , rng_set_(static_cast<SizeType<rng_set_type>>(N))
+    /// \brief Construct a particle system of `N` particles
+    ///
+    /// \param N The number of particles
+    /// \param touch The first touch policy of the state, the weights and the
+    /// RNG set. With FirstTouchTBB or FirstTouchOMP, those that can be
+    /// constructed by `(N, touch)`, e.g., StateMatrix, Weight and RNGSetVector,
+    /// are initialized in parallel, each range of particles by a thread as
+    /// the backend of the same name would partition a move. On NUMA systems,
+    /// their memory is then placed near the threads processing them.
+    explicit Particle(size_type N, FirstTouch touch = FirstTouchSEQ)
+        : Particle(N, touch,
+              internal::ParticleTouchArgsType<value_type, size_type>(),
+              internal::ParticleTouchArgsType<weight_type,
+                  SizeType<weight_type>>(),
+              internal::ParticleTouchArgsType<rng_set_type,
+                  SizeType<rng_set_type>>())
     {
-        Seed::instance().seed_rng(rng_);
     }
 
     /// \brief Clone the particle system except the RNG engines
@@ -121,6 +173,30 @@ class Particle
     /// \brief Number of particles
     size_type size() const { return size_; }
 
+    /// \brief Change the number of particles
+    ///
+    /// \details
+    /// The state, the weights and the RNG set are resized, retaining the
+    /// first `min(N, size())` particles, with capacities growing
+    /// geometrically, see StateMatrix::resize and WeightVector::resize. The
+    /// new particles carry zero weight, and thus are never selected by a
+    /// subsequent resampling, unless all the retained weights are zero, in
+    /// which case all the weights become equal. The state type shall have a
+    /// member function `resize(N)`, or otherwise it is a compile time error
+    /// to call this function. To change the number of
+    /// particles of a weighted system, resample it into `N` particles
+    /// instead, see `resample(op, threshold, N)`.
+    void resize(size_type N)
+    {
+        if (N == size_)
+            return;
+
+        resize_value(N);
+        weight_.resize(static_cast<SizeType<weight_type>>(N));
+        rng_set_.resize(static_cast<SizeType<rng_set_type>>(N));
+        size_ = N;
+    }
+
     /// \brief Read and write access to the value collection object
     value_type &value() { return value_; }
 
@@ -151,6 +227,18 @@ class Particle
     /// \brief Get the (sequential) RNG used stream for resampling
     const rng_type &rng() const { return rng_; }
 
+    /// \brief Read and write access to the scratch arena
+    ///
+    /// \details
+    /// The arena is reset by Sampler at the beginning of each iteration,
+    /// including the initialization. Temporaries of the moves, MCMC moves
+    /// and monitors, such as the logarithm incremental weights computed in
+    /// `eval_post`, can be allocated from it instead of held by each of them.
+    ScratchArena &arena() { return arena_; }
+
+    /// \brief Read only access to the scratch arena
+    const ScratchArena &arena() const { return arena_; }
+
     /// \brief Get a SingleParticle<T> object
     sp_type sp(size_type id) { return SingleParticle<T>(id, this); }
 
@@ -172,21 +260,14 @@ class Particle
         std::size_t N = static_cast<std::size_t>(weight_.resample_size());
         bool resampled = weight_.ess() < threshold * N;
         if (resampled) {
-            const double *const rwptr = weight_.resample_data();
+            const weight_value_type *const rwptr = weight_.resample_data();
             if (rwptr != nullptr) {
-#if VSMC_USE_TBB
-                Vector<size_type> &rep = rep_.local();
-                Vector<size_type> &idx = idx_.local();
-                rep.resize(N);
-                idx.resize(N);
-#else  // VSMC_USE_TBB
-                Vector<size_type> rep(N);
-                Vector<size_type> idx(N);
-#endif // VSMC_USE_TBB
-
-                op(N, N, rng_, rwptr, rep.data());
-                resample_trans_rep_index(N, N, rep.data(), idx.data());
-                value_.copy(N, idx.data());
+                ScratchArenaGuard guard(arena_);
+                size_type *const rep = arena_.allocate<size_type>(N);
+                size_type *const idx = arena_.allocate<size_type>(N);
+                op(N, N, rng_, rwptr, rep);
+                resample_trans_rep_index(N, N, rep, idx);
+                value_.copy(N, idx);
             } else {
                 value_.copy(N, static_cast<const size_type *>(nullptr));
             }
@@ -196,16 +277,85 @@ class Particle
         return resampled;
     }
 
+    /// \brief Resample into `N` particles
+    ///
+    /// \details
+    /// If `N` is the current size, it is the same as `resample(op,
+    /// threshold)`. Otherwise the resampling is always performed, drawing `N`
+    /// children from the current particles with `op(M, N, ...)`, and the
+    /// system is resized to `N` particles, see `resize`. The children are
+    /// copied in place, see resample_trans_rep_index_inplace, after the
+    /// state grows or before it shrinks. As for `resize`, the state type shall
+    /// have a member function `resize(N)`. If either the current or the new
+    /// system is empty, there is nothing to draw, and the system is only
+    /// resized and given equal weights.
+    ///
+    /// \return true if resampling was performed
+    bool resample(const resample_type &op, double threshold, size_type N)
+    {
+        if (N == size_)
+            return resample(op, threshold);
+
+        const weight_value_type *const rwptr = weight_.resample_data();
+        const std::size_t M = static_cast<std::size_t>(weight_.resample_size());
+        if (rwptr == nullptr || M == 0 || N == 0) {
+            resize(N);
+            weight_.set_equal();
+            return true;
+        }
+
+        const std::size_t K = std::max(M, static_cast<std::size_t>(N));
+        ScratchArenaGuard guard(arena_);
+        size_type *const rep = arena_.allocate<size_type>(M);
+        size_type *const idx = arena_.allocate<size_type>(K);
+        op(M, static_cast<std::size_t>(N), rng_, rwptr, rep);
+        resample_trans_rep_index_inplace(
+            M, static_cast<std::size_t>(N), rep, idx);
+        if (N > size_) {
+            resize_value(N);
+            value_.copy(N, idx);
+        } else {
+            value_.copy(size_, idx);
+            resize_value(N);
+        }
+        weight_.resize(static_cast<SizeType<weight_type>>(N));
+        rng_set_.resize(static_cast<SizeType<rng_set_type>>(N));
+        size_ = N;
+        weight_.set_equal();
+
+        return true;
+    }
+
     private:
+    // Construct each of the state, the weights and the RNG set in place, with
+    // `(N, touch)` if it is supported, and `(N)` otherwise
+    template <typename... VT, typename... WT, typename... RT>
+    Particle(size_type N, FirstTouch touch, internal::ParticleTouchArgs<VT...>,
+        internal::ParticleTouchArgs<WT...>, internal::ParticleTouchArgs<RT...>)
+        : size_(N)
+        , value_(N, static_cast<VT>(touch)...)
+        , weight_(static_cast<SizeType<weight_type>>(N),
+              static_cast<WT>(touch)...)
+        , rng_set_(static_cast<SizeType<rng_set_type>>(N),
+              static_cast<RT>(touch)...)
+    {
+        Seed::instance().seed_rng(rng_);
+    }
+
     size_type size_;
     value_type value_;
     weight_type weight_;
     rng_set_type rng_set_;
     rng_type rng_;
-#if VSMC_USE_TBB
-    ::tbb::combinable<Vector<size_type>> rep_;
-    ::tbb::combinable<Vector<size_type>> idx_;
-#endif
+    ScratchArena arena_;
+
+    void resize_value(size_type N)
+    {
+        static_assert(internal::is_state_resize<value_type>::value,
+            "**Particle::resize** USED WITH A STATE WITHOUT resize(N)");
+
+        value_.resize(N);
+    }
 }; // class Particle
 
 } // namespace vsmc
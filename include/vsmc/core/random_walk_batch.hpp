@@ -0,0 +1,77 @@
+//============================================================================
+// vSMC/include/vsmc/core/random_walk_batch.hpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c) 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#ifndef VSMC_CORE_RANDOM_WALK_BATCH_HPP
+#define VSMC_CORE_RANDOM_WALK_BATCH_HPP
+
+#include <vsmc/internal/common.hpp>
+#include <vsmc/core/state_matrix.hpp>
+#include <vsmc/rng/random_walk.hpp>
+
+namespace vsmc
+{
+
+/// \brief One-step RandomWalkBatch update of all particles in a column major
+/// StateMatrix
+/// \ingroup RandomWalk
+///
+/// \details
+/// Equivalent to `rw(rng, s.size(), s.stride(), s.data(), ltx, log_target,
+/// proposal)`
+template <typename RealType, std::size_t Dim, std::size_t D, typename RNGType,
+    typename LogTargetType, typename ProposalType>
+inline std::size_t random_walk_batch(RandomWalkBatch<RealType, Dim> &rw,
+    RNGType &rng, StateMatrix<ColMajor, D, RealType> &s, RealType *ltx,
+    LogTargetType &&log_target, ProposalType &&proposal)
+{
+    return rw(rng, s.size(), s.stride(), s.data(), ltx,
+        std::forward<LogTargetType>(log_target),
+        std::forward<ProposalType>(proposal));
+}
+
+/// \brief One-step RandomWalkBatch update of the particles
+/// \f$[first, first + n)\f$ in a column major StateMatrix
+/// \ingroup RandomWalk
+template <typename RealType, std::size_t Dim, std::size_t D, typename RNGType,
+    typename LogTargetType, typename ProposalType>
+inline std::size_t random_walk_batch(RandomWalkBatch<RealType, Dim> &rw,
+    RNGType &rng, StateMatrix<ColMajor, D, RealType> &s, std::size_t first,
+    std::size_t n, RealType *ltx, LogTargetType &&log_target,
+    ProposalType &&proposal)
+{
+    return rw(rng, n, s.stride(), s.data() + first, ltx,
+        std::forward<LogTargetType>(log_target),
+        std::forward<ProposalType>(proposal));
+}
+
+} // namespace vsmc
+
+#endif // VSMC_CORE_RANDOM_WALK_BATCH_HPP
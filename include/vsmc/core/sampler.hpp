@@ -52,6 +52,50 @@
 namespace vsmc
 {
 
+/// \brief Size controller of Sampler by the ESS
+/// \ingroup Core
+///
+/// \details
+/// At each iteration, if the ESS is less than `lower` times the number of
+/// particles, the number is multiplied by `factor`, and if it is more than
+/// `upper` times the number, it is divided by `factor`, within `[min, max]`.
+/// For example,
+/// ~~~{.cpp}
+/// sampler.size_control(SizeControlESS(1000, 100000, 0.1, 0.9));
+/// ~~~
+class SizeControlESS
+{
+    public:
+    SizeControlESS(std::size_t min, std::size_t max, double lower,
+        double upper, double factor = 2)
+        : min_(min), max_(max), lower_(lower), upper_(upper), factor_(factor)
+    {
+    }
+
+    template <typename T>
+    SizeType<T> operator()(std::size_t, const Particle<T> &particle) const
+    {
+        const double N = static_cast<double>(particle.size());
+        const double ess = particle.weight().ess();
+        double n = N;
+        if (ess < lower_ * N)
+            n = N * factor_;
+        else if (ess > upper_ * N)
+            n = N / factor_;
+        n = std::max(static_cast<double>(min_),
+            std::min(static_cast<double>(max_), n));
+
+        return static_cast<SizeType<T>>(n);
+    }
+
+    private:
+    std::size_t min_;
+    std::size_t max_;
+    double lower_;
+    double upper_;
+    double factor_;
+}; // class SizeControlESS
+
 /// \brief SMC Sampler
 /// \ingroup Core
 template <typename T>
@@ -65,10 +109,16 @@ class Sampler
     using move_type = std::function<std::size_t(std::size_t, Particle<T> &)>;
     using mcmc_type = std::function<std::size_t(std::size_t, Particle<T> &)>;
     using monitor_map_type = std::map<std::string, Monitor<T>>;
+    using size_control_type =
+        std::function<size_type(std::size_t, const Particle<T> &)>;
 
     /// \brief Construct a Sampler without selection of resampling method
-    explicit Sampler(size_type N)
-        : particle_(N)
+    ///
+    /// \details
+    /// In this and the other constructors, `touch` is the first touch policy
+    /// of the particle system, see Particle<T>.
+    explicit Sampler(size_type N, FirstTouch touch = FirstTouchSEQ)
+        : particle_(N, touch)
         , init_by_iter_(false)
         , resample_threshold_(resample_threshold_never())
         , iter_num_(0)
@@ -80,8 +130,9 @@ class Sampler
     ///
     /// \details
     /// By default, resampling will be performed at every iteration.
-    Sampler(size_type N, ResampleScheme scheme)
-        : particle_(N)
+    Sampler(size_type N, ResampleScheme scheme,
+        FirstTouch touch = FirstTouchSEQ)
+        : particle_(N, touch)
         , init_by_iter_(false)
         , resample_threshold_(resample_threshold_always())
         , iter_num_(0)
@@ -93,8 +144,9 @@ class Sampler
     ///
     /// \details
     /// By default, resampling will be performed at every iteration.
-    Sampler(size_type N, const resample_type &res_op)
-        : particle_(N)
+    Sampler(size_type N, const resample_type &res_op,
+        FirstTouch touch = FirstTouchSEQ)
+        : particle_(N, touch)
         , init_by_iter_(false)
         , resample_threshold_(resample_threshold_always())
         , iter_num_(0)
@@ -104,8 +156,9 @@ class Sampler
 
     /// \brief Construct a Sampler with a built-in resampling scheme and a
     /// threshold for resampling
-    Sampler(size_type N, ResampleScheme scheme, double resample_threshold)
-        : particle_(N)
+    Sampler(size_type N, ResampleScheme scheme, double resample_threshold,
+        FirstTouch touch = FirstTouchSEQ)
+        : particle_(N, touch)
         , init_by_iter_(false)
         , resample_threshold_(resample_threshold)
         , iter_num_(0)
@@ -115,9 +168,9 @@ class Sampler
 
     /// \brief Construct a Sampler with a user defined resampling scheme and a
     /// threshold for resampling
-    Sampler(
-        size_type N, const resample_type &res_op, double resample_threshold)
-        : particle_(N)
+    Sampler(size_type N, const resample_type &res_op,
+        double resample_threshold, FirstTouch touch = FirstTouchSEQ)
+        : particle_(N, touch)
         , init_by_iter_(false)
         , resample_threshold_(resample_threshold)
         , iter_num_(0)
@@ -134,7 +187,7 @@ class Sampler
         Sampler<T> sampler(*this);
         if (new_rng) {
             sampler.particle().rng_set().seed();
-            Seed::instance().seed_rng(sampler.particle().resample_rng());
+            Seed::instance().seed_rng(sampler.particle().rng());
         }
 
         return sampler;
@@ -155,6 +208,7 @@ class Sampler
             mcmc_queue_ = other.mcmc_queue_;
             resample_op_ = other.resample_op_;
             resample_threshold_ = other.resample_threshold_;
+            size_control_ = other.size_control_;
             iter_num_ = other.iter_num_;
             size_history_ = other.size_history_;
             ess_history_ = other.ess_history_;
@@ -175,6 +229,7 @@ class Sampler
             mcmc_queue_ = std::move(other.mcmc_queue_);
             resample_op_ = std::move(other.resample_op_);
             resample_threshold_ = other.resample_threshold_;
+            size_control_ = std::move(other.size_control_);
             iter_num_ = other.iter_num_;
             size_history_ = std::move(other.size_history_);
             ess_history_ = std::move(other.ess_history_);
@@ -253,6 +308,26 @@ class Sampler
         return *this;
     }
 
+    /// \brief Set the controller of the number of particles
+    ///
+    /// \details
+    /// If it is set, it is called at each iteration, after the moves and
+    /// before the resampling, with the iteration number and the particle
+    /// system, and returns the number of particles of the next iteration. If
+    /// the number differs from the current one, the particles are always
+    /// resampled into the new number, see Particle::resample. The state type
+    /// shall support `resize`, e.g., StateMatrix, or otherwise it is a compile
+    /// time error to call this function. An empty controller, the default,
+    /// keeps the number fixed. See also SizeControlESS.
+    Sampler<T> &size_control(const size_control_type &ctrl)
+    {
+        static_assert(internal::is_state_resize<T>::value,
+            "**Sampler::size_control** USED WITH A STATE WITHOUT resize(N)");
+
+        size_control_ = ctrl;
+        return *this;
+    }
+
     /// \brief Special value of resampling threshold that indicate no
     /// resampling will be ever performed
     static double resample_threshold_never()
@@ -698,6 +773,7 @@ class Sampler
 
     resample_type resample_op_;
     double resample_threshold_;
+    size_control_type size_control_;
 
     std::size_t iter_num_;
     Vector<std::size_t> size_history_;
@@ -735,6 +811,7 @@ class Sampler
     void do_init(void *param)
     {
         VSMC_RUNTIME_ASSERT_CORE_SAMPLER_FUNCTOR(init_, initialize, INIT);
+        particle_.arena().reset();
         accept_history_[0].push_back(init_(particle_, param));
         do_monitor(MonitorMove);
         do_resample();
@@ -745,6 +822,7 @@ class Sampler
 
     void do_iter()
     {
+        particle_.arena().reset();
         std::size_t ia = do_move(0);
         do_monitor(MonitorMove);
         do_resample();
@@ -773,8 +851,27 @@ class Sampler
     {
         size_history_.push_back(size());
         ess_history_.push_back(particle_.weight().ess());
+        if (!size_control_) {
+            resampled_history_.push_back(
+                particle_.resample(resample_op_, resample_threshold_));
+            return;
+        }
+
         resampled_history_.push_back(
-            particle_.resample(resample_op_, resample_threshold_));
+            do_resample_size(internal::is_state_resize<T>()));
+    }
+
+    bool do_resample_size(std::true_type)
+    {
+        const size_type N = size_control_(iter_num_, particle_);
+
+        return particle_.resample(resample_op_, resample_threshold_, N);
+    }
+
+    // size_control_ cannot be set if the state cannot be resized
+    bool do_resample_size(std::false_type)
+    {
+        return particle_.resample(resample_op_, resample_threshold_);
     }
 
     void do_monitor(MonitorStage stage)
@@ -0,0 +1,554 @@
+//============================================================================
+// vSMC/include/vsmc/core/state_cow.hpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c) 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#ifndef VSMC_CORE_STATE_COW_HPP
+#define VSMC_CORE_STATE_COW_HPP
+
+#include <vsmc/internal/common.hpp>
+#include <vsmc/core/single_particle.hpp>
+#include <vsmc/core/state_matrix.hpp>
+
+/// \brief The size in bytes of the blocks of new rows of StateCOW
+/// \ingroup Config
+#ifndef VSMC_STATE_COW_BLOCK_SIZE
+#define VSMC_STATE_COW_BLOCK_SIZE 1048576
+#endif
+
+#define VSMC_RUNTIME_ASSERT_CORE_STATE_COW_COPY_SIZE_MISMATCH                 \
+    VSMC_RUNTIME_ASSERT((N == static_cast<size_type>(this->size())),          \
+        "**StateCOW::copy** SIZE MISMATCH")
+
+#define VSMC_RUNTIME_ASSERT_CORE_STATE_COW_UNPACK_SIZE(psize, dim)            \
+    VSMC_RUNTIME_ASSERT((psize >= dim),                                       \
+        "**StateCOW::state_unpack** INPUT PACK SIZE TOO SMALL")
+
+namespace vsmc
+{
+
+namespace internal
+{
+
+// A block of rows, each with the number of references to it
+template <typename T>
+class StateCOWBlock
+{
+    public:
+    StateCOWBlock(std::size_t rows, std::size_t dim)
+        : rows_(rows)
+        , dim_(dim)
+        , next_(0)
+        , count_(new std::atomic<std::size_t>[rows])
+        , data_(rows * dim)
+    {
+        for (std::size_t r = 0; r != rows; ++r)
+            count_[r].store(0, std::memory_order_relaxed);
+    }
+
+    std::size_t rows() const { return rows_; }
+
+    // The number of rows that have been reserved
+    std::size_t allocated() const
+    {
+        return std::min(next_.load(std::memory_order_relaxed), rows_);
+    }
+
+    // Reserve an unused row, or return rows() if the block is full
+    std::size_t allocate()
+    {
+        const std::size_t r = next_.fetch_add(1, std::memory_order_relaxed);
+
+        return r < rows_ ? r : rows_;
+    }
+
+    T *row(std::size_t r) { return data_.data() + r * dim_; }
+
+    const T *row(std::size_t r) const { return data_.data() + r * dim_; }
+
+    bool unique(std::size_t r) const
+    {
+        return count_[r].load(std::memory_order_acquire) == 1;
+    }
+
+    bool dead(std::size_t r) const
+    {
+        return count_[r].load(std::memory_order_acquire) == 0;
+    }
+
+    void acquire(std::size_t r)
+    {
+        count_[r].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release(std::size_t r)
+    {
+        count_[r].fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    private:
+    std::size_t rows_;
+    std::size_t dim_;
+    std::atomic<std::size_t> next_;
+    std::unique_ptr<std::atomic<std::size_t>[]> count_;
+    StateStorage<T> data_;
+}; // class StateCOWBlock
+
+} // namespace vsmc::internal
+
+/// \brief Particle::value_type subtype with copy-on-write rows
+/// \ingroup Core
+///
+/// \details
+/// The state of each particle is a row of `dim()` elements. The rows are
+/// stored in reference counted blocks. Each particle refers to a row, and
+/// several particles, of this and other objects, may refer to the same row.
+/// Copying the object, e.g., by Particle::clone and Sampler::clone, and the
+/// resampling `copy(N, index)`, only copy the references. A row is copied
+/// when it is first written to while it is shared, that is, by the
+/// non-const `state`, `row_data` and `state_unpack`. Thus the memory
+/// bandwidth is proportional to the number of particles actually modified.
+/// The const member functions, and `cstate` and `crow_data`, never copy.
+///
+/// Writes to different particles may happen concurrently, e.g., in a
+/// parallel move. Copies of the object may be used in different threads.
+/// Pointers returned by `row_data` etc. are valid until the next write to
+/// the same particle, or the next `copy`. New rows are allocated in blocks
+/// of about `VSMC_STATE_COW_BLOCK_SIZE` bytes, and a block is freed when no
+/// object refers to any of its rows.
+template <std::size_t Dim, typename T>
+class StateCOW : public internal::StateMatrixDim<Dim>
+{
+    public:
+    using size_type = std::size_t;
+    using state_type = T;
+    using state_pack_type = Vector<T>;
+
+    template <typename S>
+    class single_particle_type : public SingleParticleBase<S>
+    {
+        public:
+        single_particle_type(
+            typename Particle<S>::size_type id, Particle<S> *pptr)
+            : SingleParticleBase<S>(id, pptr)
+        {
+        }
+
+        std::size_t dim() const { return this->particle().value().dim(); }
+
+        state_type &state(std::size_t pos) const
+        {
+            return this->particle().value().state(this->id(), pos);
+        }
+
+        const state_type &cstate(std::size_t pos) const
+        {
+            return this->particle().value().cstate(this->id(), pos);
+        }
+
+        state_type *row_data() const
+        {
+            return this->particle().value().row_data(this->id());
+        }
+
+        const state_type *crow_data() const
+        {
+            return this->particle().value().crow_data(this->id());
+        }
+    }; // class single_particle_type
+
+    explicit StateCOW(size_type N)
+        : size_(N)
+        , write_block_(nullptr)
+        , mutex_(new std::mutex)
+        , block_(N)
+        , row_(N)
+        , free_next_(0)
+    {
+        reset();
+    }
+
+    StateCOW(const StateCOW<Dim, T> &other)
+        : internal::StateMatrixDim<Dim>(other)
+        , size_(other.size_)
+        , blocks_(other.blocks_)
+        , write_block_(nullptr)
+        , mutex_(new std::mutex)
+        , block_(other.block_)
+        , row_(other.row_)
+        , free_next_(0)
+    {
+        for (size_type i = 0; i != size_; ++i)
+            block_[i]->acquire(row_[i]);
+    }
+
+    StateCOW(StateCOW<Dim, T> &&other)
+        : internal::StateMatrixDim<Dim>(other)
+        , size_(other.size_)
+        , blocks_(std::move(other.blocks_))
+        , write_block_(other.write_block_.load())
+        , mutex_(new std::mutex)
+        , block_(std::move(other.block_))
+        , row_(std::move(other.row_))
+        , free_next_(0)
+    {
+        other.size_ = 0;
+        other.write_block_.store(nullptr);
+        other.block_.clear();
+        other.row_.clear();
+    }
+
+    StateCOW<Dim, T> &operator=(const StateCOW<Dim, T> &other)
+    {
+        if (this != &other) {
+            StateCOW<Dim, T> tmp(other);
+            swap(tmp);
+        }
+
+        return *this;
+    }
+
+    StateCOW<Dim, T> &operator=(StateCOW<Dim, T> &&other)
+    {
+        if (this != &other) {
+            StateCOW<Dim, T> tmp(std::move(other));
+            swap(tmp);
+        }
+
+        return *this;
+    }
+
+    ~StateCOW() { release(); }
+
+    void resize_dim(std::size_t dim)
+    {
+        static_assert(Dim == Dynamic,
+            "**StateCOW** OBJECT DECLARED WITH A FIXED DIMENSION");
+        VSMC_RUNTIME_ASSERT_CORE_STATE_MATRIX_DIM_SIZE(dim);
+
+        release();
+        blocks_.clear();
+        free_block_.clear();
+        free_row_.clear();
+        internal::StateMatrixDim<Dim>::resize_dim(dim);
+        reset();
+    }
+
+    size_type size() const { return size_; }
+
+    /// \brief Whether the row of a particle is shared with other particles
+    /// or other objects
+    bool shared(size_type id) const { return !block_[id]->unique(row_[id]); }
+
+    /// \brief Write access to an element, copying the row if it is shared
+    state_type &state(size_type id, std::size_t pos)
+    {
+        return row_data(id)[pos];
+    }
+
+    const state_type &state(size_type id, std::size_t pos) const
+    {
+        return crow_data(id)[pos];
+    }
+
+    /// \brief Read only access to an element, never copying the row
+    const state_type &cstate(size_type id, std::size_t pos) const
+    {
+        return crow_data(id)[pos];
+    }
+
+    /// \brief Write access to a row, copying it if it is shared
+    state_type *row_data(size_type id)
+    {
+        if (!block_[id]->unique(row_[id]))
+            detach(id);
+
+        return block_[id]->row(row_[id]);
+    }
+
+    const state_type *row_data(size_type id) const { return crow_data(id); }
+
+    /// \brief Read only access to a row, never copying it
+    const state_type *crow_data(size_type id) const
+    {
+        return static_cast<const block_type *>(block_[id])->row(row_[id]);
+    }
+
+    void swap(StateCOW<Dim, T> &other)
+    {
+        internal::StateMatrixDim<Dim>::swap(other);
+        std::swap(size_, other.size_);
+        blocks_.swap(other.blocks_);
+        block_type *const write_block = write_block_.load();
+        write_block_.store(other.write_block_.load());
+        other.write_block_.store(write_block);
+        block_.swap(other.block_);
+        row_.swap(other.row_);
+        free_block_.swap(other.free_block_);
+        free_row_.swap(other.free_row_);
+        const std::size_t free_next = free_next_.load();
+        free_next_.store(other.free_next_.load());
+        other.free_next_.store(free_next);
+    }
+
+    template <typename OutputIter>
+    void read_state(std::size_t pos, OutputIter first) const
+    {
+        for (size_type i = 0; i != size_; ++i, ++first)
+            *first = cstate(i, pos);
+    }
+
+    template <typename OutputIterIter>
+    void read_state_matrix(OutputIterIter first) const
+    {
+        for (std::size_t d = 0; d != this->dim(); ++d, ++first)
+            read_state(d, *first);
+    }
+
+    template <MatrixLayout RLayout, typename OutputIter>
+    void read_state_matrix(OutputIter first) const
+    {
+        if (RLayout == RowMajor) {
+            for (size_type i = 0; i != size_; ++i)
+                first = std::copy_n(crow_data(i), this->dim(), first);
+        } else if (RLayout == ColMajor) {
+            for (std::size_t d = 0; d != this->dim(); ++d)
+                for (size_type i = 0; i != size_; ++i)
+                    *first++ = cstate(i, d);
+        }
+    }
+
+    template <typename IntType>
+    void copy(size_type N, const IntType *index)
+    {
+        VSMC_RUNTIME_ASSERT_CORE_STATE_COW_COPY_SIZE_MISMATCH;
+
+        block_buf_.resize(N);
+        row_buf_.resize(N);
+        for (size_type dst = 0; dst != N; ++dst) {
+            const size_type src = static_cast<size_type>(index[dst]);
+            block_buf_[dst] = block_[src];
+            row_buf_[dst] = row_[src];
+            block_buf_[dst]->acquire(row_buf_[dst]);
+        }
+        release();
+        block_.swap(block_buf_);
+        row_.swap(row_buf_);
+        prune();
+    }
+
+    void copy_particle(size_type src, size_type dst)
+    {
+        if (block_[src] == block_[dst] && row_[src] == row_[dst])
+            return;
+
+        block_[src]->acquire(row_[src]);
+        block_[dst]->release(row_[dst]);
+        block_[dst] = block_[src];
+        row_[dst] = row_[src];
+    }
+
+    state_pack_type state_pack(size_type id) const
+    {
+        return state_pack_type(crow_data(id), crow_data(id) + this->dim());
+    }
+
+    void state_unpack(size_type id, const state_pack_type &pack)
+    {
+        VSMC_RUNTIME_ASSERT_CORE_STATE_COW_UNPACK_SIZE(
+            pack.size(), this->dim());
+
+        std::copy_n(pack.data(), this->dim(), row_data(id));
+    }
+
+    void state_unpack(size_type id, state_pack_type &&pack)
+    {
+        VSMC_RUNTIME_ASSERT_CORE_STATE_COW_UNPACK_SIZE(
+            pack.size(), this->dim());
+
+        std::move(pack.data(), pack.data() + this->dim(), row_data(id));
+    }
+
+    template <typename CharT, typename Traits>
+    std::basic_ostream<CharT, Traits> &print(
+        std::basic_ostream<CharT, Traits> &os, char sepchar = '\t') const
+    {
+        if (this->dim() == 0 || size_ == 0 || !os.good())
+            return os;
+
+        for (size_type i = 0; i != size_; ++i) {
+            for (std::size_t d = 0; d != this->dim() - 1; ++d)
+                os << cstate(i, d) << sepchar;
+            os << cstate(i, this->dim() - 1) << '\n';
+        }
+
+        return os;
+    }
+
+    private:
+    using block_type = internal::StateCOWBlock<T>;
+
+    size_type size_;
+    std::vector<std::shared_ptr<block_type>> blocks_;
+    std::atomic<block_type *> write_block_;
+    std::unique_ptr<std::mutex> mutex_;
+    Vector<block_type *> block_;
+    Vector<std::size_t> row_;
+    Vector<block_type *> block_buf_;
+    Vector<std::size_t> row_buf_;
+    Vector<block_type *> free_block_;
+    Vector<std::size_t> free_row_;
+    std::atomic<std::size_t> free_next_;
+    Vector<block_type *> sorted_;
+    std::vector<bool> used_;
+
+    // Allocate a new row for each particle
+    void reset()
+    {
+        blocks_.push_back(std::make_shared<block_type>(size_, this->dim()));
+        block_type *const block = blocks_.back().get();
+        write_block_.store(block);
+        for (size_type i = 0; i != size_; ++i) {
+            block_[i] = block;
+            row_[i] = block->allocate();
+            block->acquire(row_[i]);
+        }
+    }
+
+    // The number of new rows allocated at a time, about
+    // VSMC_STATE_COW_BLOCK_SIZE bytes
+    std::size_t block_rows() const
+    {
+        const std::size_t rows =
+            VSMC_STATE_COW_BLOCK_SIZE / (sizeof(T) * this->dim());
+
+        return std::max(std::min(rows, size_), static_cast<std::size_t>(1));
+    }
+
+    void release()
+    {
+        for (size_type i = 0; i != size_; ++i)
+            block_[i]->release(row_[i]);
+    }
+
+    // Move a particle to a new row of its own
+    void detach(size_type id)
+    {
+        block_type *block = nullptr;
+        std::size_t r = 0;
+        const std::size_t k =
+            free_next_.fetch_add(1, std::memory_order_relaxed);
+        if (k < free_row_.size()) {
+            block = free_block_[k];
+            r = free_row_[k];
+        } else {
+            block = write_block_.load(std::memory_order_acquire);
+            r = block == nullptr ? 0 : block->allocate();
+        }
+        while (block == nullptr || r == block->rows()) {
+            {
+                std::lock_guard<std::mutex> lock(*mutex_);
+                if (write_block_.load(std::memory_order_acquire) == block) {
+                    blocks_.push_back(std::make_shared<block_type>(
+                        block_rows(), this->dim()));
+                    write_block_.store(
+                        blocks_.back().get(), std::memory_order_release);
+                }
+            }
+            block = write_block_.load(std::memory_order_acquire);
+            r = block->allocate();
+        }
+
+        std::copy_n(crow_data(id), this->dim(), block->row(r));
+        block->acquire(r);
+        block_[id]->release(row_[id]);
+        block_[id] = block;
+        row_[id] = r;
+    }
+
+    // Drop the blocks that no particle refers to, except the one for new
+    // rows, such that they are freed once no other object refers to them.
+    // The unreferenced rows of the blocks that no other object refers to are
+    // reused by detach(). Such blocks are kept, even if no particle refers
+    // to them, until there are size() rows to reuse.
+    void prune()
+    {
+        sorted_.resize(blocks_.size());
+        for (std::size_t k = 0; k != blocks_.size(); ++k)
+            sorted_[k] = blocks_[k].get();
+        std::sort(sorted_.begin(), sorted_.end());
+        used_.assign(sorted_.size(), false);
+        for (size_type i = 0; i != size_; ++i)
+            used_[sorted_pos(block_[i])] = true;
+
+        free_block_.clear();
+        free_row_.clear();
+        free_next_.store(0, std::memory_order_relaxed);
+        block_type *const write_block = write_block_.load();
+        std::size_t n = 0;
+        for (std::size_t k = 0; k != blocks_.size(); ++k) {
+            block_type *const block = blocks_[k].get();
+            const bool used =
+                block == write_block || used_[sorted_pos(block)];
+            const bool exclusive = blocks_[k].use_count() == 1;
+            if (!used && (!exclusive || free_row_.size() >= size_))
+                continue;
+            if (exclusive) {
+                for (std::size_t r = 0; r != block->allocated(); ++r) {
+                    if (block->dead(r)) {
+                        free_block_.push_back(block);
+                        free_row_.push_back(r);
+                    }
+                }
+            }
+            if (n != k)
+                blocks_[n] = std::move(blocks_[k]);
+            ++n;
+        }
+        blocks_.resize(n);
+    }
+
+    std::size_t sorted_pos(const block_type *block) const
+    {
+        return static_cast<std::size_t>(
+            std::lower_bound(sorted_.begin(), sorted_.end(), block) -
+            sorted_.begin());
+    }
+}; // class StateCOW
+
+template <typename CharT, typename Traits, std::size_t Dim, typename T>
+inline std::basic_ostream<CharT, Traits> &operator<<(
+    std::basic_ostream<CharT, Traits> &os, const StateCOW<Dim, T> &scow)
+{
+    return scow.print(os);
+}
+
+} // namespace vsmc
+
+#endif // VSMC_CORE_STATE_COW_HPP
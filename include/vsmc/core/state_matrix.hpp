@@ -35,10 +35,46 @@
 #include <vsmc/internal/common.hpp>
 #include <vsmc/core/single_particle.hpp>
 
+#if VSMC_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if VSMC_HAS_AVX2
+#include <immintrin.h>
+#endif
+
+#if VSMC_USE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/blocked_range2d.h>
+#include <tbb/parallel_for.h>
+#endif
+
+/// \brief The alignment of the storage of StateMatrix, of each row or column
+/// when the leading dimension is padded, and of the columns of StateTuple
+/// \ingroup Config
+#ifndef VSMC_STATE_MATRIX_ALIGNMENT
+#define VSMC_STATE_MATRIX_ALIGNMENT 64
+#endif
+
+/// \brief The memory management class of the storage of StateMatrix
+/// \ingroup Config
+///
+/// \details
+/// For example, `::vsmc::AlignedMemoryFile` maps the states from temporary
+/// files, for particle systems larger than the physical memory
+#ifndef VSMC_STATE_MATRIX_MEMORY_TYPE
+#define VSMC_STATE_MATRIX_MEMORY_TYPE ::vsmc::AlignedMemory
+#endif
+
 #define VSMC_RUNTIME_ASSERT_CORE_STATE_MATRIX_COPY_SIZE_MISMATCH              \
     VSMC_RUNTIME_ASSERT((N == static_cast<size_type>(this->size())),          \
         "**StateMatrix::copy** SIZE MISMATCH")
 
+#define VSMC_RUNTIME_ASSERT_CORE_STATE_MATRIX_CONVERT_LAYOUT(other)           \
+    VSMC_RUNTIME_ASSERT(                                                      \
+        (other.size() == size() && other.dim() == this->dim()),               \
+        "**StateMatrix::convert_layout** SIZE OR DIMENSION MISMATCH")
+
 #define VSMC_RUNTIME_ASSERT_CORE_STATE_MATRIX_DIM_SIZE(dim)                   \
     VSMC_RUNTIME_ASSERT((dim >= 1), "**StateMatrix** DIMENSION IS LESS THAN " \
                                     "1")
@@ -53,6 +89,260 @@ namespace vsmc
 namespace internal
 {
 
+template <typename T>
+using StateStorage = typename std::conditional<std::is_scalar<T>::value,
+    std::vector<T, AlignedAllocator<T, VSMC_STATE_MATRIX_ALIGNMENT>>,
+    std::vector<T>>::type;
+
+// The storage of StateMatrix, left uninitialized by construction without a
+// value, such that it can be first touched in parallel
+template <typename T>
+using StateMatrixStorage = typename std::conditional<std::is_scalar<T>::value,
+    std::vector<T,
+        DefaultInitAllocator<AlignedAllocator<T, VSMC_STATE_MATRIX_ALIGNMENT,
+            VSMC_STATE_MATRIX_MEMORY_TYPE>>>,
+    std::vector<T>>::type;
+
+// Whether the storage of StateMatrix is mapped from files
+template <typename T>
+using StateMatrixFile = std::integral_constant<bool,
+    std::is_scalar<T>::value &&
+        is_memory_file<VSMC_STATE_MATRIX_MEMORY_TYPE>::value>;
+
+template <typename T>
+using StateStreamable = std::integral_constant<bool,
+    VSMC_HAS_SSE2 && std::is_scalar<T>::value && 16 % sizeof(T) == 0>;
+
+// Sequential writer of a contiguous destination, with non-temporal stores
+// of the 16-byte aligned blocks of scalar types
+template <typename T, bool = StateStreamable<T>::value>
+class StateStreamWriter
+{
+    public:
+    explicit StateStreamWriter(T *dst) : dst_(dst) {}
+
+    void put(const T &v) { *dst_++ = v; }
+
+    void write(const T *src, std::size_t n)
+    {
+        dst_ = std::copy_n(src, n, dst_);
+    }
+
+    template <typename IntType>
+    void gather(const T *src, const IntType *index, std::size_t n)
+    {
+        for (std::size_t i = 0; i != n; ++i)
+            *dst_++ = src[static_cast<std::size_t>(index[i])];
+    }
+
+    void flush() {}
+
+    private:
+    T *dst_;
+}; // class StateStreamWriter
+
+#if VSMC_HAS_SSE2
+template <typename T>
+class StateStreamWriter<T, true>
+{
+    public:
+    explicit StateStreamWriter(T *dst)
+        : dst_(dst)
+        , head_((16 - reinterpret_cast<std::uintptr_t>(dst) % 16) % 16 /
+              sizeof(T))
+        , n_(0)
+    {
+    }
+
+    void put(const T &v)
+    {
+        if (head_ != 0) {
+            *dst_++ = v;
+            --head_;
+            return;
+        }
+        buf_[n_++] = v;
+        if (n_ == K) {
+            _mm_stream_si128(reinterpret_cast<__m128i *>(dst_),
+                _mm_load_si128(reinterpret_cast<const __m128i *>(buf_)));
+            dst_ += K;
+            n_ = 0;
+        }
+    }
+
+    void write(const T *src, std::size_t n)
+    {
+        for (; n != 0 && (head_ != 0 || n_ != 0); --n)
+            put(*src++);
+        for (; n >= K; n -= K, src += K, dst_ += K) {
+            _mm_stream_si128(reinterpret_cast<__m128i *>(dst_),
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+        }
+        for (; n != 0; --n)
+            put(*src++);
+    }
+
+    template <typename IntType>
+    void gather(const T *src, const IntType *index, std::size_t n)
+    {
+        for (; n != 0 && (head_ != 0 || n_ != 0); --n)
+            put(src[static_cast<std::size_t>(*index++)]);
+        for (; n >= K; n -= K, index += K, dst_ += K) {
+            for (std::size_t k = 0; k != K; ++k)
+                buf_[k] = src[static_cast<std::size_t>(index[k])];
+            _mm_stream_si128(reinterpret_cast<__m128i *>(dst_),
+                _mm_load_si128(reinterpret_cast<const __m128i *>(buf_)));
+        }
+        for (; n != 0; --n)
+            put(src[static_cast<std::size_t>(*index++)]);
+    }
+
+    // Store the buffered elements and order the non-temporal stores
+    void flush()
+    {
+        dst_ = std::copy_n(buf_, n_, dst_);
+        n_ = 0;
+        _mm_sfence();
+    }
+
+    private:
+    static constexpr std::size_t K = 16 / sizeof(T);
+
+    T *dst_;
+    std::size_t head_;
+    std::size_t n_;
+    alignas(16) T buf_[K];
+}; // class StateStreamWriter
+#endif // VSMC_HAS_SSE2
+
+// The side of the square tiles of the transpose kernel
+constexpr std::size_t StateTransposeTile = 32;
+
+// The minimum number of elements to transpose in parallel
+constexpr std::size_t StateTransposeParallel = 1 << 16;
+
+template <typename T>
+inline void state_transpose4(
+    const T *src, std::size_t lds, T *dst, std::size_t ldd)
+{
+    for (std::size_t i = 0; i != 4; ++i)
+        for (std::size_t j = 0; j != 4; ++j)
+            dst[j * ldd + i] = src[i * lds + j];
+}
+
+#if VSMC_HAS_SSE2
+inline void state_transpose4(
+    const float *src, std::size_t lds, float *dst, std::size_t ldd)
+{
+    __m128 r0 = _mm_loadu_ps(src);
+    __m128 r1 = _mm_loadu_ps(src + lds);
+    __m128 r2 = _mm_loadu_ps(src + lds * 2);
+    __m128 r3 = _mm_loadu_ps(src + lds * 3);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(dst, r0);
+    _mm_storeu_ps(dst + ldd, r1);
+    _mm_storeu_ps(dst + ldd * 2, r2);
+    _mm_storeu_ps(dst + ldd * 3, r3);
+}
+#endif // VSMC_HAS_SSE2
+
+#if VSMC_HAS_AVX2
+inline void state_transpose4(
+    const double *src, std::size_t lds, double *dst, std::size_t ldd)
+{
+    const __m256d r0 = _mm256_loadu_pd(src);
+    const __m256d r1 = _mm256_loadu_pd(src + lds);
+    const __m256d r2 = _mm256_loadu_pd(src + lds * 2);
+    const __m256d r3 = _mm256_loadu_pd(src + lds * 3);
+    const __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+    const __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+    const __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+    const __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+    _mm256_storeu_pd(dst, _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(dst + ldd, _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(dst + ldd * 2, _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(dst + ldd * 3, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+#endif // VSMC_HAS_AVX2
+
+// Transpose the rows i0 to i1 - 1 and columns j0 to j1 - 1, tile by tile,
+// such that each row of dst is completed before moving to the next ones
+template <typename T>
+inline void state_transpose_range(std::size_t i0, std::size_t i1,
+    std::size_t j0, std::size_t j1, const T *src, std::size_t lds, T *dst,
+    std::size_t ldd)
+{
+    const std::size_t tile = StateTransposeTile;
+    for (std::size_t jb = j0; jb < j1; jb += tile) {
+        const std::size_t je = std::min(jb + tile, j1);
+        for (std::size_t ib = i0; ib < i1; ib += tile) {
+            const std::size_t ie = std::min(ib + tile, i1);
+            std::size_t i = ib;
+            for (; i + 4 <= ie; i += 4) {
+                std::size_t j = jb;
+                for (; j + 4 <= je; j += 4) {
+                    state_transpose4(
+                        src + i * lds + j, lds, dst + j * ldd + i, ldd);
+                }
+                for (; j != je; ++j)
+                    for (std::size_t k = i; k != i + 4; ++k)
+                        dst[j * ldd + k] = src[k * lds + j];
+            }
+            for (; i != ie; ++i)
+                for (std::size_t j = jb; j != je; ++j)
+                    dst[j * ldd + i] = src[i * lds + j];
+        }
+    }
+}
+
+// Transpose the columns j0 to j1 - 1 of a source with few rows, writing dst
+// sequentially, the rows of src being read in parallel streams
+template <typename T>
+inline void state_transpose_short(std::size_t nrow, std::size_t j0,
+    std::size_t j1, const T *src, std::size_t lds, T *dst, std::size_t ldd)
+{
+    for (std::size_t j = j0; j != j1; ++j, dst += ldd)
+        for (std::size_t i = 0; i != nrow; ++i)
+            dst[i] = src[i * lds + j];
+}
+
+// dst(j, i) = src(i, j), where src is an nrow by ncol row major matrix with
+// leading dimension lds, and dst is an ncol by nrow row major matrix with
+// leading dimension ldd
+template <typename T>
+inline void state_transpose(std::size_t nrow, std::size_t ncol, const T *src,
+    std::size_t lds, T *dst, std::size_t ldd)
+{
+    const std::size_t tile = StateTransposeTile;
+    const bool short_src = nrow <= tile * 2;
+#if VSMC_USE_TBB
+    if (nrow * ncol >= StateTransposeParallel && short_src) {
+        ::tbb::parallel_for(::tbb::blocked_range<std::size_t>(0, ncol, tile),
+            [nrow, src, lds, dst, ldd](
+                const ::tbb::blocked_range<std::size_t> &range) {
+                state_transpose_short(nrow, range.begin(), range.end(), src,
+                    lds, dst + range.begin() * ldd, ldd);
+            });
+        return;
+    }
+    if (nrow * ncol >= StateTransposeParallel) {
+        ::tbb::parallel_for(::tbb::blocked_range2d<std::size_t>(
+                                0, nrow, tile, 0, ncol, tile),
+            [src, lds, dst, ldd](
+                const ::tbb::blocked_range2d<std::size_t> &range) {
+                state_transpose_range(range.rows().begin(),
+                    range.rows().end(), range.cols().begin(),
+                    range.cols().end(), src, lds, dst, ldd);
+            });
+        return;
+    }
+#endif // VSMC_USE_TBB
+    if (short_src)
+        state_transpose_short(nrow, 0, ncol, src, lds, dst, ldd);
+    else
+        state_transpose_range(0, nrow, 0, ncol, src, lds, dst, ldd);
+}
+
 template <std::size_t Dim>
 class StateMatrixDim
 {
@@ -117,55 +407,251 @@ class StateMatrixBase : public internal::StateMatrixDim<Dim>
         VSMC_RUNTIME_ASSERT_CORE_STATE_MATRIX_DIM_SIZE(dim);
 
         internal::StateMatrixDim<Dim>::resize_dim(dim);
-        data_.resize(size_ * dim);
+        stride_ = stride_padded(padding_);
+        if (data_.size() != vec_num() * stride_)
+            data_ = storage(stride_);
+        if (double_buffer_ && back_.size() != data_.size())
+            back_ = storage(stride_);
+    }
+
+    /// \brief Change the number of particles
+    ///
+    /// \details
+    /// The states of the first `min(N, size())` particles are retained and
+    /// those of the new particles are zero. The capacity of the storage grows
+    /// geometrically, such that a sequence of resizes is amortized, and it is
+    /// not released when the matrix shrinks. The columns of a ColMajor matrix
+    /// are moved to the new leading dimension. The content of the double
+    /// buffer, if enabled, is undefined afterwards. The first touch policy is
+    /// not applied to the new storage. Pointers returned by `data()` etc. are
+    /// invalidated.
+    void resize(size_type N)
+    {
+        if (N == size_)
+            return;
+
+        const size_type M = size_;
+        size_ = N;
+        if (Layout == RowMajor) {
+            internal::reserve_geometric(data_, N * stride_);
+            data_.resize(N * stride_, T());
+        } else {
+            resize_col(M, N);
+        }
+        if (double_buffer_) {
+            internal::reserve_geometric(back_, data_.size());
+            back_.resize(data_.size());
+        }
     }
 
     size_type size() const { return size_; }
 
+    /// \brief The leading dimension
+    ///
+    /// \details
+    /// The distance, in number of elements, between the beginnings of two
+    /// consecutive rows of a RowMajor matrix, or columns of a ColMajor
+    /// matrix. It is `dim()` or `size()`, respectively, unless the matrix is
+    /// padded.
+    std::size_t stride() const { return stride_; }
+
+    /// \brief The multiple of the leading dimension
+    std::size_t padding() const { return padding_; }
+
+    /// \brief Pad the leading dimension to a multiple of a given number of
+    /// elements
+    ///
+    /// \details
+    /// If `multiple` is zero, it is the number of elements of
+    /// `VSMC_STATE_MATRIX_ALIGNMENT` bytes, such that each row or column
+    /// begins at an aligned address. If it is one, the matrix is contiguous,
+    /// which is the default. The values of the states are retained.
+    void padding(std::size_t multiple)
+    {
+        if (multiple == 0) {
+            multiple = VSMC_STATE_MATRIX_ALIGNMENT / sizeof(T);
+            if (multiple == 0)
+                multiple = 1;
+        }
+
+        const std::size_t stride = stride_padded(multiple);
+        if (stride != stride_) {
+            const std::size_t len = vec_len();
+            storage_type data(storage(stride));
+            for (std::size_t k = 0; k != vec_num(); ++k) {
+                std::copy_n(data_.data() + k * stride_, len,
+                    data.data() + k * stride);
+            }
+            data_.swap(data);
+            stride_ = stride;
+            if (double_buffer_)
+                back_ = storage(stride_);
+        }
+        padding_ = multiple;
+    }
+
+    /// \brief Whether the resampling gathers the states into a second buffer
+    bool double_buffer() const { return double_buffer_; }
+
+    /// \brief Enable or disable the double buffer
+    ///
+    /// \details
+    /// With the double buffer, `copy(N, index)` gathers the parents from the
+    /// storage into a second buffer of the same size, with non-temporal
+    /// stores, and then swaps the two. Unlike the in-place copy, the
+    /// particles can be gathered in any order, and StateTBB and StateOMP
+    /// gather them in parallel. It doubles the memory usage, and each copy
+    /// invalidates pointers returned by `data()` etc. The non-temporal stores
+    /// are most effective if each row (RowMajor) or column (ColMajor) is
+    /// aligned, e.g., with `padding(0)`. The rows of a padded RowMajor matrix
+    /// are gathered together with their padding, such that the buffer is
+    /// written contiguously.
+    ///
+    /// The double buffer is disabled by default. On a single thread, the
+    /// in-place copy is faster, since it skips the particles that are their
+    /// own parents. The gather pays off when many threads resample in
+    /// parallel, see the `.buf` runs of the `pf` example.
+    void double_buffer(bool enable)
+    {
+        double_buffer_ = enable;
+        if (enable && back_.size() != data_.size())
+            back_ = storage(stride_);
+        else if (!enable)
+            storage_type().swap(back_);
+    }
+
+    /// \brief Swap the storage with the double buffer
+    void swap_buffer() { data_.swap(back_); }
+
+    /// \brief Prefetch the states of the particles `first` to `last - 1`
+    ///
+    /// \details
+    /// It is a hint to read the pages of the particles ahead, see
+    /// `memory_advise`, which is issued by the SMP backends for the next
+    /// block of particles while the current one is processed. It does
+    /// nothing unless the storage is mapped from files, see
+    /// `VSMC_STATE_MATRIX_MEMORY_TYPE`.
+    void prefetch(size_type first, size_type last) const
+    {
+        if (!internal::StateMatrixFile<T>::value || first >= last)
+            return;
+
+        const std::size_t bytes = sizeof(T) * (last - first);
+        if (Layout == RowMajor) {
+            memory_advise(data_.data() + first * stride_, bytes * stride_,
+                AdviceWillNeed);
+        } else {
+            for (std::size_t d = 0; d != this->dim(); ++d) {
+                memory_advise(
+                    data_.data() + d * stride_ + first, bytes, AdviceWillNeed);
+            }
+        }
+    }
+
+    /// \brief Raw data of the matrix, whose rows (RowMajor) or columns
+    /// (ColMajor) are `stride()` elements apart
     state_type *data() { return data_.data(); }
 
+    /// \brief Raw data of the matrix, whose rows (RowMajor) or columns
+    /// (ColMajor) are `stride()` elements apart
     const state_type *data() const { return data_.data(); }
 
     void swap(StateMatrixBase<Layout, Dim, T> &other)
     {
         internal::StateMatrixDim<Dim>::swap(other);
         std::swap(size_, other.size_);
+        std::swap(padding_, other.padding_);
+        std::swap(stride_, other.stride_);
+        std::swap(double_buffer_, other.double_buffer_);
+        std::swap(touch_, other.touch_);
         data_.swap(other.data_);
+        back_.swap(other.back_);
     }
 
     template <typename OutputIter>
     void read_state(std::size_t pos, OutputIter first) const
     {
-        const StateMatrix<Layout, Dim, T> *sptr =
-            static_cast<const StateMatrix<Layout, Dim, T> *>(this);
-        for (size_type i = 0; i != size_; ++i, ++first)
-            *first = sptr->state(i, pos);
+        if (Layout == ColMajor) {
+            std::copy_n(data_.data() + pos * stride_, size_, first);
+        } else {
+            const T *src = data_.data() + pos;
+            for (size_type i = 0; i != size_; ++i, ++first, src += stride_)
+                *first = *src;
+        }
     }
 
+    /// \brief Read all states, the `d`th through the `d`th output iterator
+    ///
+    /// \details
+    /// For a RowMajor matrix, the rows are read in tiles, each of which is
+    /// written to all outputs, instead of reading the matrix once for each
+    /// output.
     template <typename OutputIterIter>
     void read_state_matrix(OutputIterIter first) const
     {
+        if (Layout == ColMajor) {
+            for (std::size_t d = 0; d != this->dim(); ++d, ++first)
+                read_state(d, *first);
+            return;
+        }
+
+        using iter_type = typename std::decay<decltype(*first)>::type;
+        std::vector<iter_type> iters;
+        iters.reserve(this->dim());
         for (std::size_t d = 0; d != this->dim(); ++d, ++first)
-            read_state(d, *first);
+            iters.push_back(*first);
+        const std::size_t tile = internal::StateTransposeTile;
+        for (size_type ib = 0; ib < size_; ib += tile) {
+            const size_type ie = std::min(ib + tile, size_);
+            for (std::size_t d = 0; d != this->dim(); ++d) {
+                iter_type &iter = iters[d];
+                const T *src = data_.data() + ib * stride_ + d;
+                for (size_type i = ib; i != ie; ++i, ++iter, src += stride_)
+                    *iter = *src;
+            }
+        }
     }
 
     template <MatrixLayout RLayout, typename OutputIter>
     void read_state_matrix(OutputIter first) const
     {
         if (RLayout == Layout) {
-            std::copy(data_.begin(), data_.end(), first);
+            if (stride_ == vec_len()) {
+                std::copy(data_.begin(), data_.end(), first);
+            } else {
+                const std::size_t len = vec_len();
+                for (std::size_t k = 0; k != vec_num(); ++k)
+                    first = std::copy_n(data_.data() + k * stride_, len, first);
+            }
         } else {
-            const StateMatrix<Layout, Dim, T> *sptr =
-                static_cast<const StateMatrix<Layout, Dim, T> *>(this);
-            if (RLayout == RowMajor) {
-                for (size_type i = 0; i != size_; ++i)
-                    for (std::size_t d = 0; d != this->dim(); ++d)
-                        *first++ = sptr->state(i, d);
-            } else if (RLayout == ColMajor) {
-                for (std::size_t d = 0; d != this->dim(); ++d)
-                    for (size_type i = 0; i != size_; ++i)
-                        *first++ = sptr->state(i, d);
+            read_transpose(first,
+                std::integral_constant<bool,
+                    std::is_same<OutputIter, T *>::value>());
+        }
+    }
+
+    /// \brief Copy the states to a matrix of the same size and dimension,
+    /// and possibly another layout
+    ///
+    /// \details
+    /// For example, a RowMajor state used by the moves can be converted to a
+    /// ColMajor matrix for vectorized likelihood evaluations. The conversion
+    /// between layouts uses a tiled transpose, which is parallelized with
+    /// `VSMC_USE_TBB`. The leading dimension of `other` is retained.
+    template <MatrixLayout RLayout, std::size_t RDim>
+    void convert_layout(StateMatrixBase<RLayout, RDim, T> &other) const
+    {
+        VSMC_RUNTIME_ASSERT_CORE_STATE_MATRIX_CONVERT_LAYOUT(other);
+
+        if (RLayout == Layout) {
+            const std::size_t len = vec_len();
+            for (std::size_t k = 0; k != vec_num(); ++k) {
+                std::copy_n(data_.data() + k * stride_, len,
+                    other.data() + k * other.stride());
             }
+        } else {
+            internal::state_transpose(vec_num(), vec_len(), data_.data(),
+                stride_, other.data(), other.stride());
         }
     }
 
@@ -188,11 +674,126 @@ class StateMatrixBase : public internal::StateMatrixDim<Dim>
     }
 
     protected:
-    explicit StateMatrixBase(size_type N) : size_(N), data_(N * Dim) {}
+    /// \brief Construct a matrix of `N` particles
+    ///
+    /// \details
+    /// The states are zero initialized. With a parallel first touch policy,
+    /// the storage is allocated uninitialized and each range of particles,
+    /// as partitioned by the backend, is initialized by the thread that will
+    /// later process it, such that on NUMA systems the pages are placed near
+    /// that thread. The policy is retained by `resize_dim`, `padding` and
+    /// the double buffer.
+    explicit StateMatrixBase(size_type N, FirstTouch touch = FirstTouchSEQ)
+        : size_(N)
+        , padding_(1)
+        , stride_(Layout == RowMajor ? Dim : N)
+        , double_buffer_(false)
+        , touch_(touch)
+        , data_(storage(stride_))
+    {
+    }
+
+    state_type *buffer_data() { return back_.data(); }
 
     private:
+    using storage_type = internal::StateMatrixStorage<T>;
+
     size_type size_;
-    Vector<T> data_;
+    std::size_t padding_;
+    std::size_t stride_;
+    bool double_buffer_;
+    FirstTouch touch_;
+    storage_type data_;
+    storage_type back_;
+
+    // The number and the length of rows (RowMajor) or columns (ColMajor)
+    std::size_t vec_num() const
+    {
+        return Layout == RowMajor ? size_ : this->dim();
+    }
+
+    std::size_t vec_len() const
+    {
+        return Layout == RowMajor ? this->dim() : size_;
+    }
+
+    std::size_t stride_padded(std::size_t multiple) const
+    {
+        return (vec_len() + multiple - 1) / multiple * multiple;
+    }
+
+    // A zero storage with the leading dimension stride, first touched by the
+    // ranges of particles
+    storage_type storage(std::size_t stride) const
+    {
+        const std::size_t num = vec_num();
+        if (touch_ == FirstTouchSEQ)
+            return storage_type(num * stride, T());
+
+        storage_type data(num * stride);
+        T *const ptr = data.data();
+        const std::size_t N = size_;
+        internal::first_touch(
+            N, touch_, [ptr, num, stride, N](std::size_t i, std::size_t j) {
+                if (Layout == RowMajor) {
+                    std::fill(ptr + i * stride, ptr + j * stride, T());
+                } else {
+                    if (j == N)
+                        j = stride;
+                    for (std::size_t k = 0; k != num; ++k)
+                        std::fill(ptr + k * stride + i, ptr + k * stride + j,
+                            T());
+                }
+            });
+
+        return data;
+    }
+
+    // Move the columns of M particles to the leading dimension of N
+    void resize_col(size_type M, size_type N)
+    {
+        const std::size_t dim = this->dim();
+        const std::size_t stride = stride_padded(padding_);
+        const std::size_t len = std::min(M, N);
+        if (stride > stride_) {
+            internal::reserve_geometric(data_, dim * stride);
+            data_.resize(dim * stride, T());
+            T *const ptr = data_.data();
+            for (std::size_t d = dim; d != 0; --d) {
+                T *const src = ptr + (d - 1) * stride_;
+                T *const dst = ptr + (d - 1) * stride;
+                std::copy_backward(src, src + len, dst + len);
+                std::fill(dst + len, dst + stride, T());
+            }
+        } else {
+            T *const ptr = data_.data();
+            for (std::size_t d = 0; d != dim; ++d) {
+                T *const src = ptr + d * stride_;
+                T *const dst = ptr + d * stride;
+                if (dst != src)
+                    std::copy(src, src + len, dst);
+                std::fill(dst + len, dst + stride, T());
+            }
+            data_.resize(dim * stride);
+        }
+        stride_ = stride;
+    }
+
+    void read_transpose(T *first, std::true_type) const
+    {
+        internal::state_transpose(
+            vec_num(), vec_len(), data_.data(), stride_, first, vec_num());
+    }
+
+    template <typename OutputIter>
+    void read_transpose(OutputIter first, std::false_type) const
+    {
+        for (std::size_t k = 0; k != vec_len(); ++k) {
+            const T *src = data_.data() + k;
+            for (std::size_t v = 0; v != vec_num(); ++v, src += stride_)
+                *first++ = *src;
+        }
+    }
 }; // class StateMatrixBase
 
 template <typename CharT, typename Traits, MatrixLayout Layout,
@@ -217,14 +818,19 @@ class StateMatrix<RowMajor, Dim, T> : public StateMatrixBase<RowMajor, Dim, T>
 
     explicit StateMatrix(size_type N) : state_matrix_base_type(N) {}
 
+    StateMatrix(size_type N, FirstTouch touch)
+        : state_matrix_base_type(N, touch)
+    {
+    }
+
     T &state(size_type id, std::size_t pos)
     {
-        return this->data()[id * this->dim() + pos];
+        return this->data()[id * this->stride() + pos];
     }
 
     const T &state(size_type id, std::size_t pos) const
     {
-        return this->data()[id * this->dim() + pos];
+        return this->data()[id * this->stride() + pos];
     }
 
     using state_matrix_base_type::data;
@@ -235,12 +841,12 @@ class StateMatrix<RowMajor, Dim, T> : public StateMatrixBase<RowMajor, Dim, T>
 
     state_type *row_data(size_type id)
     {
-        return this->data() + id * this->dim();
+        return this->data() + id * this->stride();
     }
 
     const state_type *row_data(size_type id) const
     {
-        return this->data() + id * this->dim();
+        return this->data() + id * this->stride();
     }
 
     template <typename IntType>
@@ -248,10 +854,36 @@ class StateMatrix<RowMajor, Dim, T> : public StateMatrixBase<RowMajor, Dim, T>
     {
         VSMC_RUNTIME_ASSERT_CORE_STATE_MATRIX_COPY_SIZE_MISMATCH;
 
+        if (this->double_buffer()) {
+            gather(0, N, index);
+            this->swap_buffer();
+            return;
+        }
+
         for (size_type dst = 0; dst != N; ++dst)
             copy_particle(index[dst], dst);
     }
 
+    /// \brief Gather the parents of the particles `first` to `last - 1` into
+    /// the double buffer
+    ///
+    /// \details
+    /// Particle `i` of the buffer becomes a copy of particle `index[i]`.
+    /// Disjoint ranges can be gathered concurrently, before a single call to
+    /// `swap_buffer()`.
+    template <typename IntType>
+    void gather(size_type first, size_type last, const IntType *index)
+    {
+        // Padded rows are gathered with their padding, such that the
+        // destination is contiguous and streamed in whole aligned blocks
+        const std::size_t stride = this->stride();
+        state_type *const back = this->buffer_data();
+        internal::StateStreamWriter<state_type> writer(back + first * stride);
+        for (size_type dst = first; dst != last; ++dst)
+            writer.write(row_data(static_cast<size_type>(index[dst])), stride);
+        writer.flush();
+    }
+
     void copy_particle(size_type src, size_type dst)
     {
         if (src == dst)
@@ -327,14 +959,19 @@ class StateMatrix<ColMajor, Dim, T> : public StateMatrixBase<ColMajor, Dim, T>
 
     explicit StateMatrix(size_type N) : state_matrix_base_type(N) {}
 
+    StateMatrix(size_type N, FirstTouch touch)
+        : state_matrix_base_type(N, touch)
+    {
+    }
+
     T &state(size_type id, std::size_t pos)
     {
-        return this->data()[pos * this->size() + id];
+        return this->data()[pos * this->stride() + id];
     }
 
     const T &state(size_type id, std::size_t pos) const
     {
-        return this->data()[pos * this->size() + id];
+        return this->data()[pos * this->stride() + id];
     }
 
     using state_matrix_base_type::data;
@@ -345,12 +982,12 @@ class StateMatrix<ColMajor, Dim, T> : public StateMatrixBase<ColMajor, Dim, T>
 
     state_type *col_data(std::size_t pos)
     {
-        return this->data() + pos * this->size();
+        return this->data() + pos * this->stride();
     }
 
     const state_type *col_data(std::size_t pos) const
     {
-        return this->data() + pos * this->size();
+        return this->data() + pos * this->stride();
     }
 
     template <typename IntType>
@@ -358,11 +995,36 @@ class StateMatrix<ColMajor, Dim, T> : public StateMatrixBase<ColMajor, Dim, T>
     {
         VSMC_RUNTIME_ASSERT_CORE_STATE_MATRIX_COPY_SIZE_MISMATCH;
 
+        if (this->double_buffer()) {
+            gather(0, N, index);
+            this->swap_buffer();
+            return;
+        }
+
         for (std::size_t d = 0; d != this->dim(); ++d)
             for (size_type dst = 0; dst != N; ++dst)
                 state(dst, d) = state(static_cast<size_type>(index[dst]), d);
     }
 
+    /// \brief Gather the parents of the particles `first` to `last - 1` into
+    /// the double buffer
+    ///
+    /// \details
+    /// Particle `i` of the buffer becomes a copy of particle `index[i]`.
+    /// Disjoint ranges can be gathered concurrently, before a single call to
+    /// `swap_buffer()`.
+    template <typename IntType>
+    void gather(size_type first, size_type last, const IntType *index)
+    {
+        state_type *const back = this->buffer_data();
+        for (std::size_t d = 0; d != this->dim(); ++d) {
+            internal::StateStreamWriter<state_type> writer(
+                back + d * this->stride() + first);
+            writer.gather(col_data(d), index + first, last - first);
+            writer.flush();
+        }
+    }
+
     void copy_particle(size_type src, size_type dst)
     {
         if (src == dst)
@@ -421,7 +1083,7 @@ class StateMatrix<ColMajor, Dim, T> : public StateMatrixBase<ColMajor, Dim, T>
     void copy_particle_pos(
         const state_type *src, state_type *dst, std::true_type)
     {
-        dst[D * this->size()] = src[D * this->size()];
+        dst[D * this->stride()] = src[D * this->stride()];
         copy_particle_pos<D + 1>(
             src, dst, std::integral_constant<bool, D + 1 < Dim>());
     }
@@ -0,0 +1,331 @@
+//============================================================================
+// vSMC/include/vsmc/core/state_ragged.hpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c) 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#ifndef VSMC_CORE_STATE_RAGGED_HPP
+#define VSMC_CORE_STATE_RAGGED_HPP
+
+#include <vsmc/internal/common.hpp>
+#include <vsmc/core/single_particle.hpp>
+#include <vsmc/core/state_matrix.hpp>
+
+#if VSMC_USE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
+#define VSMC_RUNTIME_ASSERT_CORE_STATE_RAGGED_COPY_SIZE_MISMATCH              \
+    VSMC_RUNTIME_ASSERT((N == static_cast<size_type>(this->size())),          \
+        "**StateRagged::copy** SIZE MISMATCH")
+
+namespace vsmc
+{
+
+/// \brief Particle::value_type subtype of arrays of different lengths
+/// \ingroup Core
+///
+/// \details
+/// The array of each particle is a segment of a single arena, located by a
+/// table of offsets, instead of being a container that owns heap memory.
+/// Each segment has a length, `dim(id)`, and a capacity. Resizing a
+/// particle within its capacity is done in place. Otherwise its array is
+/// moved to the end of the arena, which grows geometrically, and the old
+/// segment is left unused until the next compaction.
+///
+/// The resampling `copy(N, index)` gathers the arrays of the parents into a
+/// second arena, packed in the order of the particles, and swaps the two
+/// arenas. Thus it also compacts the storage. Both arenas and the tables
+/// are reused, such that no memory is allocated once they are large enough.
+/// With `VSMC_USE_TBB`, the gather is done in parallel. For this reason,
+/// StateRagged shall not be wrapped in StateTBB or StateOMP, whose
+/// particle-by-particle copies may need to move arrays concurrently.
+///
+/// Resizing a particle beyond its capacity modifies the arena and shall not
+/// be done concurrently with accesses to other particles. One may set the
+/// lengths of all particles at once, e.g., in the initialization before
+/// a parallel loop, with `resize_rows(first)`.
+template <typename T>
+class StateRagged
+{
+    public:
+    using size_type = std::size_t;
+    using state_type = T;
+    using state_pack_type = Vector<T>;
+
+    template <typename S>
+    class single_particle_type : public SingleParticleBase<S>
+    {
+        public:
+        single_particle_type(
+            typename Particle<S>::size_type id, Particle<S> *pptr)
+            : SingleParticleBase<S>(id, pptr)
+        {
+        }
+
+        std::size_t dim() const
+        {
+            return this->particle().value().dim(this->id());
+        }
+
+        state_type &state(std::size_t pos) const
+        {
+            return this->particle().value().state(this->id(), pos);
+        }
+
+        state_type *data() const
+        {
+            return this->particle().value().data(this->id());
+        }
+
+        void resize_row(std::size_t n) const
+        {
+            this->particle().value().resize_row(this->id(), n);
+        }
+    }; // class single_particle_type
+
+    /// \brief Construct `N` particles, each with an array of length `dim`
+    explicit StateRagged(size_type N, std::size_t dim = 0)
+        : size_(N)
+        , end_(N * dim)
+        , offset_(N)
+        , dim_(N, dim)
+        , capacity_(N, dim)
+        , data_(N * dim)
+    {
+        for (size_type i = 0; i != N; ++i)
+            offset_[i] = i * dim;
+    }
+
+    size_type size() const { return size_; }
+
+    /// \brief The length of the array of a particle
+    std::size_t dim(size_type id) const { return dim_[id]; }
+
+    /// \brief The number of elements a particle can hold without moving its
+    /// array
+    std::size_t capacity(size_type id) const { return capacity_[id]; }
+
+    /// \brief The number of elements of the arena in use, including those
+    /// left unused by resizing
+    std::size_t arena_size() const { return end_; }
+
+    state_type &state(size_type id, std::size_t pos)
+    {
+        return data_[offset_[id] + pos];
+    }
+
+    const state_type &state(size_type id, std::size_t pos) const
+    {
+        return data_[offset_[id] + pos];
+    }
+
+    /// \brief The array of a particle
+    ///
+    /// \details
+    /// The pointer is invalidated by `resize_row` of any particle beyond its
+    /// capacity, and by `copy` and `compact`.
+    state_type *data(size_type id) { return data_.data() + offset_[id]; }
+
+    const state_type *data(size_type id) const
+    {
+        return data_.data() + offset_[id];
+    }
+
+    /// \brief Change the length of the array of a particle
+    ///
+    /// \details
+    /// The existing values are retained, and the new elements are value
+    /// initialized.
+    void resize_row(size_type id, std::size_t n)
+    {
+        const std::size_t m = dim_[id];
+        if (n > capacity_[id]) {
+            if (end_ + n > data_.size())
+                data_.resize(std::max(end_ + n, 2 * data_.size()));
+            std::copy_n(data_.data() + offset_[id], m, data_.data() + end_);
+            offset_[id] = end_;
+            capacity_[id] = n;
+            end_ += n;
+        }
+        if (n > m)
+            std::fill_n(data_.data() + offset_[id] + m, n - m, state_type());
+        dim_[id] = n;
+    }
+
+    /// \brief Change the lengths of the arrays of all particles
+    ///
+    /// \details
+    /// The arrays are packed into a new arena, with the existing values
+    /// retained and the new elements value initialized.
+    template <typename InputIter,
+        typename = typename std::enable_if<
+            !std::is_integral<InputIter>::value>::type>
+    void resize_rows(InputIter first)
+    {
+        dim_buf_.resize(size_);
+        std::copy_n(first, size_, dim_buf_.begin());
+        repack(static_cast<const size_type *>(nullptr), dim_buf_.data());
+    }
+
+    /// \brief Pack the arrays in the order of the particles, removing unused
+    /// elements from the arena
+    void compact()
+    {
+        repack(static_cast<const size_type *>(nullptr), dim_.data());
+    }
+
+    template <typename IntType>
+    void copy(size_type N, const IntType *index)
+    {
+        VSMC_RUNTIME_ASSERT_CORE_STATE_RAGGED_COPY_SIZE_MISMATCH;
+
+        dim_buf_.resize(size_);
+        for (size_type dst = 0; dst != N; ++dst)
+            dim_buf_[dst] = dim_[static_cast<size_type>(index[dst])];
+        repack(index, dim_buf_.data());
+    }
+
+    void copy_particle(size_type src, size_type dst)
+    {
+        if (src == dst)
+            return;
+
+        const std::size_t n = dim_[src];
+        if (n > capacity_[dst]) {
+            dim_[dst] = 0;
+            resize_row(dst, n);
+        }
+        std::copy_n(data_.data() + offset_[src], n,
+            data_.data() + offset_[dst]);
+        dim_[dst] = n;
+    }
+
+    state_pack_type state_pack(size_type id) const
+    {
+        return state_pack_type(data(id), data(id) + dim_[id]);
+    }
+
+    void state_unpack(size_type id, const state_pack_type &pack)
+    {
+        resize_row(id, pack.size());
+        std::copy(pack.begin(), pack.end(), data(id));
+    }
+
+    void state_unpack(size_type id, state_pack_type &&pack)
+    {
+        resize_row(id, pack.size());
+        std::move(pack.begin(), pack.end(), data(id));
+    }
+
+    template <typename CharT, typename Traits>
+    std::basic_ostream<CharT, Traits> &print(
+        std::basic_ostream<CharT, Traits> &os, char sepchar = '\t') const
+    {
+        if (size_ == 0 || !os.good())
+            return os;
+
+        for (size_type i = 0; i != size_; ++i) {
+            const state_type *x = data(i);
+            for (std::size_t d = 0; d + 1 < dim_[i]; ++d)
+                os << x[d] << sepchar;
+            if (dim_[i] != 0)
+                os << x[dim_[i] - 1];
+            os << '\n';
+        }
+
+        return os;
+    }
+
+    private:
+    size_type size_;
+    std::size_t end_;
+    Vector<std::size_t> offset_;
+    Vector<std::size_t> dim_;
+    Vector<std::size_t> capacity_;
+    internal::StateStorage<T> data_;
+    Vector<std::size_t> offset_buf_;
+    Vector<std::size_t> dim_buf_;
+    internal::StateStorage<T> data_buf_;
+
+    // Pack the array of particle index[i], or i if index is a null pointer,
+    // into the ith segment of length n[i] of a new arena
+    template <typename IntType>
+    void repack(const IntType *index, const std::size_t *n)
+    {
+        offset_buf_.resize(size_);
+        std::size_t end = 0;
+        for (size_type i = 0; i != size_; ++i) {
+            offset_buf_[i] = end;
+            end += n[i];
+        }
+        if (data_buf_.size() < end)
+            data_buf_.resize(std::max(end, 2 * data_buf_.size()));
+
+#if VSMC_USE_TBB
+        ::tbb::parallel_for(::tbb::blocked_range<size_type>(0, size_),
+            [this, index, n](const ::tbb::blocked_range<size_type> &range) {
+                repack_range(index, n, range.begin(), range.end());
+            });
+#else  // VSMC_USE_TBB
+        repack_range(index, n, 0, size_);
+#endif // VSMC_USE_TBB
+
+        offset_.swap(offset_buf_);
+        std::copy_n(n, size_, dim_.data());
+        std::copy_n(n, size_, capacity_.data());
+        data_.swap(data_buf_);
+        end_ = end;
+    }
+
+    template <typename IntType>
+    void repack_range(const IntType *index, const std::size_t *n,
+        size_type first, size_type last)
+    {
+        for (size_type i = first; i != last; ++i) {
+            const size_type src =
+                index == nullptr ? i : static_cast<size_type>(index[i]);
+            const std::size_t m = std::min(n[i], dim_[src]);
+            state_type *const dst = data_buf_.data() + offset_buf_[i];
+            std::copy_n(data_.data() + offset_[src], m, dst);
+            std::fill_n(dst + m, n[i] - m, state_type());
+        }
+    }
+}; // class StateRagged
+
+template <typename CharT, typename Traits, typename T>
+inline std::basic_ostream<CharT, Traits> &operator<<(
+    std::basic_ostream<CharT, Traits> &os, const StateRagged<T> &sragged)
+{
+    return sragged.print(os);
+}
+
+} // namespace vsmc
+
+#endif // VSMC_CORE_STATE_RAGGED_HPP
@@ -0,0 +1,467 @@
+//============================================================================
+// vSMC/include/vsmc/core/state_tuple.hpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c) 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#ifndef VSMC_CORE_STATE_TUPLE_HPP
+#define VSMC_CORE_STATE_TUPLE_HPP
+
+#include <vsmc/internal/common.hpp>
+#include <vsmc/core/single_particle.hpp>
+#include <vsmc/core/state_matrix.hpp>
+
+#define VSMC_RUNTIME_ASSERT_CORE_STATE_TUPLE_COPY_SIZE_MISMATCH               \
+    VSMC_RUNTIME_ASSERT((N == static_cast<size_type>(this->size())),          \
+        "**StateTuple::copy** SIZE MISMATCH")
+
+namespace vsmc
+{
+
+/// \brief Base type of StateTuple
+/// \ingroup Core
+///
+/// \details
+/// The type of the first field, `T`, is a separate template parameter, such
+/// that a state has at least one field. A tuple without fields has no
+/// states to resample or print.
+template <MatrixLayout Layout, typename T, typename... Types>
+class StateTupleBase
+{
+    public:
+    using size_type = std::size_t;
+    using state_tuple_type = std::tuple<T, Types...>;
+    using state_pack_type = std::tuple<T, Types...>;
+
+    /// \brief The type of the `Pos`th field
+    template <std::size_t Pos>
+    using state_type = typename std::tuple_element<Pos, state_tuple_type>::type;
+
+    template <typename S>
+    class single_particle_type : public SingleParticleBase<S>
+    {
+        public:
+        single_particle_type(
+            typename Particle<S>::size_type id, Particle<S> *pptr)
+            : SingleParticleBase<S>(id, pptr)
+        {
+        }
+
+        static constexpr std::size_t dim() { return sizeof...(Types) + 1; }
+
+        template <std::size_t Pos>
+        state_type<Pos> &state() const
+        {
+            return this->particle().value().template state<Pos>(this->id());
+        }
+
+        template <std::size_t Pos>
+        state_type<Pos> &state(std::integral_constant<std::size_t, Pos>) const
+        {
+            return state<Pos>();
+        }
+    }; // class single_particle_type
+
+    /// \brief The number of fields
+    static constexpr std::size_t dim() { return sizeof...(Types) + 1; }
+
+    size_type size() const { return size_; }
+
+    template <std::size_t Pos, typename OutputIter>
+    void read_state(OutputIter first) const
+    {
+        const StateTuple<Layout, T, Types...> *sptr =
+            static_cast<const StateTuple<Layout, T, Types...> *>(this);
+        for (size_type i = 0; i != size_; ++i, ++first)
+            *first = sptr->template state<Pos>(i);
+    }
+
+    template <std::size_t Pos, typename OutputIter>
+    void read_state(
+        std::integral_constant<std::size_t, Pos>, OutputIter first) const
+    {
+        read_state<Pos>(first);
+    }
+
+    template <typename CharT, typename Traits>
+    std::basic_ostream<CharT, Traits> &print(
+        std::basic_ostream<CharT, Traits> &os, char sepchar = '\t') const
+    {
+        if (size_ == 0 || !os.good())
+            return os;
+
+        for (size_type i = 0; i != size_; ++i) {
+            print_particle(os, i, sepchar,
+                std::integral_constant<std::size_t, 0>());
+        }
+
+        return os;
+    }
+
+    protected:
+    explicit StateTupleBase(size_type N) : size_(N) {}
+
+    void swap(StateTupleBase<Layout, T, Types...> &other)
+    {
+        std::swap(size_, other.size_);
+    }
+
+    private:
+    size_type size_;
+
+    template <typename CharT, typename Traits, std::size_t Pos>
+    void print_particle(std::basic_ostream<CharT, Traits> &os, size_type id,
+        char sepchar, std::integral_constant<std::size_t, Pos>) const
+    {
+        const StateTuple<Layout, T, Types...> *sptr =
+            static_cast<const StateTuple<Layout, T, Types...> *>(this);
+        os << sptr->template state<Pos>(id) << sepchar;
+        print_particle(
+            os, id, sepchar, std::integral_constant<std::size_t, Pos + 1>());
+    }
+
+    template <typename CharT, typename Traits>
+    void print_particle(std::basic_ostream<CharT, Traits> &os, size_type id,
+        char, std::integral_constant<std::size_t, dim() - 1>) const
+    {
+        const StateTuple<Layout, T, Types...> *sptr =
+            static_cast<const StateTuple<Layout, T, Types...> *>(this);
+        os << sptr->template state<dim() - 1>(id) << '\n';
+    }
+}; // class StateTupleBase
+
+template <typename CharT, typename Traits, MatrixLayout Layout, typename T,
+    typename... Types>
+inline std::basic_ostream<CharT, Traits> &operator<<(
+    std::basic_ostream<CharT, Traits> &os,
+    const StateTupleBase<Layout, T, Types...> &stuple)
+{
+    return stuple.print(os);
+}
+
+/// \brief Particle::value_type subtype of fields of different types, stored
+/// as an array of structures
+/// \ingroup Core
+///
+/// \details
+/// The fields of each particle are stored together in a `std::tuple`, and the
+/// particles are stored contiguously. Resampling copies one tuple per
+/// particle. Wrap it in StateTBB or StateOMP to copy in parallel.
+template <typename T, typename... Types>
+class StateTuple<RowMajor, T, Types...>
+    : public StateTupleBase<RowMajor, T, Types...>
+{
+    public:
+    using state_tuple_base_type = StateTupleBase<RowMajor, T, Types...>;
+    using size_type = typename state_tuple_base_type::size_type;
+    using state_tuple_type = typename state_tuple_base_type::state_tuple_type;
+    using state_pack_type = typename state_tuple_base_type::state_pack_type;
+
+    template <std::size_t Pos>
+    using state_type =
+        typename state_tuple_base_type::template state_type<Pos>;
+
+    explicit StateTuple(size_type N) : state_tuple_base_type(N), data_(N) {}
+
+    template <std::size_t Pos>
+    state_type<Pos> &state(size_type id)
+    {
+        return std::get<Pos>(data_[id]);
+    }
+
+    template <std::size_t Pos>
+    const state_type<Pos> &state(size_type id) const
+    {
+        return std::get<Pos>(data_[id]);
+    }
+
+    template <std::size_t Pos>
+    state_type<Pos> &state(
+        size_type id, std::integral_constant<std::size_t, Pos>)
+    {
+        return state<Pos>(id);
+    }
+
+    template <std::size_t Pos>
+    const state_type<Pos> &state(
+        size_type id, std::integral_constant<std::size_t, Pos>) const
+    {
+        return state<Pos>(id);
+    }
+
+    /// \brief The tuples of all particles
+    state_tuple_type *data() { return data_.data(); }
+
+    /// \brief The tuples of all particles
+    const state_tuple_type *data() const { return data_.data(); }
+
+    /// \brief The tuple of a given particle
+    state_tuple_type *data(size_type id) { return data_.data() + id; }
+
+    /// \brief The tuple of a given particle
+    const state_tuple_type *data(size_type id) const
+    {
+        return data_.data() + id;
+    }
+
+    void swap(StateTuple<RowMajor, T, Types...> &other)
+    {
+        state_tuple_base_type::swap(other);
+        data_.swap(other.data_);
+    }
+
+    template <typename IntType>
+    void copy(size_type N, const IntType *index)
+    {
+        VSMC_RUNTIME_ASSERT_CORE_STATE_TUPLE_COPY_SIZE_MISMATCH;
+
+        for (size_type dst = 0; dst != N; ++dst)
+            copy_particle(static_cast<size_type>(index[dst]), dst);
+    }
+
+    void copy_particle(size_type src, size_type dst)
+    {
+        if (src != dst)
+            data_[dst] = data_[src];
+    }
+
+    state_pack_type state_pack(size_type id) const { return data_[id]; }
+
+    void state_unpack(size_type id, const state_pack_type &pack)
+    {
+        data_[id] = pack;
+    }
+
+    void state_unpack(size_type id, state_pack_type &&pack)
+    {
+        data_[id] = std::move(pack);
+    }
+
+    private:
+    Vector<state_tuple_type> data_;
+}; // class StateTuple
+
+/// \brief Particle::value_type subtype of fields of different types, stored
+/// as a structure of arrays
+/// \ingroup Core
+///
+/// \details
+/// Each field is stored in its own column, aligned to
+/// `VSMC_STATE_MATRIX_ALIGNMENT` bytes for scalar types, such that a kernel
+/// can access one field of all particles with vector loads. Resampling
+/// copies each column in turn. Wrap it in StateTBB or StateOMP to copy the
+/// particles in parallel.
+template <typename T, typename... Types>
+class StateTuple<ColMajor, T, Types...>
+    : public StateTupleBase<ColMajor, T, Types...>
+{
+    public:
+    using state_tuple_base_type = StateTupleBase<ColMajor, T, Types...>;
+    using size_type = typename state_tuple_base_type::size_type;
+    using state_tuple_type = typename state_tuple_base_type::state_tuple_type;
+    using state_pack_type = typename state_tuple_base_type::state_pack_type;
+
+    template <std::size_t Pos>
+    using state_type =
+        typename state_tuple_base_type::template state_type<Pos>;
+
+    explicit StateTuple(size_type N) : state_tuple_base_type(N)
+    {
+        resize_data(N, std::integral_constant<std::size_t, 0>());
+    }
+
+    template <std::size_t Pos>
+    state_type<Pos> &state(size_type id)
+    {
+        return std::get<Pos>(data_)[id];
+    }
+
+    template <std::size_t Pos>
+    const state_type<Pos> &state(size_type id) const
+    {
+        return std::get<Pos>(data_)[id];
+    }
+
+    template <std::size_t Pos>
+    state_type<Pos> &state(
+        size_type id, std::integral_constant<std::size_t, Pos>)
+    {
+        return state<Pos>(id);
+    }
+
+    template <std::size_t Pos>
+    const state_type<Pos> &state(
+        size_type id, std::integral_constant<std::size_t, Pos>) const
+    {
+        return state<Pos>(id);
+    }
+
+    /// \brief The column of the `Pos`th field
+    template <std::size_t Pos>
+    state_type<Pos> *data()
+    {
+        return std::get<Pos>(data_).data();
+    }
+
+    /// \brief The column of the `Pos`th field
+    template <std::size_t Pos>
+    const state_type<Pos> *data() const
+    {
+        return std::get<Pos>(data_).data();
+    }
+
+    template <std::size_t Pos>
+    state_type<Pos> *data(std::integral_constant<std::size_t, Pos>)
+    {
+        return data<Pos>();
+    }
+
+    template <std::size_t Pos>
+    const state_type<Pos> *data(std::integral_constant<std::size_t, Pos>) const
+    {
+        return data<Pos>();
+    }
+
+    void swap(StateTuple<ColMajor, T, Types...> &other)
+    {
+        state_tuple_base_type::swap(other);
+        data_.swap(other.data_);
+    }
+
+    template <typename IntType>
+    void copy(size_type N, const IntType *index)
+    {
+        VSMC_RUNTIME_ASSERT_CORE_STATE_TUPLE_COPY_SIZE_MISMATCH;
+
+        copy_column(N, index, std::integral_constant<std::size_t, 0>());
+    }
+
+    void copy_particle(size_type src, size_type dst)
+    {
+        if (src != dst) {
+            copy_particle_pos(
+                src, dst, std::integral_constant<std::size_t, 0>());
+        }
+    }
+
+    state_pack_type state_pack(size_type id) const
+    {
+        state_pack_type pack;
+        pack_pos(id, pack, std::integral_constant<std::size_t, 0>());
+
+        return pack;
+    }
+
+    void state_unpack(size_type id, const state_pack_type &pack)
+    {
+        unpack_pos(id, pack, std::integral_constant<std::size_t, 0>());
+    }
+
+    void state_unpack(size_type id, state_pack_type &&pack)
+    {
+        unpack_pos(
+            id, std::move(pack), std::integral_constant<std::size_t, 0>());
+    }
+
+    private:
+    static constexpr std::size_t dim_ = sizeof...(Types) + 1;
+
+    std::tuple<internal::StateStorage<T>, internal::StateStorage<Types>...>
+        data_;
+
+    void resize_data(size_type, std::integral_constant<std::size_t, dim_>) {}
+
+    template <std::size_t Pos>
+    void resize_data(size_type N, std::integral_constant<std::size_t, Pos>)
+    {
+        std::get<Pos>(data_).resize(N);
+        resize_data(N, std::integral_constant<std::size_t, Pos + 1>());
+    }
+
+    template <typename IntType>
+    void copy_column(
+        size_type, const IntType *, std::integral_constant<std::size_t, dim_>)
+    {
+    }
+
+    template <typename IntType, std::size_t Pos>
+    void copy_column(size_type N, const IntType *index,
+        std::integral_constant<std::size_t, Pos>)
+    {
+        state_type<Pos> *const col = data<Pos>();
+        for (size_type dst = 0; dst != N; ++dst)
+            col[dst] = col[static_cast<size_type>(index[dst])];
+        copy_column(N, index, std::integral_constant<std::size_t, Pos + 1>());
+    }
+
+    void copy_particle_pos(
+        size_type, size_type, std::integral_constant<std::size_t, dim_>)
+    {
+    }
+
+    template <std::size_t Pos>
+    void copy_particle_pos(
+        size_type src, size_type dst, std::integral_constant<std::size_t, Pos>)
+    {
+        state<Pos>(dst) = state<Pos>(src);
+        copy_particle_pos(
+            src, dst, std::integral_constant<std::size_t, Pos + 1>());
+    }
+
+    void pack_pos(size_type, state_pack_type &,
+        std::integral_constant<std::size_t, dim_>) const
+    {
+    }
+
+    template <std::size_t Pos>
+    void pack_pos(size_type id, state_pack_type &pack,
+        std::integral_constant<std::size_t, Pos>) const
+    {
+        std::get<Pos>(pack) = state<Pos>(id);
+        pack_pos(id, pack, std::integral_constant<std::size_t, Pos + 1>());
+    }
+
+    template <typename Pack>
+    void unpack_pos(
+        size_type, Pack &&, std::integral_constant<std::size_t, dim_>)
+    {
+    }
+
+    template <typename Pack, std::size_t Pos>
+    void unpack_pos(size_type id, Pack &&pack,
+        std::integral_constant<std::size_t, Pos>)
+    {
+        state<Pos>(id) = std::get<Pos>(std::forward<Pack>(pack));
+        unpack_pos(id, std::forward<Pack>(pack),
+            std::integral_constant<std::size_t, Pos + 1>());
+    }
+}; // class StateTuple
+
+} // namespace vsmc
+
+#endif // VSMC_CORE_STATE_TUPLE_HPP
@@ -0,0 +1,234 @@
+//============================================================================
+// vSMC/include/vsmc/core/tempering.hpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c) 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#ifndef VSMC_CORE_TEMPERING_HPP
+#define VSMC_CORE_TEMPERING_HPP
+
+#include <vsmc/internal/common.hpp>
+#include <vsmc/core/monitor.hpp>
+#include <vsmc/core/particle.hpp>
+
+#define VSMC_RUNTIME_ASSERT_CORE_TEMPERING_CESS(cess)                         \
+    VSMC_RUNTIME_ASSERT((cess > 0 && cess < 1),                               \
+        "**TemperingAdaptive** CONSTRUCTED WITH INVALID CESS TARGET")
+
+#define VSMC_RUNTIME_ASSERT_CORE_TEMPERING_EVAL                               \
+    VSMC_RUNTIME_ASSERT(static_cast<bool>(state_->eval),                      \
+        "**TemperingAdaptive** INVALID EVALUATION OBJECT")
+
+namespace vsmc
+{
+
+namespace internal
+{
+
+// The conditional ESS, divided by N, of the incremental weights
+// exp(delta * ll), given the normalized weights w and llmax, the maximum of
+// ll over the particles with positive weights
+template <typename RealType>
+inline double tempering_cess(std::size_t N, const RealType *w,
+    const double *ll, double llmax, double delta, double *buf)
+{
+    vmath::eval(N, buf, vmath::exp(delta * (vmath::arg(ll) - llmax)));
+    double s1 = 0;
+    double s2 = 0;
+    for (std::size_t i = 0; i != N; ++i) {
+        double v = w[i] * buf[i];
+        s1 += v;
+        s2 += v * buf[i];
+    }
+
+    return s2 > 0 ? s1 * s1 / s2 : 0;
+}
+
+} // namespace vsmc::internal
+
+/// \brief Adaptive tempering move
+/// \ingroup Core
+///
+/// \details
+/// The target distribution of the \f$t\f$th iteration is
+/// \f$\pi_t(x) \propto \pi_0(x)\ell(x)^{\alpha_t}\f$. Each call chooses the
+/// next exponent \f$\alpha_t\f$ by bisection, such that the conditional ESS,
+/// \f[
+///   \mathrm{CESS} =
+///     \frac{N(\sum_{i=1}^N W_i w_i)^2}{\sum_{i=1}^N W_i w_i^2},
+///   \quad w_i = \ell(X_i)^{\alpha_t - \alpha_{t-1}},
+/// \f]
+/// is a fraction `cess()` of the sample size, where \f$W_i\f$ are the
+/// current normalized weights. The candidate weights are computed from the
+/// values of \f$\log\ell(X_i)\f$ written by the evaluation object once per
+/// call, which is expected to return values cached by the state. It then
+/// calls the alpha setter with the new exponent, and multiplies the weights
+/// by \f$w_i\f$.
+///
+/// All copies of a TemperingAdaptive object share the same schedule, such
+/// that the object added to a Sampler as a move can be queried by the
+/// caller, e.g.,
+/// ~~~{.cpp}
+/// TemperingAdaptive<T> tempering(eval, alpha_setter);
+/// sampler.move(tempering, false).monitor("tempering", tempering.monitor());
+/// sampler.initialize();
+/// while (tempering.alpha() < 1)
+///     sampler.iterate();
+/// ~~~
+/// The Monitor returned by `monitor()` records the exponent of each
+/// iteration in the Sampler history.
+template <typename T>
+class TemperingAdaptive
+{
+    public:
+    using value_type = T;
+
+    /// \brief Write the values of \f$\log\ell(X_i)\f$ to the last argument
+    using eval_type = std::function<void(std::size_t, Particle<T> &, double *)>;
+
+    /// \brief Set the new exponent, the second argument, on the state
+    using alpha_setter_type =
+        std::function<void(std::size_t, double, Particle<T> &)>;
+
+    /// \brief Construct an adaptive tempering move
+    ///
+    /// \param eval The evaluation object of the log-likelihoods
+    /// \param alpha_setter The alpha setter. It can be empty.
+    /// \param cess The target CESS as a fraction of the sample size
+    /// \param alpha The initial exponent
+    explicit TemperingAdaptive(const eval_type &eval,
+        const alpha_setter_type &alpha_setter = alpha_setter_type(),
+        double cess = 0.9, double alpha = 0)
+        : state_(std::make_shared<state_type>())
+    {
+        VSMC_RUNTIME_ASSERT_CORE_TEMPERING_CESS(cess);
+
+        state_->eval = eval;
+        state_->alpha_setter = alpha_setter;
+        state_->cess = cess;
+        state_->alpha = alpha;
+        state_->alpha_inc = 0;
+    }
+
+    /// \brief The target CESS as a fraction of the sample size
+    double cess() const { return state_->cess; }
+
+    /// \brief The current exponent
+    double alpha() const { return state_->alpha; }
+
+    /// \brief The difference between the current and the previous exponents
+    double alpha_inc() const { return state_->alpha_inc; }
+
+    /// \brief Restart the schedule
+    void reset(double alpha = 0)
+    {
+        state_->alpha = alpha;
+        state_->alpha_inc = 0;
+    }
+
+    /// \brief A record only Monitor of the exponent
+    Monitor<T> monitor() const
+    {
+        std::shared_ptr<state_type> state(state_);
+        Monitor<T> mon(1,
+            [state](std::size_t, std::size_t, Particle<T> &,
+                typename Monitor<T>::result_type *r) {
+                *r = state->alpha;
+            },
+            true, MonitorMove);
+        mon.name(0) = "Alpha";
+
+        return mon;
+    }
+
+    std::size_t operator()(std::size_t iter, Particle<T> &particle)
+    {
+        VSMC_RUNTIME_ASSERT_CORE_TEMPERING_EVAL;
+
+        const std::size_t N = static_cast<std::size_t>(particle.size());
+        state_->ll.resize(N);
+        state_->buf.resize(N);
+        double *const ll = state_->ll.data();
+        double *const buf = state_->buf.data();
+        const typename Particle<T>::weight_value_type *const w =
+            particle.weight().data();
+        state_->eval(iter, particle, ll);
+
+        double llmax = -std::numeric_limits<double>::infinity();
+        for (std::size_t i = 0; i != N; ++i)
+            if (w[i] > 0 && ll[i] > llmax)
+                llmax = ll[i];
+
+        const double alpha = state_->alpha;
+        double delta = 1 - alpha;
+        if (delta > 0 && std::isfinite(llmax) &&
+            internal::tempering_cess(N, w, ll, llmax, delta, buf) <
+                state_->cess) {
+            double lo = 0;
+            double hi = delta;
+            for (std::size_t k = 0; k != 100 && hi - lo > 1e-6 * hi; ++k) {
+                double mid = 0.5 * (lo + hi);
+                if (internal::tempering_cess(N, w, ll, llmax, mid, buf) <
+                    state_->cess) {
+                    hi = mid;
+                } else {
+                    lo = mid;
+                }
+            }
+            delta = lo > 0 ? lo : hi;
+        }
+        state_->alpha = delta < 1 - alpha ? alpha + delta : 1;
+        state_->alpha_inc = delta;
+
+        if (state_->alpha_setter)
+            state_->alpha_setter(iter, state_->alpha, particle);
+        if (delta > 0) {
+            vmath::eval(N, buf, delta * vmath::arg(ll));
+            particle.weight().add_log(buf);
+        }
+
+        return 0;
+    }
+
+    private:
+    struct state_type {
+        eval_type eval;
+        alpha_setter_type alpha_setter;
+        double cess;
+        double alpha;
+        double alpha_inc;
+        Vector<double> ll;
+        Vector<double> buf;
+    };
+
+    std::shared_ptr<state_type> state_;
+}; // class TemperingAdaptive
+
+} // namespace vsmc
+
+#endif // VSMC_CORE_TEMPERING_HPP
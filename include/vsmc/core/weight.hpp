@@ -35,9 +35,32 @@
 #include <vsmc/internal/common.hpp>
 #include <vsmc/rng/discrete_distribution.hpp>
 
+/// \brief The memory management class of the weights of WeightVector
+/// \ingroup Config
+///
+/// \details
+/// For example, `::vsmc::AlignedMemoryFile` maps the weights and the
+/// logarithm weights from temporary files, see also
+/// `VSMC_STATE_MATRIX_MEMORY_TYPE`
+#ifndef VSMC_WEIGHT_MEMORY_TYPE
+#define VSMC_WEIGHT_MEMORY_TYPE ::vsmc::AlignedMemory
+#endif
+
 namespace vsmc
 {
 
+/// \brief Compute the ess given normalized weights
+/// \ingroup Core
+///
+/// \details
+/// The sum of squares is accumulated in double precision for both `float`
+/// and `double` weights.
+inline double weight_ess(std::size_t N, const float *first)
+{
+    return 1 /
+        ::cblas_dsdot(static_cast<VSMC_CBLAS_INT>(N), first, 1, first, 1);
+}
+
 /// \brief Compute the ess given normalized weights
 /// \ingroup Core
 inline double weight_ess(std::size_t N, const double *first)
@@ -48,38 +71,124 @@ inline double weight_ess(std::size_t N, const double *first)
 
 /// \brief Normalize weights such that the summation is one
 /// \ingroup Core
-inline void weight_normalize(std::size_t N, double *first)
+template <typename RealType>
+inline void weight_normalize(std::size_t N, RealType *first)
 {
-    mul(N, 1 / std::accumulate(first, first + N, 0.0), first, first);
+    mul(N, static_cast<RealType>(1 / std::accumulate(first, first + N, 0.0)),
+        first, first);
 }
 
 /// \brief Normalize logarithm weights such that the maximum is zero
 /// \ingroup Core
-inline void weight_normalize_log(std::size_t N, double *first)
+template <typename RealType>
+inline void weight_normalize_log(std::size_t N, RealType *first)
 {
-    double wmax = *(std::max_element(first, first + N));
+    RealType wmax = *(std::max_element(first, first + N));
     for (std::size_t i = 0; i != N; ++i)
         first[i] -= wmax;
 }
 
 /// \brief Weight class
 /// \ingroup Core
-class Weight
+///
+/// \details
+/// The weights are stored as `RealType`, either `float` or `double`. Sums
+/// and the ESS are always accumulated in double precision. Logarithm
+/// weights given in a type of higher precision than `RealType`, e.g.,
+/// `double` increments to `add_log` with `float` weights, are combined and
+/// normalized in double precision before they are stored.
+template <typename RealType>
+class WeightVector
 {
     public:
     using size_type = std::size_t;
+    using value_type = RealType;
+
+    explicit WeightVector(size_type N)
+        : ess_(0), data_(N, 0), alias_valid_(false)
+    {
+    }
 
-    explicit Weight(size_type N) : ess_(0), data_(N) {}
+    /// \brief Construct `N` zero weights, each range of which, as
+    /// partitioned by the first touch policy, is initialized by the thread
+    /// that will process it
+    WeightVector(size_type N, FirstTouch touch)
+        : ess_(0), data_(N), alias_valid_(false)
+    {
+        value_type *const w = data_.data();
+        internal::first_touch(N, touch, [w](std::size_t i, std::size_t j) {
+            std::fill(w + i, w + j, static_cast<value_type>(0));
+        });
+    }
+
+    WeightVector(const WeightVector<RealType> &other)
+        : ess_(other.ess_), data_(other.data_), alias_valid_(false)
+    {
+    }
+
+    WeightVector(WeightVector<RealType> &&other)
+        : ess_(other.ess_), data_(std::move(other.data_)), alias_valid_(false)
+    {
+    }
+
+    WeightVector<RealType> &operator=(const WeightVector<RealType> &other)
+    {
+        if (this != &other) {
+            ess_ = other.ess_;
+            data_ = other.data_;
+            alias_valid_ = false;
+        }
+
+        return *this;
+    }
+
+    WeightVector<RealType> &operator=(WeightVector<RealType> &&other)
+    {
+        if (this != &other) {
+            ess_ = other.ess_;
+            data_ = std::move(other.data_);
+            alias_valid_ = false;
+        }
+
+        return *this;
+    }
 
     size_type size() const { return data_.size(); }
 
     size_type resample_size() const { return size(); }
 
+    /// \brief Change the number of weights
+    ///
+    /// \details
+    /// The weights of the first `min(N, size())` particles are retained and
+    /// those of the new particles are zero, and the weights are normalized
+    /// again. If there was no weight, or all the retained weights are zero,
+    /// the new weights are equal. The capacity grows geometrically, such that
+    /// a sequence of resizes is amortized.
+    void resize(size_type N)
+    {
+        if (N == size())
+            return;
+
+        const size_type K = std::min(N, size());
+        internal::reserve_geometric(data_, N);
+        data_.resize(N, 0);
+        if (N == 0) {
+            alias_valid_ = false;
+            ess_ = 0;
+        } else if (std::accumulate(data_.begin(), data_.begin() + K,
+                       static_cast<value_type>(0)) == 0) {
+            set_equal();
+        } else {
+            post_set();
+        }
+    }
+
     double ess() const { return ess_; }
 
-    const double *data() const { return data_.data(); }
+    const value_type *data() const { return data_.data(); }
 
-    const double *resample_data() const { return data_.data(); }
+    const value_type *resample_data() const { return data_.data(); }
 
     template <typename OutputIter>
     void read_weight(OutputIter first) const
@@ -94,11 +203,12 @@ class Weight
             *first = data_[i];
     }
 
-    void read_resample_weight(double *first) const { read_weight(first); }
+    void read_resample_weight(value_type *first) const { read_weight(first); }
 
     void set_equal()
     {
-        std::fill(data_.begin(), data_.end(), 1.0 / resample_size());
+        std::fill(data_.begin(), data_.end(),
+            static_cast<value_type>(1.0 / resample_size()));
         post_set();
     }
 
@@ -125,13 +235,13 @@ class Weight
         post_set();
     }
 
-    void mul(const double *first)
+    void mul(const value_type *first)
     {
         ::vsmc::mul(size(), first, data_.data(), data_.data());
         post_set();
     }
 
-    void mul(double *first) { mul(const_cast<const double *>(first)); }
+    void mul(value_type *first) { mul(const_cast<const value_type *>(first)); }
 
     template <typename RandomIter>
     void mul(RandomIter first, int stride)
@@ -144,70 +254,165 @@ class Weight
     template <typename InputIter>
     void set_log(InputIter first)
     {
-        std::copy_n(first, size(), data_.begin());
-        post_set_log();
+        if (use_log_buffer<InputIter>()) {
+            lw_.resize(size());
+            std::copy_n(first, size(), lw_.begin());
+            post_set_log_buffer();
+        } else {
+            std::copy_n(first, size(), data_.begin());
+            post_set_log();
+        }
     }
 
     template <typename RandomIter>
     void set_log(RandomIter first, int stride)
     {
-        for (size_type i = 0; i != size(); ++i, first += stride)
-            data_[i] = *first;
-        post_set_log();
+        if (use_log_buffer<RandomIter>()) {
+            lw_.resize(size());
+            for (size_type i = 0; i != size(); ++i, first += stride)
+                lw_[i] = *first;
+            post_set_log_buffer();
+        } else {
+            for (size_type i = 0; i != size(); ++i, first += stride)
+                data_[i] = static_cast<value_type>(*first);
+            post_set_log();
+        }
     }
 
     template <typename InputIter>
     void add_log(InputIter first)
     {
-        log(size(), data_.data(), data_.data());
-        for (size_type i = 0; i != size(); ++i, ++first)
-            data_[i] += *first;
-        post_set_log();
+        if (use_log_buffer<InputIter>()) {
+            lw_.resize(size());
+            std::copy(data_.begin(), data_.end(), lw_.begin());
+            log(size(), lw_.data(), lw_.data());
+            for (size_type i = 0; i != size(); ++i, ++first)
+                lw_[i] += *first;
+            post_set_log_buffer();
+        } else {
+            log(size(), data_.data(), data_.data());
+            for (size_type i = 0; i != size(); ++i, ++first)
+                data_[i] += *first;
+            post_set_log();
+        }
     }
 
-    void add_log(const double *first)
+    void add_log(const value_type *first)
     {
-        log(size(), data_.data(), data_.data());
-        add(size(), data_.data(), first, data_.data());
+        vmath::eval(size(), data_.data(),
+            vmath::log(vmath::arg(data_.data())) + vmath::arg(first));
         post_set_log();
     }
 
-    void add_log(double *first) { add_log(const_cast<const double *>(first)); }
+    void add_log(value_type *first)
+    {
+        add_log(const_cast<const value_type *>(first));
+    }
 
     template <typename RandomIter>
     void add_log(RandomIter first, int stride)
     {
-        log(size(), data_.data(), data_.data());
-        for (size_type i = 0; i != size(); ++i, first += stride)
-            data_[i] += *first;
-        post_set_log();
+        if (use_log_buffer<RandomIter>()) {
+            lw_.resize(size());
+            std::copy(data_.begin(), data_.end(), lw_.begin());
+            log(size(), lw_.data(), lw_.data());
+            for (size_type i = 0; i != size(); ++i, first += stride)
+                lw_[i] += *first;
+            post_set_log_buffer();
+        } else {
+            log(size(), data_.data(), data_.data());
+            for (size_type i = 0; i != size(); ++i, first += stride)
+                data_[i] += *first;
+            post_set_log();
+        }
     }
 
+    /// \brief Draw an index according to the weights
+    ///
+    /// \details
+    /// A Walker alias table is constructed, at the cost of \f$O(N)\f$, by the
+    /// first call after the weights are changed. Each draw then costs
+    /// \f$O(1)\f$. It is safe to call this function concurrently.
     template <typename URNG>
     size_type draw(URNG &eng) const
     {
-        return draw_(eng, data_.begin(), data_.end(), true);
+        if (size() == 0)
+            return 0;
+
+        if (!alias_valid_.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(alias_mutex_);
+            if (!alias_valid_.load(std::memory_order_relaxed)) {
+                alias_prob_.resize(size());
+                alias_index_.resize(size());
+                internal::discrete_alias_table(size(), data_.data(),
+                    alias_prob_.data(), alias_index_.data());
+                alias_valid_.store(true, std::memory_order_release);
+            }
+        }
+
+        return internal::discrete_alias_draw<size_type>(
+            eng, size(), alias_prob_.data(), alias_index_.data());
     }
 
     protected:
-    double *mutable_data() { return data_.data(); }
+    value_type *mutable_data()
+    {
+        alias_valid_ = false;
+
+        return data_.data();
+    }
 
     private:
     double ess_;
-    Vector<double> data_;
-    DiscreteDistribution<size_type> draw_;
-
-    void post_set() { ess_ = normalize(false); }
+    std::vector<value_type,
+        internal::DefaultInitAllocator<AlignedAllocator<value_type,
+            VSMC_ALIGNMENT, VSMC_WEIGHT_MEMORY_TYPE>>>
+        data_;
+    std::vector<double,
+        AlignedAllocator<double, VSMC_ALIGNMENT, VSMC_WEIGHT_MEMORY_TYPE>>
+        lw_;
+    mutable Vector<double> alias_prob_;
+    mutable Vector<size_type> alias_index_;
+    mutable std::atomic<bool> alias_valid_;
+    mutable std::mutex alias_mutex_;
+
+    void post_set()
+    {
+        alias_valid_ = false;
+        ess_ = normalize(false);
+    }
 
     void post_set_log()
     {
+        alias_valid_ = false;
         weight_normalize_log(size(), data_.data());
         ess_ = normalize(true);
     }
 
+    // Logarithm weights of higher precision than value_type are normalized
+    // in the double precision buffer lw_
+    template <typename Iter>
+    static constexpr bool use_log_buffer()
+    {
+        return !std::is_same<value_type, double>::value &&
+            std::is_floating_point<
+                typename std::iterator_traits<Iter>::value_type>::value &&
+            (sizeof(typename std::iterator_traits<Iter>::value_type) >
+                   sizeof(value_type));
+    }
+
+    void post_set_log_buffer()
+    {
+        alias_valid_ = false;
+        weight_normalize_log(size(), lw_.data());
+        exp(size(), lw_.data(), lw_.data());
+        std::copy(lw_.begin(), lw_.end(), data_.begin());
+        ess_ = normalize(false);
+    }
+
     double normalize(bool use_log)
     {
-        double *w = data_.data();
+        value_type *w = data_.data();
         double accw = 0;
         const std::size_t k = 1024;
         const std::size_t m = size() / k;
@@ -215,19 +420,24 @@ class Weight
         for (std::size_t i = 0; i != m; ++i, w += k)
             normalize_eval(k, w, accw, use_log);
         normalize_eval(l, w, accw, use_log);
-        ::vsmc::mul(size(), 1 / accw, data_.data(), data_.data());
+        ::vsmc::mul(size(), static_cast<value_type>(1 / accw), data_.data(),
+            data_.data());
 
-        return 1 / cblas_ddot(static_cast<VSMC_CBLAS_INT>(size()),
-                       data_.data(), 1, data_.data(), 1);
+        return weight_ess(size(), data_.data());
     }
 
-    void normalize_eval(std::size_t n, double *w, double &accw, bool use_log)
+    void normalize_eval(
+        std::size_t n, value_type *w, double &accw, bool use_log)
     {
         if (use_log)
             exp(n, w, w);
         accw = std::accumulate(w, w + n, accw);
     }
-}; // class Weight
+}; // class WeightVector
+
+/// \brief Weight class of double precision
+/// \ingroup Core
+using Weight = WeightVector<double>;
 
 /// \brief An empty weight set class
 /// \ingroup Core
@@ -242,6 +452,7 @@ class WeightNull
 {
     public:
     using size_type = std::size_t;
+    using value_type = double;
 
     explicit WeightNull(size_type) {}
 
@@ -249,6 +460,8 @@ class WeightNull
 
     size_type resample_size() const { return 0; }
 
+    void resize(size_type) {}
+
     double ess() const { return std::numeric_limits<double>::quiet_NaN(); }
 
     const double *resample_data() const { return nullptr; }
@@ -320,6 +533,11 @@ class WeightNull
 /// \ingroup Traits
 VSMC_DEFINE_TYPE_DISPATCH_TRAIT(WeightType, weight_type, Weight)
 
+/// \brief Type of the weights of a weight class, `double` unless it
+/// defines `value_type`
+/// \ingroup Traits
+VSMC_DEFINE_TYPE_DISPATCH_TRAIT(WeightValueType, value_type, double)
+
 } // namespace vsmc
 
 #endif // VSMC_CORE_WEIGHT_HPP
@@ -75,12 +75,33 @@
 #include <utility>
 #include <vector>
 
+#if VSMC_HAS_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace vsmc
 {
 
 namespace internal
 {
 
+#if VSMC_HAS_TBB
+// The partitioner of the default loops of the TBB backend and of the TBB
+// first touch policy. The static partitioner maps the same ranges to the same
+// threads on every call, and thus keeps the NUMA locality of first touch
+#if TBB_INTERFACE_VERSION >= 9100
+using TBBStaticPartitioner = ::tbb::static_partitioner;
+#else
+using TBBStaticPartitioner = ::tbb::auto_partitioner;
+#endif
+#endif // VSMC_HAS_TBB
+
 #ifdef VSMC_CLANG
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wfloat-equal"
@@ -139,12 +160,123 @@ inline void resize(std::array<T, N> &, std::size_t)
 {
 }
 
-template <typename T>
-inline void resize(Vector<T> &vec, std::size_t n)
+template <typename T, typename Alloc>
+inline void resize(std::vector<T, Alloc> &vec, std::size_t n)
 {
     vec.resize(n);
 }
 
+// Allocator adaptor which default initializes elements constructed without
+// arguments, such that those of scalar types are left uninitialized, and
+// their memory untouched until first written
+template <typename Alloc>
+class DefaultInitAllocator : public Alloc
+{
+    using traits = std::allocator_traits<Alloc>;
+
+    public:
+    template <typename U>
+    class rebind
+    {
+        public:
+        using other =
+            DefaultInitAllocator<typename traits::template rebind_alloc<U>>;
+    }; // class rebind
+
+    DefaultInitAllocator() = default;
+
+    template <typename U>
+    DefaultInitAllocator(const DefaultInitAllocator<U> &other)
+        : Alloc(static_cast<const U &>(other))
+    {
+    }
+
+    template <typename U>
+    void construct(U *ptr)
+    {
+        ::new (static_cast<void *>(ptr)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U *ptr, Args &&... args)
+    {
+        traits::construct(static_cast<Alloc &>(*this), ptr,
+            std::forward<Args>(args)...);
+    }
+}; // class DefaultInitAllocator
+
+template <typename Alloc1, typename Alloc2>
+inline bool operator==(const DefaultInitAllocator<Alloc1> &alloc1,
+    const DefaultInitAllocator<Alloc2> &alloc2)
+{
+    return static_cast<const Alloc1 &>(alloc1) ==
+        static_cast<const Alloc2 &>(alloc2);
+}
+
+template <typename Alloc1, typename Alloc2>
+inline bool operator!=(const DefaultInitAllocator<Alloc1> &alloc1,
+    const DefaultInitAllocator<Alloc2> &alloc2)
+{
+    return !(alloc1 == alloc2);
+}
+
+// Call f(first, last) for each range of the particles [0, N) as partitioned
+// by the backend of the first touch policy, in parallel. The TBB policy uses
+// the static partitioner, as do the default loops of the TBB backend, and the
+// OpenMP policy splits the particles evenly, as does the OpenMP backend. The
+// OpenMP policy is
+// available whenever the translation unit is compiled with OpenMP enabled,
+// regardless of VSMC_HAS_OMP. Requesting a policy whose backend is not
+// available is a runtime assertion failure
+template <typename F>
+inline void first_touch(std::size_t N, FirstTouch touch, F &&f)
+{
+    if (touch == FirstTouchSEQ || N == 0) {
+        f(static_cast<std::size_t>(0), N);
+        return;
+    }
+
+#if VSMC_HAS_TBB
+    if (touch == FirstTouchTBB) {
+        ::tbb::parallel_for(::tbb::blocked_range<std::size_t>(0, N),
+            [&f](const ::tbb::blocked_range<std::size_t> &range) {
+                f(range.begin(), range.end());
+            },
+            TBBStaticPartitioner());
+        return;
+    }
+#endif // VSMC_HAS_TBB
+
+#ifdef _OPENMP
+    if (touch == FirstTouchOMP) {
+#pragma omp parallel default(shared)
+        {
+            const std::size_t np =
+                static_cast<std::size_t>(::omp_get_num_threads());
+            const std::size_t id =
+                static_cast<std::size_t>(::omp_get_thread_num());
+            f(N * id / np, N * (id + 1) / np);
+        }
+        return;
+    }
+#endif // _OPENMP
+
+    VSMC_RUNTIME_ASSERT(false,
+        "**first_touch** POLICY NOT AVAILABLE IN THIS BUILD, "
+        "FirstTouchTBB REQUIRES VSMC_HAS_TBB AND FirstTouchOMP REQUIRES "
+        "OpenMP");
+    f(static_cast<std::size_t>(0), N);
+}
+
+// Reserve at least n elements, growing the capacity geometrically such that
+// a sequence of resizes is amortized
+template <typename T, typename Alloc>
+inline void reserve_geometric(std::vector<T, Alloc> &vec, std::size_t n)
+{
+    if (n > vec.capacity())
+        vec.reserve(std::max(n, 2 * vec.capacity()));
+}
+
 } // namespace vsmc::internal
 
 template <typename CharT, typename Traits, typename T, std::size_t N>
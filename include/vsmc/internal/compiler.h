@@ -127,6 +127,14 @@
 #define VSMC_HAS_AVX2 0
 #endif
 
+#ifndef VSMC_HAS_FMA
+#define VSMC_HAS_FMA 0
+#endif
+
+#ifndef VSMC_HAS_AVX512
+#define VSMC_HAS_AVX512 0
+#endif
+
 #ifndef VSMC_HAS_AES_NI
 #define VSMC_HAS_AES_NI 0
 #endif
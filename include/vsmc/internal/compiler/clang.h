@@ -62,6 +62,18 @@
 #endif
 #endif
 
+#ifdef __FMA__
+#ifndef VSMC_HAS_FMA
+#define VSMC_HAS_FMA 1
+#endif
+#endif
+
+#ifdef __AVX512F__
+#ifndef VSMC_HAS_AVX512
+#define VSMC_HAS_AVX512 1
+#endif
+#endif
+
 #ifdef __AES__
 #ifndef VSMC_HAS_AES_NI
 #define VSMC_HAS_AES_NI 1
@@ -52,4 +52,16 @@
 #endif
 #endif
 
+#ifdef __AVX2__
+#ifndef VSMC_HAS_FMA
+#define VSMC_HAS_FMA 1
+#endif
+#endif
+
+#ifdef __AVX512F__
+#ifndef VSMC_HAS_AVX512
+#define VSMC_HAS_AVX512 1
+#endif
+#endif
+
 #endif // VSMC_INTERNAL_COMPILER_MSVC_H
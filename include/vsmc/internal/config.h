@@ -118,6 +118,10 @@
 #define VSMC_HAS_MKL 0
 #endif
 
+#ifndef VSMC_HAS_NUMA
+#define VSMC_HAS_NUMA 0
+#endif
+
 #ifndef VSMC_USE_MKL_CBLAS
 #define VSMC_USE_MKL_CBLAS VSMC_HAS_MKL
 #endif
@@ -134,4 +138,14 @@
 #define VSMC_USE_MKL_VSL VSMC_HAS_MKL
 #endif
 
+// Built-in vectorized math functions
+
+#ifndef VSMC_USE_SIMD_VMATH
+#if VSMC_USE_MKL_VML
+#define VSMC_USE_SIMD_VMATH 0
+#else
+#define VSMC_USE_SIMD_VMATH 1
+#endif
+#endif
+
 #endif // VSMC_INTERNAL_CONFIG_H
@@ -63,6 +63,14 @@ enum ResampleScheme {
     ResidualSystematic  ///< Systematic resampling on residuals
 };                      // enum ResampleScheme
 
+/// \brief Policy of the first touch of the memory of particle containers
+/// \ingroup Definitions
+enum FirstTouch {
+    FirstTouchSEQ, ///< Initialized by the constructing thread
+    FirstTouchTBB, ///< Initialized in parallel as partitioned by Intel TBB
+    FirstTouchOMP  ///< Initialized in parallel as partitioned by OpenMP
+};                 // enum FirstTouch
+
 } // namespace vsmc
 
 #endif // VSMC_INTERNAL_DEFINES_HPP
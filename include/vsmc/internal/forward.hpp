@@ -53,11 +53,15 @@ class SingleParticle;
 template <typename>
 class SingleParticleBase;
 
-class Weight;
+template <typename>
+class WeightVector;
 
 template <MatrixLayout, std::size_t, typename>
 class StateMatrix;
 
+template <MatrixLayout, typename, typename...>
+class StateTuple;
+
 template <std::size_t, typename, typename>
 class StateCL;
 
@@ -0,0 +1,671 @@
+//============================================================================
+// vSMC/include/vsmc/math/internal/vmath_simd.hpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c) 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#ifndef VSMC_MATH_INTERNAL_VMATH_SIMD_HPP
+#define VSMC_MATH_INTERNAL_VMATH_SIMD_HPP
+
+#include <vsmc/internal/config.h>
+#include <vsmc/math/constants.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#if VSMC_HAS_AVX2 || VSMC_HAS_AVX512
+#include <immintrin.h>
+#elif VSMC_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace vsmc
+{
+
+namespace internal
+{
+
+#if VSMC_HAS_SSE2
+
+/// \brief Double precision SSE2 operations used by the vMath kernels
+class VMathSSE2
+{
+    public:
+    using pd = __m128d;
+    using mask = __m128d;
+
+    static constexpr std::size_t size() { return 2; }
+
+    static pd set1(double a) { return _mm_set1_pd(a); }
+
+    static pd set1i(std::int64_t a)
+    {
+        return _mm_castsi128_pd(_mm_set1_epi64x(a));
+    }
+
+    static pd load(const double *p) { return _mm_loadu_pd(p); }
+
+    static pd load(const float *p)
+    {
+        return _mm_cvtps_pd(_mm_castsi128_ps(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p))));
+    }
+
+    static void store(double *p, pd a) { _mm_storeu_pd(p, a); }
+
+    static void store(float *p, pd a)
+    {
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(p),
+            _mm_castps_si128(_mm_cvtpd_ps(a)));
+    }
+
+    static pd add(pd a, pd b) { return _mm_add_pd(a, b); }
+    static pd sub(pd a, pd b) { return _mm_sub_pd(a, b); }
+    static pd mul(pd a, pd b) { return _mm_mul_pd(a, b); }
+    static pd div(pd a, pd b) { return _mm_div_pd(a, b); }
+    static pd fmadd(pd a, pd b, pd c) { return add(mul(a, b), c); }
+    static pd sqrt(pd a) { return _mm_sqrt_pd(a); }
+    static pd min(pd a, pd b) { return _mm_min_pd(a, b); }
+    static pd max(pd a, pd b) { return _mm_max_pd(a, b); }
+
+    static pd bit_and(pd a, pd b) { return _mm_and_pd(a, b); }
+    static pd bit_or(pd a, pd b) { return _mm_or_pd(a, b); }
+    static pd bit_xor(pd a, pd b) { return _mm_xor_pd(a, b); }
+
+    static pd add_i64(pd a, pd b)
+    {
+        return _mm_castsi128_pd(
+            _mm_add_epi64(_mm_castpd_si128(a), _mm_castpd_si128(b)));
+    }
+
+    template <int N>
+    static pd slli_i64(pd a)
+    {
+        return _mm_castsi128_pd(_mm_slli_epi64(_mm_castpd_si128(a), N));
+    }
+
+    template <int N>
+    static pd srli_i64(pd a)
+    {
+        return _mm_castsi128_pd(_mm_srli_epi64(_mm_castpd_si128(a), N));
+    }
+
+    static mask lt(pd a, pd b) { return _mm_cmplt_pd(a, b); }
+    static mask gt(pd a, pd b) { return _mm_cmpgt_pd(a, b); }
+    static mask eq(pd a, pd b) { return _mm_cmpeq_pd(a, b); }
+    static mask neq(pd a, pd b) { return _mm_cmpneq_pd(a, b); }
+    static mask mask_or(mask a, mask b) { return _mm_or_pd(a, b); }
+    static bool any(mask a) { return _mm_movemask_pd(a) != 0; }
+
+    static pd select(mask m, pd a, pd b)
+    {
+        return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+    }
+}; // class VMathSSE2
+
+#endif // VSMC_HAS_SSE2
+
+#if VSMC_HAS_AVX2
+
+/// \brief Double precision AVX2 operations used by the vMath kernels
+class VMathAVX2
+{
+    public:
+    using pd = __m256d;
+    using mask = __m256d;
+
+    static constexpr std::size_t size() { return 4; }
+
+    static pd set1(double a) { return _mm256_set1_pd(a); }
+
+    static pd set1i(std::int64_t a)
+    {
+        return _mm256_castsi256_pd(_mm256_set1_epi64x(a));
+    }
+
+    static pd load(const double *p) { return _mm256_loadu_pd(p); }
+
+    static pd load(const float *p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+
+    static void store(double *p, pd a) { _mm256_storeu_pd(p, a); }
+
+    static void store(float *p, pd a) { _mm_storeu_ps(p, _mm256_cvtpd_ps(a)); }
+
+    static pd add(pd a, pd b) { return _mm256_add_pd(a, b); }
+    static pd sub(pd a, pd b) { return _mm256_sub_pd(a, b); }
+    static pd mul(pd a, pd b) { return _mm256_mul_pd(a, b); }
+    static pd div(pd a, pd b) { return _mm256_div_pd(a, b); }
+#if VSMC_HAS_FMA
+    static pd fmadd(pd a, pd b, pd c) { return _mm256_fmadd_pd(a, b, c); }
+#else
+    static pd fmadd(pd a, pd b, pd c) { return add(mul(a, b), c); }
+#endif
+    static pd sqrt(pd a) { return _mm256_sqrt_pd(a); }
+    static pd min(pd a, pd b) { return _mm256_min_pd(a, b); }
+    static pd max(pd a, pd b) { return _mm256_max_pd(a, b); }
+
+    static pd bit_and(pd a, pd b) { return _mm256_and_pd(a, b); }
+    static pd bit_or(pd a, pd b) { return _mm256_or_pd(a, b); }
+    static pd bit_xor(pd a, pd b) { return _mm256_xor_pd(a, b); }
+
+    static pd add_i64(pd a, pd b)
+    {
+        return _mm256_castsi256_pd(_mm256_add_epi64(
+            _mm256_castpd_si256(a), _mm256_castpd_si256(b)));
+    }
+
+    template <int N>
+    static pd slli_i64(pd a)
+    {
+        return _mm256_castsi256_pd(
+            _mm256_slli_epi64(_mm256_castpd_si256(a), N));
+    }
+
+    template <int N>
+    static pd srli_i64(pd a)
+    {
+        return _mm256_castsi256_pd(
+            _mm256_srli_epi64(_mm256_castpd_si256(a), N));
+    }
+
+    static mask lt(pd a, pd b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static mask gt(pd a, pd b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static mask eq(pd a, pd b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static mask neq(pd a, pd b) { return _mm256_cmp_pd(a, b, _CMP_NEQ_UQ); }
+    static mask mask_or(mask a, mask b) { return _mm256_or_pd(a, b); }
+    static bool any(mask a) { return _mm256_movemask_pd(a) != 0; }
+
+    static pd select(mask m, pd a, pd b) { return _mm256_blendv_pd(b, a, m); }
+}; // class VMathAVX2
+
+#endif // VSMC_HAS_AVX2
+
+#if VSMC_HAS_AVX512
+
+/// \brief Double precision AVX-512 operations used by the vMath kernels
+class VMathAVX512
+{
+    public:
+    using pd = __m512d;
+    using mask = __mmask8;
+
+    static constexpr std::size_t size() { return 8; }
+
+    static pd set1(double a) { return _mm512_set1_pd(a); }
+
+    static pd set1i(std::int64_t a)
+    {
+        return _mm512_castsi512_pd(_mm512_set1_epi64(a));
+    }
+
+    static pd load(const double *p) { return _mm512_loadu_pd(p); }
+
+    static pd load(const float *p)
+    {
+        return _mm512_cvtps_pd(_mm256_loadu_ps(p));
+    }
+
+    static void store(double *p, pd a) { _mm512_storeu_pd(p, a); }
+
+    static void store(float *p, pd a)
+    {
+        _mm256_storeu_ps(p, _mm512_cvtpd_ps(a));
+    }
+
+    static pd add(pd a, pd b) { return _mm512_add_pd(a, b); }
+    static pd sub(pd a, pd b) { return _mm512_sub_pd(a, b); }
+    static pd mul(pd a, pd b) { return _mm512_mul_pd(a, b); }
+    static pd div(pd a, pd b) { return _mm512_div_pd(a, b); }
+    static pd fmadd(pd a, pd b, pd c) { return _mm512_fmadd_pd(a, b, c); }
+    static pd sqrt(pd a) { return _mm512_sqrt_pd(a); }
+    static pd min(pd a, pd b) { return _mm512_min_pd(a, b); }
+    static pd max(pd a, pd b) { return _mm512_max_pd(a, b); }
+
+    static pd bit_and(pd a, pd b)
+    {
+        return _mm512_castsi512_pd(_mm512_and_si512(
+            _mm512_castpd_si512(a), _mm512_castpd_si512(b)));
+    }
+
+    static pd bit_or(pd a, pd b)
+    {
+        return _mm512_castsi512_pd(_mm512_or_si512(
+            _mm512_castpd_si512(a), _mm512_castpd_si512(b)));
+    }
+
+    static pd bit_xor(pd a, pd b)
+    {
+        return _mm512_castsi512_pd(_mm512_xor_si512(
+            _mm512_castpd_si512(a), _mm512_castpd_si512(b)));
+    }
+
+    static pd add_i64(pd a, pd b)
+    {
+        return _mm512_castsi512_pd(_mm512_add_epi64(
+            _mm512_castpd_si512(a), _mm512_castpd_si512(b)));
+    }
+
+    template <int N>
+    static pd slli_i64(pd a)
+    {
+        return _mm512_castsi512_pd(
+            _mm512_slli_epi64(_mm512_castpd_si512(a), N));
+    }
+
+    template <int N>
+    static pd srli_i64(pd a)
+    {
+        return _mm512_castsi512_pd(
+            _mm512_srli_epi64(_mm512_castpd_si512(a), N));
+    }
+
+    static mask lt(pd a, pd b)
+    {
+        return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ);
+    }
+
+    static mask gt(pd a, pd b)
+    {
+        return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ);
+    }
+
+    static mask eq(pd a, pd b)
+    {
+        return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ);
+    }
+
+    static mask neq(pd a, pd b)
+    {
+        return _mm512_cmp_pd_mask(a, b, _CMP_NEQ_UQ);
+    }
+
+    static mask mask_or(mask a, mask b) { return static_cast<mask>(a | b); }
+    static bool any(mask a) { return a != 0; }
+
+    static pd select(mask m, pd a, pd b) { return _mm512_mask_blend_pd(m, b, a); }
+}; // class VMathAVX512
+
+#endif // VSMC_HAS_AVX512
+
+#if VSMC_HAS_AVX512
+using VMathSIMD = VMathAVX512;
+#elif VSMC_HAS_AVX2
+using VMathSIMD = VMathAVX2;
+#elif VSMC_HAS_SSE2
+using VMathSIMD = VMathSSE2;
+#endif
+
+template <typename V>
+inline typename V::pd vmath_sqrt(typename V::pd x)
+{
+    return V::sqrt(x);
+}
+
+// 2^k where t = k + 1.5 * 2^52 for an integer k such that 2^k is normal
+template <typename V>
+inline typename V::pd vmath_pow2(typename V::pd t)
+{
+    return V::template slli_i64<52>(
+        V::add_i64(t, V::set1i(1023 - 0x4338000000000000LL)));
+}
+
+// e^r - 1 - r for |r| <= log(2) / 2, Taylor polynomial of degree 13
+template <typename V>
+inline typename V::pd vmath_expm1_kernel(typename V::pd r)
+{
+    typename V::pd p = V::set1(1.0 / 6227020800.0);
+    p = V::fmadd(p, r, V::set1(1.0 / 479001600.0));
+    p = V::fmadd(p, r, V::set1(1.0 / 39916800.0));
+    p = V::fmadd(p, r, V::set1(1.0 / 3628800.0));
+    p = V::fmadd(p, r, V::set1(1.0 / 362880.0));
+    p = V::fmadd(p, r, V::set1(1.0 / 40320.0));
+    p = V::fmadd(p, r, V::set1(1.0 / 5040.0));
+    p = V::fmadd(p, r, V::set1(1.0 / 720.0));
+    p = V::fmadd(p, r, V::set1(1.0 / 120.0));
+    p = V::fmadd(p, r, V::set1(1.0 / 24.0));
+    p = V::fmadd(p, r, V::set1(1.0 / 6.0));
+    p = V::fmadd(p, r, V::set1(0.5));
+
+    return V::mul(V::mul(r, r), p);
+}
+
+// Reduce x = k log(2) + r + c with |r| <= log(2) / 2 and c the rounding error
+// of r, return k + 1.5 * 2^52
+template <typename V>
+inline typename V::pd vmath_exp_reduce(typename V::pd x, typename V::pd &k,
+    typename V::pd &r, typename V::pd &c)
+{
+    const typename V::pd magic = V::set1(6755399441055744.0);
+    const typename V::pd t =
+        V::fmadd(x, V::set1(1.44269504088896340736e+00), magic);
+    k = V::sub(t, magic);
+    const typename V::pd hi =
+        V::sub(x, V::mul(k, V::set1(6.93147180369123816490e-01)));
+    const typename V::pd lo =
+        V::mul(k, V::set1(1.90821492927058770002e-10));
+    r = V::sub(hi, lo);
+    c = V::sub(V::sub(hi, r), lo);
+
+    return t;
+}
+
+// e^(r + c) - 1 - r = q + c (1 + r + q) where q = e^r - 1 - r
+template <typename V>
+inline typename V::pd vmath_expm1_correct(typename V::pd r, typename V::pd c)
+{
+    const typename V::pd q = vmath_expm1_kernel<V>(r);
+
+    return V::fmadd(c, V::add(V::add(V::set1(1.0), r), q), q);
+}
+
+// a + b + c where |a| >= |b|, the rounding error of a + b is compensated
+template <typename V>
+inline typename V::pd vmath_fast_two_sum(
+    typename V::pd a, typename V::pd b, typename V::pd c)
+{
+    const typename V::pd s = V::add(a, b);
+    const typename V::pd e = V::add(V::sub(a, s), b);
+
+    return V::add(s, V::add(c, e));
+}
+
+template <typename V>
+inline typename V::pd vmath_exp(typename V::pd x)
+{
+    using pd = typename V::pd;
+
+    const pd magic = V::set1(6755399441055744.0);
+    const pd xc = V::min(V::max(x, V::set1(-746.0)), V::set1(710.0));
+    pd k;
+    pd r;
+    pd c;
+    vmath_exp_reduce<V>(xc, k, r, c);
+    const pd y = vmath_fast_two_sum<V>(
+        V::set1(1.0), r, vmath_expm1_correct<V>(r, c));
+
+    // Scale by 2^k in two steps such that subnormal results and k = 1024
+    // are handled correctly
+    const pd t1 = V::add(V::mul(k, V::set1(0.5)), magic);
+    const pd t2 = V::add(V::sub(k, V::sub(t1, magic)), magic);
+    const pd z = V::mul(V::mul(y, vmath_pow2<V>(t1)), vmath_pow2<V>(t2));
+
+    return V::select(V::neq(x, x), x, z);
+}
+
+template <typename V>
+inline typename V::pd vmath_expm1(typename V::pd x)
+{
+    using pd = typename V::pd;
+
+    const pd one = V::set1(1.0);
+    const pd kmax = V::set1(1023.0);
+    const pd xc = V::min(V::max(x, V::set1(-40.0)), V::set1(710.0));
+    pd k;
+    pd r;
+    pd c;
+    vmath_exp_reduce<V>(xc, k, r, c);
+    const pd q = vmath_expm1_correct<V>(r, c);
+
+    // e^x - 1 = (2^k - 1) + 2^k r + 2^k q, 2^k - 1 is exact for |k| < 54
+    // and is larger than 2^k r in magnitude unless k = 0
+    const pd s = vmath_pow2<V>(
+        V::add(V::min(k, kmax), V::set1(6755399441055744.0)));
+    pd y = vmath_fast_two_sum<V>(V::sub(s, one), V::mul(s, r), V::mul(s, q));
+    y = V::mul(y, V::select(V::gt(k, kmax), V::set1(2.0), one));
+    y = V::select(V::eq(x, V::set1(0.0)), x, y);
+
+    return V::select(V::neq(x, x), x, y);
+}
+
+// Decompose a positive normal x = 2^k (1 + f), sqrt(2) / 2 <= 1 + f < sqrt(2)
+template <typename V>
+inline typename V::pd vmath_log_reduce(typename V::pd x, typename V::pd &k)
+{
+    using pd = typename V::pd;
+
+    const pd one = V::set1(1.0);
+    const pd pow52 = V::set1(4503599627370496.0);
+    const pd e = V::sub(V::bit_or(V::template srli_i64<52>(x), pow52),
+        V::set1(4503599627370496.0 + 1023.0));
+    pd m = V::bit_or(V::bit_and(x, V::set1i(0x000FFFFFFFFFFFFFLL)), one);
+    const typename V::mask big = V::gt(m, V::set1(const_sqrt_2<double>()));
+    m = V::select(big, V::mul(m, V::set1(0.5)), m);
+    k = V::add(e, V::select(big, one, V::set1(0.0)));
+
+    return V::sub(m, one);
+}
+
+// k log(2) + log(1 + f) + c, the polynomial is that of FDLIBM
+template <typename V>
+inline typename V::pd vmath_log_kernel(
+    typename V::pd k, typename V::pd f, typename V::pd c)
+{
+    using pd = typename V::pd;
+
+    const pd hfsq = V::mul(V::set1(0.5), V::mul(f, f));
+    const pd s = V::div(f, V::add(V::set1(2.0), f));
+    const pd z = V::mul(s, s);
+    const pd w = V::mul(z, z);
+    pd t1 = V::set1(1.531383769920937332e-01);
+    t1 = V::fmadd(t1, w, V::set1(2.222219843214978396e-01));
+    t1 = V::fmadd(t1, w, V::set1(3.999999999940941908e-01));
+    t1 = V::mul(t1, w);
+    pd t2 = V::set1(1.479819860511658591e-01);
+    t2 = V::fmadd(t2, w, V::set1(1.818357216161805012e-01));
+    t2 = V::fmadd(t2, w, V::set1(2.857142874366239149e-01));
+    t2 = V::fmadd(t2, w, V::set1(6.666666666666735130e-01));
+    t2 = V::mul(t2, z);
+    const pd lo = V::fmadd(k, V::set1(1.90821492927058770002e-10), c);
+    const pd u = V::fmadd(s, V::add(hfsq, V::add(t2, t1)), lo);
+
+    return V::sub(V::mul(k, V::set1(6.93147180369123816490e-01)),
+        V::sub(V::sub(hfsq, u), f));
+}
+
+template <typename V>
+inline typename V::pd vmath_log(typename V::pd x)
+{
+    using pd = typename V::pd;
+
+    const pd zero = V::set1(0.0);
+    const pd inf = V::set1(std::numeric_limits<double>::infinity());
+    const typename V::mask sub =
+        V::lt(x, V::set1(std::numeric_limits<double>::min()));
+    const pd xs = V::select(sub, V::mul(x, V::set1(18014398509481984.0)), x);
+    pd k;
+    const pd f = vmath_log_reduce<V>(xs, k);
+    k = V::sub(k, V::select(sub, V::set1(54.0), zero));
+    pd y = vmath_log_kernel<V>(k, f, zero);
+    y = V::select(V::eq(x, inf), x, y);
+    y = V::select(
+        V::lt(x, zero), V::set1(std::numeric_limits<double>::quiet_NaN()), y);
+    y = V::select(V::eq(x, zero), V::sub(zero, inf), y);
+
+    return V::select(V::neq(x, x), x, y);
+}
+
+template <typename V>
+inline typename V::pd vmath_log1p(typename V::pd x)
+{
+    using pd = typename V::pd;
+
+    const pd zero = V::set1(0.0);
+    const pd one = V::set1(1.0);
+    const pd inf = V::set1(std::numeric_limits<double>::infinity());
+    const pd u = V::add(one, x);
+    pd k;
+    const pd f = vmath_log_reduce<V>(u, k);
+
+    // If k = 0, then f = x exactly, otherwise correct the rounding error of
+    // 1 + x by c = (1 + x - u) / u
+    const typename V::mask k0 = V::eq(k, zero);
+    const pd c = V::div(V::sub(x, V::sub(u, one)), u);
+    pd y = vmath_log_kernel<V>(
+        k, V::select(k0, x, f), V::select(k0, zero, c));
+    y = V::select(V::eq(x, inf), x, y);
+    y = V::select(V::lt(x, V::set1(-1.0)),
+        V::set1(std::numeric_limits<double>::quiet_NaN()), y);
+    y = V::select(V::eq(x, V::set1(-1.0)), V::sub(zero, inf), y);
+
+    return V::select(V::neq(x, x), x, y);
+}
+
+// Lanes with |x| larger than this are computed by the standard library
+constexpr double vmath_sincos_max() { return 1e6; }
+
+// Return the mask of lanes that are not computed, the polynomials are those
+// of FDLIBM
+template <typename V>
+inline typename V::mask vmath_sincos(
+    typename V::pd x, typename V::pd &s, typename V::pd &c)
+{
+    using pd = typename V::pd;
+
+    const pd zero = V::set1(0.0);
+    const pd one = V::set1(1.0);
+    const pd magic = V::set1(6755399441055744.0);
+    const pd ax = V::bit_and(x, V::set1i(0x7FFFFFFFFFFFFFFFLL));
+    const typename V::mask bad =
+        V::mask_or(V::neq(x, x), V::gt(ax, V::set1(vmath_sincos_max())));
+
+    // x = k pi / 2 + r + rr, |r| <= pi / 4 and rr is the tail of r
+    const pd xr = V::select(bad, zero, x);
+    const pd t = V::fmadd(xr, V::set1(6.36619772367581382433e-01), magic);
+    const pd k = V::sub(t, magic);
+    const pd r1 = V::sub(xr, V::mul(k, V::set1(1.57079632673412561417e+00)));
+    const pd w1 = V::mul(k, V::set1(6.07710050630396597660e-11));
+    const pd r2 = V::sub(r1, w1);
+    const pd w2 = V::sub(V::mul(k, V::set1(2.02226624879595063154e-21)),
+        V::sub(V::sub(r1, r2), w1));
+    const pd r = V::sub(r2, w2);
+    const pd rr = V::sub(V::sub(r2, r), w2);
+    const pd z = V::mul(r, r);
+    const pd half = V::set1(0.5);
+
+    pd ps = V::set1(1.58969099521155010221e-10);
+    ps = V::fmadd(ps, z, V::set1(-2.50507602534068634195e-08));
+    ps = V::fmadd(ps, z, V::set1(2.75573137070700676789e-06));
+    ps = V::fmadd(ps, z, V::set1(-1.98412698298579493134e-04));
+    ps = V::fmadd(ps, z, V::set1(8.33333333332248946124e-03));
+    const pd v = V::mul(z, r);
+    const pd sr = V::sub(r,
+        V::sub(V::sub(V::mul(z, V::sub(V::mul(half, rr), V::mul(v, ps))),
+                   rr),
+            V::mul(v, V::set1(-1.66666666666666324348e-01))));
+
+    pd pc = V::set1(-1.13596475577881948265e-11);
+    pc = V::fmadd(pc, z, V::set1(2.08757232129817482790e-09));
+    pc = V::fmadd(pc, z, V::set1(-2.75573143513906633035e-07));
+    pc = V::fmadd(pc, z, V::set1(2.48015872894767294178e-05));
+    pc = V::fmadd(pc, z, V::set1(-1.38888888888741095749e-03));
+    pc = V::fmadd(pc, z, V::set1(4.16666666666666019037e-02));
+    pc = V::mul(pc, z);
+    const pd hz = V::mul(half, z);
+    const pd w = V::sub(one, hz);
+    const pd cr = V::add(w, V::add(V::sub(V::sub(one, w), hz),
+                                V::sub(V::mul(z, pc), V::mul(r, rr))));
+
+    // The low bits of t are those of k
+    const pd i2 = V::set1i(2);
+    const typename V::mask odd =
+        V::lt(V::bit_or(V::template slli_i64<63>(t), one), zero);
+    const pd sign_s = V::template slli_i64<62>(V::bit_and(t, i2));
+    const pd sign_c = V::template slli_i64<62>(
+        V::bit_and(V::add_i64(t, V::set1i(1)), i2));
+    s = V::bit_xor(V::select(odd, cr, sr), sign_s);
+    c = V::bit_xor(V::select(odd, sr, cr), sign_c);
+
+    return bad;
+}
+
+template <typename V, typename T, typename Kernel>
+inline void vmath_simd_1(std::size_t n, const T *a, T *y, Kernel &&kernel)
+{
+    const std::size_t k = V::size();
+    const std::size_t m = n / k * k;
+    for (std::size_t i = 0; i != m; i += k)
+        V::store(y + i, kernel(V::load(a + i)));
+    if (m == n)
+        return;
+
+    T ta[V::size()] = {};
+    T ty[V::size()];
+    std::copy(a + m, a + n, ta);
+    V::store(ty, kernel(V::load(ta)));
+    std::copy(ty, ty + (n - m), y + m);
+}
+
+template <typename T>
+inline void vmath_simd_sincos_std(std::size_t n, const T *a, T *y, T *z)
+{
+    for (std::size_t i = 0; i != n; ++i) {
+        const T x = a[i];
+        y[i] = std::sin(x);
+        z[i] = std::cos(x);
+    }
+}
+
+template <typename V, typename T>
+inline void vmath_simd_sincos(std::size_t n, const T *a, T *y, T *z)
+{
+    const std::size_t k = V::size();
+    const std::size_t m = n / k * k;
+    typename V::pd s;
+    typename V::pd c;
+    for (std::size_t i = 0; i != m; i += k) {
+        if (V::any(vmath_sincos<V>(V::load(a + i), s, c))) {
+            vmath_simd_sincos_std(k, a + i, y + i, z + i);
+        } else {
+            V::store(y + i, s);
+            V::store(z + i, c);
+        }
+    }
+    if (m == n)
+        return;
+
+    T ta[V::size()] = {};
+    T ty[V::size()];
+    T tz[V::size()];
+    std::copy(a + m, a + n, ta);
+    if (V::any(vmath_sincos<V>(V::load(ta), s, c))) {
+        vmath_simd_sincos_std(n - m, a + m, y + m, z + m);
+    } else {
+        V::store(ty, s);
+        V::store(tz, c);
+        std::copy(ty, ty + (n - m), y + m);
+        std::copy(tz, tz + (n - m), z + m);
+    }
+}
+
+} // namespace vsmc::internal
+
+} // namespace vsmc
+
+#endif // VSMC_MATH_INTERNAL_VMATH_SIMD_HPP
@@ -37,5 +37,6 @@
 #include <vsmc/math/constants.hpp>
 #include <vsmc/math/lapacke.h>
 #include <vsmc/math/vmath.hpp>
+#include <vsmc/math/vmath_expr.hpp>
 
 #endif // VSMC_MATH_MATH_HPP
@@ -38,6 +38,8 @@
 
 #if VSMC_USE_MKL_VML
 #include <mkl.h>
+#elif VSMC_USE_SIMD_VMATH
+#include <vsmc/math/internal/vmath_simd.hpp>
 #endif
 
 #define VSMC_DEFINE_MATH_VMATH_1(func, name)                                  \
@@ -183,6 +185,50 @@ VSMC_DEFINE_MATH_VMATH_VML_1(TGamma, tgamm)
 
 } // namespace vsmc
 
+#elif VSMC_USE_SIMD_VMATH && VSMC_HAS_SSE2
+
+#define VSMC_DEFINE_MATH_VMATH_SIMD_1(T, func, name)                          \
+    inline void name(std::size_t n, const T *a, T *y)                         \
+    {                                                                         \
+        internal::vmath_simd_1<internal::VMathSIMD>(n, a, y,                  \
+            [](internal::VMathSIMD::pd x) {                                   \
+                return internal::func<internal::VMathSIMD>(x);                \
+            });                                                               \
+    }
+
+namespace vsmc
+{
+
+VSMC_DEFINE_MATH_VMATH_SIMD_1(double, vmath_sqrt, sqrt)
+VSMC_DEFINE_MATH_VMATH_SIMD_1(double, vmath_exp, exp)
+VSMC_DEFINE_MATH_VMATH_SIMD_1(double, vmath_expm1, expm1)
+VSMC_DEFINE_MATH_VMATH_SIMD_1(double, vmath_log, log)
+VSMC_DEFINE_MATH_VMATH_SIMD_1(double, vmath_log1p, log1p)
+
+inline void sincos(std::size_t n, const double *a, double *y, double *z)
+{
+    internal::vmath_simd_sincos<internal::VMathSIMD>(n, a, y, z);
+}
+
+// Single precision functions are computed in double precision, which only
+// pays off with at least four lanes
+#if VSMC_HAS_AVX2
+
+VSMC_DEFINE_MATH_VMATH_SIMD_1(float, vmath_sqrt, sqrt)
+VSMC_DEFINE_MATH_VMATH_SIMD_1(float, vmath_exp, exp)
+VSMC_DEFINE_MATH_VMATH_SIMD_1(float, vmath_expm1, expm1)
+VSMC_DEFINE_MATH_VMATH_SIMD_1(float, vmath_log, log)
+VSMC_DEFINE_MATH_VMATH_SIMD_1(float, vmath_log1p, log1p)
+
+inline void sincos(std::size_t n, const float *a, float *y, float *z)
+{
+    internal::vmath_simd_sincos<internal::VMathSIMD>(n, a, y, z);
+}
+
+#endif // VSMC_HAS_AVX2
+
+} // namespace vsmc
+
 #endif // VSMC_USE_MKL_VML
 
 namespace vsmc
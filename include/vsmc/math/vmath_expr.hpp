@@ -0,0 +1,524 @@
+//============================================================================
+// vSMC/include/vsmc/math/vmath_expr.hpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c) 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#ifndef VSMC_MATH_VMATH_EXPR_HPP
+#define VSMC_MATH_VMATH_EXPR_HPP
+
+#include <vsmc/internal/config.h>
+#include <vsmc/math/internal/vmath_simd.hpp>
+#include <vsmc/math/vmath.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#define VSMC_DEFINE_MATH_VMATH_EXPR_UNARY(Name, name, sfunc, pfunc, vfunc)    \
+    namespace internal                                                        \
+    {                                                                         \
+                                                                              \
+    class VMathExpr##Name                                                     \
+    {                                                                         \
+        public:                                                               \
+        template <typename T>                                                 \
+        static T eval(T x)                                                    \
+        {                                                                     \
+            return sfunc(x);                                                  \
+        }                                                                     \
+                                                                              \
+        template <typename V>                                                 \
+        static typename V::pd packet(typename V::pd x)                        \
+        {                                                                     \
+            return pfunc<V>(x);                                               \
+        }                                                                     \
+                                                                              \
+        template <typename T>                                                 \
+        static void block(std::size_t n, const T *a, T *y)                    \
+        {                                                                     \
+            vfunc(n, a, y);                                                   \
+        }                                                                     \
+    };                                                                        \
+    }                                                                         \
+                                                                              \
+    namespace vmath                                                           \
+    {                                                                         \
+                                                                              \
+    template <typename E>                                                     \
+    inline ExprUnary<internal::VMathExpr##Name, E> name(const Expr<E> &e)     \
+    {                                                                         \
+        return ExprUnary<internal::VMathExpr##Name, E>(e.derived());          \
+    }                                                                         \
+    }
+
+#define VSMC_DEFINE_MATH_VMATH_EXPR_BINARY(Name, op, vfunc)                   \
+    namespace internal                                                        \
+    {                                                                         \
+                                                                              \
+    class VMathExpr##Name                                                     \
+    {                                                                         \
+        public:                                                               \
+        template <typename T>                                                 \
+        static T eval(T a, T b)                                               \
+        {                                                                     \
+            return a op b;                                                    \
+        }                                                                     \
+                                                                              \
+        template <typename V>                                                 \
+        static typename V::pd packet(typename V::pd a, typename V::pd b)      \
+        {                                                                     \
+            return V::vfunc(a, b);                                            \
+        }                                                                     \
+                                                                              \
+        template <typename T>                                                 \
+        static void block(std::size_t n, const T *a, const T *b, T *y)        \
+        {                                                                     \
+            ::vsmc::vfunc(n, a, b, y);                                        \
+        }                                                                     \
+    };                                                                        \
+    }                                                                         \
+                                                                              \
+    namespace vmath                                                           \
+    {                                                                         \
+                                                                              \
+    template <typename L, typename R>                                         \
+    inline ExprBinary<internal::VMathExpr##Name, L, R> operator op(           \
+        const Expr<L> &a, const Expr<R> &b)                                   \
+    {                                                                         \
+        return ExprBinary<internal::VMathExpr##Name, L, R>(                   \
+            a.derived(), b.derived());                                        \
+    }                                                                         \
+                                                                              \
+    template <typename L>                                                     \
+    inline ExprBinary<internal::VMathExpr##Name, L,                           \
+        ExprScalar<typename L::value_type>>                                   \
+    operator op(const Expr<L> &a, typename L::value_type b)                   \
+    {                                                                         \
+        return ExprBinary<internal::VMathExpr##Name, L,                       \
+            ExprScalar<typename L::value_type>>(                              \
+            a.derived(), ExprScalar<typename L::value_type>(b));              \
+    }                                                                         \
+                                                                              \
+    template <typename R>                                                     \
+    inline ExprBinary<internal::VMathExpr##Name,                              \
+        ExprScalar<typename R::value_type>, R>                                \
+    operator op(typename R::value_type a, const Expr<R> &b)                   \
+    {                                                                         \
+        return ExprBinary<internal::VMathExpr##Name,                          \
+            ExprScalar<typename R::value_type>, R>(                           \
+            ExprScalar<typename R::value_type>(a), b.derived());              \
+    }                                                                         \
+    }
+
+namespace vsmc
+{
+
+namespace internal
+{
+
+/// \brief Whether vmath::eval computes expressions of type `T` with the
+/// built-in SIMD kernels, one packet at a time
+template <typename T>
+class VMathExprPacket : public std::false_type
+{
+}; // class VMathExprPacket
+
+#if VSMC_USE_SIMD_VMATH && VSMC_HAS_SSE2
+
+template <>
+class VMathExprPacket<double> : public std::true_type
+{
+}; // class VMathExprPacket
+
+// Single precision is computed in double precision, see vmath.hpp
+#if VSMC_HAS_AVX2
+
+template <>
+class VMathExprPacket<float> : public std::true_type
+{
+}; // class VMathExprPacket
+
+#endif // VSMC_HAS_AVX2
+
+#endif // VSMC_USE_SIMD_VMATH && VSMC_HAS_SSE2
+
+// Number of elements of each block if an expression is not computed by
+// packets. Each node of the expression needs at most one such block on the
+// stack
+constexpr std::size_t vmath_expr_block() { return 256; }
+
+template <typename T>
+inline T vmath_expr_neg(T x)
+{
+    return -x;
+}
+
+template <typename T>
+inline T vmath_expr_sqr(T x)
+{
+    return x * x;
+}
+
+template <typename T>
+inline void vmath_expr_neg(std::size_t n, const T *a, T *y)
+{
+    for (std::size_t i = 0; i != n; ++i)
+        y[i] = -a[i];
+}
+
+template <typename V>
+inline typename V::pd vmath_neg(typename V::pd x)
+{
+    return V::bit_xor(x, V::set1(-0.0));
+}
+
+template <typename V>
+inline typename V::pd vmath_abs(typename V::pd x)
+{
+    return V::bit_and(x, V::set1i(0x7FFFFFFFFFFFFFFFLL));
+}
+
+template <typename V>
+inline typename V::pd vmath_sqr(typename V::pd x)
+{
+    return V::mul(x, x);
+}
+
+template <typename V, bool Sin>
+inline typename V::pd vmath_sin_or_cos(typename V::pd x)
+{
+    typename V::pd s;
+    typename V::pd c;
+    if (!V::any(vmath_sincos<V>(x, s, c)))
+        return Sin ? s : c;
+
+    double a[V::size()];
+    V::store(a, x);
+    for (std::size_t i = 0; i != V::size(); ++i)
+        a[i] = Sin ? std::sin(a[i]) : std::cos(a[i]);
+
+    return V::load(a);
+}
+
+template <typename V>
+inline typename V::pd vmath_sin(typename V::pd x)
+{
+    return vmath_sin_or_cos<V, true>(x);
+}
+
+template <typename V>
+inline typename V::pd vmath_cos(typename V::pd x)
+{
+    return vmath_sin_or_cos<V, false>(x);
+}
+
+} // namespace vsmc::internal
+
+/// \brief Lazy expressions over the vMath functions
+/// \ingroup vMath
+///
+/// \details
+/// Chaining vMath functions, such as
+/// ~~~{.cpp}
+/// log(n, u, s);
+/// mul(n, -2.0, s, s);
+/// sqrt(n, s, s);
+/// ~~~
+/// streams the data through memory once for each call. The same computation
+/// written as an expression,
+/// ~~~{.cpp}
+/// vmath::eval(n, s, vmath::sqrt(-2 * vmath::log(vmath::arg(u))));
+/// ~~~
+/// is computed by a single loop. If the built-in SIMD kernels are used (see
+/// `VSMC_USE_SIMD_VMATH`), each iteration computes the whole expression for
+/// one SIMD packet, the last one padded with zeros, such that the results do
+/// not depend on `n`. Otherwise, the expression is computed in small blocks
+/// that stay in the L1 cache, one vMath function call for each node of the
+/// expression (e.g., those of MKL VML). In both cases, the output may alias
+/// any of the input arrays.
+namespace vmath
+{
+
+/// \brief Base class of expressions
+/// \ingroup vMath
+template <typename Derived>
+class Expr
+{
+    public:
+    const Derived &derived() const
+    {
+        return static_cast<const Derived &>(*this);
+    }
+}; // class Expr
+
+/// \brief An input array
+/// \ingroup vMath
+template <typename T>
+class ExprArg : public Expr<ExprArg<T>>
+{
+    public:
+    using value_type = T;
+
+    explicit ExprArg(const T *a) : a_(a) {}
+
+    T operator[](std::size_t i) const { return a_[i]; }
+
+    template <typename V>
+    typename V::pd packet(std::size_t i) const
+    {
+        return V::load(a_ + i);
+    }
+
+    template <typename V>
+    typename V::pd packet(std::size_t i, std::size_t m) const
+    {
+        T t[V::size()] = {};
+        std::copy(a_ + i, a_ + i + m, t);
+
+        return V::load(t);
+    }
+
+    const T *block(std::size_t i, std::size_t, T *) const { return a_ + i; }
+
+    private:
+    const T *a_;
+}; // class ExprArg
+
+/// \brief A scalar operand
+/// \ingroup vMath
+template <typename T>
+class ExprScalar : public Expr<ExprScalar<T>>
+{
+    public:
+    using value_type = T;
+
+    explicit ExprScalar(T a) : a_(a) {}
+
+    T operator[](std::size_t) const { return a_; }
+
+    template <typename V>
+    typename V::pd packet(std::size_t) const
+    {
+        return V::set1(static_cast<double>(a_));
+    }
+
+    template <typename V>
+    typename V::pd packet(std::size_t, std::size_t) const
+    {
+        return V::set1(static_cast<double>(a_));
+    }
+
+    const T *block(std::size_t, std::size_t n, T *buf) const
+    {
+        std::fill_n(buf, n, a_);
+
+        return buf;
+    }
+
+    private:
+    T a_;
+}; // class ExprScalar
+
+/// \brief An unary function of an expression
+/// \ingroup vMath
+template <typename Op, typename E>
+class ExprUnary : public Expr<ExprUnary<Op, E>>
+{
+    public:
+    using value_type = typename E::value_type;
+
+    explicit ExprUnary(const E &e) : e_(e) {}
+
+    value_type operator[](std::size_t i) const { return Op::eval(e_[i]); }
+
+    template <typename V>
+    typename V::pd packet(std::size_t i) const
+    {
+        return Op::template packet<V>(e_.template packet<V>(i));
+    }
+
+    template <typename V>
+    typename V::pd packet(std::size_t i, std::size_t m) const
+    {
+        return Op::template packet<V>(e_.template packet<V>(i, m));
+    }
+
+    const value_type *block(
+        std::size_t i, std::size_t n, value_type *buf) const
+    {
+        Op::block(n, e_.block(i, n, buf), buf);
+
+        return buf;
+    }
+
+    private:
+    E e_;
+}; // class ExprUnary
+
+/// \brief A binary operator of two expressions
+/// \ingroup vMath
+template <typename Op, typename L, typename R>
+class ExprBinary : public Expr<ExprBinary<Op, L, R>>
+{
+    static_assert(std::is_same<typename L::value_type,
+                      typename R::value_type>::value,
+        "**vmath::ExprBinary** USED WITH OPERANDS OF DIFFERENT VALUE TYPES");
+
+    public:
+    using value_type = typename L::value_type;
+
+    ExprBinary(const L &a, const R &b) : a_(a), b_(b) {}
+
+    value_type operator[](std::size_t i) const
+    {
+        return Op::eval(a_[i], b_[i]);
+    }
+
+    template <typename V>
+    typename V::pd packet(std::size_t i) const
+    {
+        return Op::template packet<V>(
+            a_.template packet<V>(i), b_.template packet<V>(i));
+    }
+
+    template <typename V>
+    typename V::pd packet(std::size_t i, std::size_t m) const
+    {
+        return Op::template packet<V>(
+            a_.template packet<V>(i, m), b_.template packet<V>(i, m));
+    }
+
+    const value_type *block(
+        std::size_t i, std::size_t n, value_type *buf) const
+    {
+        value_type tmp[internal::vmath_expr_block()];
+        const value_type *a = a_.block(i, n, buf);
+        const value_type *b = b_.block(i, n, tmp);
+        Op::block(n, a, b, buf);
+
+        return buf;
+    }
+
+    private:
+    L a_;
+    R b_;
+}; // class ExprBinary
+
+/// \brief Use an input array in an expression
+/// \ingroup vMath
+template <typename T>
+inline ExprArg<T> arg(const T *a)
+{
+    return ExprArg<T>(a);
+}
+
+} // namespace vsmc::vmath
+
+VSMC_DEFINE_MATH_VMATH_EXPR_BINARY(Add, +, add)
+VSMC_DEFINE_MATH_VMATH_EXPR_BINARY(Sub, -, sub)
+VSMC_DEFINE_MATH_VMATH_EXPR_BINARY(Mul, *, mul)
+VSMC_DEFINE_MATH_VMATH_EXPR_BINARY(Div, /, div)
+
+VSMC_DEFINE_MATH_VMATH_EXPR_UNARY(
+    Neg, operator-, vmath_expr_neg, vmath_neg, vmath_expr_neg)
+VSMC_DEFINE_MATH_VMATH_EXPR_UNARY(Abs, abs, std::abs, vmath_abs, ::vsmc::abs)
+VSMC_DEFINE_MATH_VMATH_EXPR_UNARY(
+    Sqr, sqr, vmath_expr_sqr, vmath_sqr, ::vsmc::sqr)
+VSMC_DEFINE_MATH_VMATH_EXPR_UNARY(
+    Sqrt, sqrt, std::sqrt, vmath_sqrt, ::vsmc::sqrt)
+VSMC_DEFINE_MATH_VMATH_EXPR_UNARY(Exp, exp, std::exp, vmath_exp, ::vsmc::exp)
+VSMC_DEFINE_MATH_VMATH_EXPR_UNARY(
+    Expm1, expm1, std::expm1, vmath_expm1, ::vsmc::expm1)
+VSMC_DEFINE_MATH_VMATH_EXPR_UNARY(Log, log, std::log, vmath_log, ::vsmc::log)
+VSMC_DEFINE_MATH_VMATH_EXPR_UNARY(
+    Log1p, log1p, std::log1p, vmath_log1p, ::vsmc::log1p)
+VSMC_DEFINE_MATH_VMATH_EXPR_UNARY(Sin, sin, std::sin, vmath_sin, ::vsmc::sin)
+VSMC_DEFINE_MATH_VMATH_EXPR_UNARY(Cos, cos, std::cos, vmath_cos, ::vsmc::cos)
+
+namespace internal
+{
+
+template <typename T, typename E>
+inline void vmath_expr_eval(
+    std::size_t n, T *y, const E &expr, std::false_type)
+{
+    const std::size_t k = vmath_expr_block();
+    T buf[vmath_expr_block()];
+    for (std::size_t i = 0; i < n; i += k) {
+        const std::size_t m = std::min(k, n - i);
+        const T *r = expr.block(i, m, buf);
+        std::copy(r, r + m, y + i);
+    }
+}
+
+#if VSMC_USE_SIMD_VMATH && VSMC_HAS_SSE2
+
+template <typename T, typename E>
+inline void vmath_expr_eval(std::size_t n, T *y, const E &expr, std::true_type)
+{
+    using V = VMathSIMD;
+
+    const std::size_t k = V::size();
+    const std::size_t m = n / k * k;
+    for (std::size_t i = 0; i != m; i += k)
+        V::store(y + i, expr.template packet<V>(i));
+    if (m == n)
+        return;
+
+    // The last partial packet, padded with zeros, such that each element is
+    // computed by the same kernels regardless of its position
+    T t[V::size()];
+    V::store(t, expr.template packet<V>(m, n - m));
+    std::copy(t, t + (n - m), y + m);
+}
+
+#endif // VSMC_USE_SIMD_VMATH && VSMC_HAS_SSE2
+
+} // namespace vsmc::internal
+
+namespace vmath
+{
+
+/// \brief Compute \f$y_i = e_i\f$, \f$i = 0,\ldots,n - 1\f$ in a single loop
+/// \ingroup vMath
+template <typename T, typename E>
+inline void eval(std::size_t n, T *y, const Expr<E> &expr)
+{
+    static_assert(std::is_same<T, typename E::value_type>::value,
+        "**vmath::eval** USED WITH OUTPUT OF A DIFFERENT VALUE TYPE");
+
+    internal::vmath_expr_eval(
+        n, y, expr.derived(), internal::VMathExprPacket<T>());
+}
+
+} // namespace vsmc::vmath
+
+} // namespace vsmc
+
+#endif // VSMC_MATH_VMATH_EXPR_HPP
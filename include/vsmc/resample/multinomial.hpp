@@ -43,9 +43,9 @@ namespace vsmc
 class ResampleMultinomial
 {
     public:
-    template <typename IntType, typename RNGType>
+    template <typename IntType, typename RNGType, typename RealType>
     void operator()(std::size_t M, std::size_t N, RNGType &rng,
-        const double *weight, IntType *replication)
+        const RealType *weight, IntType *replication)
     {
         U01SequenceSorted<RNGType, double> u01seq(N, rng);
         resample_trans_u01_rep(M, N, weight, u01seq, replication);
@@ -38,6 +38,7 @@
 #include <vsmc/resample/residual.hpp>
 #include <vsmc/resample/residual_stratified.hpp>
 #include <vsmc/resample/residual_systematic.hpp>
+#include <vsmc/resample/sqmc.hpp>
 #include <vsmc/resample/stratified.hpp>
 #include <vsmc/resample/systematic.hpp>
 #include <vsmc/resample/transform.hpp>
@@ -43,12 +43,12 @@ namespace vsmc
 class ResampleResidual
 {
     public:
-    template <typename IntType, typename RNGType>
+    template <typename IntType, typename RNGType, typename RealType>
     void operator()(std::size_t M, std::size_t N, RNGType &rng,
-        const double *weight, IntType *replication)
+        const RealType *weight, IntType *replication)
     {
         Vector<IntType> integ(M);
-        Vector<double> resid(M);
+        Vector<RealType> resid(M);
         std::size_t R =
             resample_trans_residual(M, N, weight, resid.data(), integ.data());
         U01SequenceSorted<RNGType, double> u01seq(R, rng);
@@ -0,0 +1,212 @@
+//============================================================================
+// vSMC/include/vsmc/resample/sqmc.hpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c) 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#ifndef VSMC_RESAMPLE_SQMC_HPP
+#define VSMC_RESAMPLE_SQMC_HPP
+
+#include <vsmc/resample/internal/common.hpp>
+#include <vsmc/resample/transform.hpp>
+#include <vsmc/rng/halton.hpp>
+#include <vsmc/rng/sobol.hpp>
+#include <vsmc/utility/hilbert_sort.hpp>
+
+#define VSMC_RUNTIME_ASSERT_RESAMPLE_SQMC_SIZE(M)                             \
+    VSMC_RUNTIME_ASSERT((M == data_->size()),                                 \
+        "**ResampleSQMC** USED WITH A WEIGHT OF DIFFERENT SIZE FROM THE STATE")
+
+namespace vsmc
+{
+
+/// \brief Sequential quasi-Monte Carlo resampling
+/// \ingroup Resample
+///
+/// \details
+/// This implements the resampling step of SQMC (Gerber and Chopin, 2015).
+/// Each call scrambles the quasi-Monte Carlo sequence of type `QMCType`,
+/// e.g., SobolSequence or HaltonSequence, anew with the resampling RNG, and
+/// generates \f$N\f$ points of dimension `dim() + 1`. The particles are
+/// sorted along the Hilbert curve of their states, and the first coordinates
+/// of the points, sorted, are inverted through the cumulative distribution
+/// of the weights in this order. The remaining `dim()` coordinates of each
+/// point are kept for the following move, available through `points()`.
+/// The `k`th row of `points()` shall be used to move the particle
+/// `order()[k]`, after the replication numbers have been applied by
+/// Particle::resample.
+///
+/// All copies of an object share the points and the order, and the state
+/// matrix, which shall outlive them. A typical usage is,
+/// ~~~{.cpp}
+/// ResampleSQMC<SobolSequence<>> sqmc(sampler.particle().value());
+/// sampler.resample_scheme(sqmc).resample_threshold(
+///     resample_threshold_always());
+/// // In the move
+/// for (std::size_t k = 0; k != N; ++k)
+///     propagate(sqmc.order()[k], sqmc.points() + k * sqmc.dim());
+/// ~~~
+/// The initialization can use `generate` to obtain its own points.
+template <typename QMCType>
+class ResampleSQMC
+{
+    public:
+    using qmc_type = QMCType;
+    using result_type = typename QMCType::result_type;
+
+    /// \brief Construct the resampling operation for a state matrix
+    ///
+    /// \param state The state matrix of the particle system
+    /// \param dim The number of coordinates of each point used by the move.
+    /// If it is zero, then the dimension of the state is used.
+    template <MatrixLayout Layout, std::size_t Dim, typename T>
+    explicit ResampleSQMC(
+        const StateMatrix<Layout, Dim, T> &state, std::size_t dim = 0)
+        : data_(std::make_shared<data_type>(dim == 0 ? state.dim() : dim))
+    {
+        const StateMatrix<Layout, Dim, T> *const s = &state;
+        data_->size = [s]() { return static_cast<std::size_t>(s->size()); };
+        data_->sort = [s](std::size_t *index) {
+            hilbert_sort(Layout, static_cast<std::size_t>(s->size()),
+                s->dim(), s->data(), s->stride(), index);
+        };
+    }
+
+    /// \brief The number of coordinates of each point used by the move
+    std::size_t dim() const { return data_->dim; }
+
+    /// \brief The points for the move, an `N` by `dim()` row major matrix
+    const result_type *points() const { return data_->points.data(); }
+
+    /// \brief The particle to be moved with each row of `points()`
+    const std::size_t *order() const { return data_->order.data(); }
+
+    /// \brief Generate `N` points without resampling, e.g., for the
+    /// initialization, with `order()` being the identity
+    template <typename RNGType>
+    void generate(RNGType &rng, std::size_t N)
+    {
+        data_type &d = *data_;
+        const std::size_t D = d.dim + 1;
+        d.qmc.scramble(rng);
+        d.pts.resize(N * D);
+        d.qmc(N, d.pts.data());
+        d.points.resize(N * d.dim);
+        d.order.resize(N);
+        for (std::size_t k = 0; k != N; ++k) {
+            std::copy_n(d.pts.data() + k * D + 1, d.dim,
+                d.points.data() + k * d.dim);
+            d.order[k] = k;
+        }
+    }
+
+    template <typename IntType, typename RNGType, typename RealType>
+    void operator()(std::size_t M, std::size_t N, RNGType &rng,
+        const RealType *weight, IntType *replication)
+    {
+        VSMC_RUNTIME_ASSERT_RESAMPLE_SQMC_SIZE(M);
+
+        data_type &d = *data_;
+        const std::size_t D = d.dim + 1;
+
+        // Order the particles along the Hilbert curve
+        d.hilbert.resize(M);
+        d.sort(d.hilbert.data());
+
+        // Order the points by their first coordinates
+        d.qmc.scramble(rng);
+        d.pts.resize(N * D);
+        d.qmc(N, d.pts.data());
+        d.perm.resize(N);
+        for (std::size_t k = 0; k != N; ++k)
+            d.perm[k] = k;
+        const result_type *const pts = d.pts.data();
+        std::sort(d.perm.begin(), d.perm.end(),
+            [pts, D](std::size_t a, std::size_t b) {
+                return pts[a * D] < pts[b * D];
+            });
+
+        // Invert the sorted uniforms through the Hilbert ordered weights
+        d.u.resize(N);
+        d.w.resize(M);
+        d.rep.resize(M);
+        for (std::size_t k = 0; k != N; ++k)
+            d.u[k] = static_cast<double>(pts[d.perm[k] * D]);
+        for (std::size_t k = 0; k != M; ++k)
+            d.w[k] = weight[d.hilbert[k]];
+        resample_trans_u01_rep(M, N, d.w.data(), d.u.data(), d.rep.data());
+        for (std::size_t k = 0; k != M; ++k)
+            replication[d.hilbert[k]] = static_cast<IntType>(d.rep[k]);
+
+        // The resampled particles in the Hilbert order of their parents,
+        // which is the order of the points
+        d.idx.resize(N);
+        d.rank.resize(M);
+        resample_trans_rep_index(M, N, replication, d.idx.data());
+        std::size_t offset = 0;
+        for (std::size_t k = 0; k != M; ++k) {
+            d.rank[d.hilbert[k]] = offset;
+            offset += d.rep[k];
+        }
+        d.order.resize(N);
+        for (std::size_t j = 0; j != N; ++j)
+            d.order[d.rank[d.idx[j]]++] = j;
+
+        d.points.resize(N * d.dim);
+        for (std::size_t k = 0; k != N; ++k) {
+            std::copy_n(pts + d.perm[k] * D + 1, d.dim,
+                d.points.data() + k * d.dim);
+        }
+    }
+
+    private:
+    struct data_type {
+        data_type(std::size_t d) : dim(d), qmc(d + 1) {}
+
+        std::size_t dim;
+        QMCType qmc;
+        std::function<std::size_t()> size;
+        std::function<void(std::size_t *)> sort;
+        Vector<result_type> pts;
+        Vector<result_type> points;
+        Vector<double> u;
+        Vector<double> w;
+        Vector<std::size_t> rep;
+        Vector<std::size_t> idx;
+        Vector<std::size_t> rank;
+        Vector<std::size_t> perm;
+        Vector<std::size_t> hilbert;
+        Vector<std::size_t> order;
+    };
+
+    std::shared_ptr<data_type> data_;
+}; // class ResampleSQMC
+
+} // namespace vsmc
+
+#endif // VSMC_RESAMPLE_SQMC_HPP
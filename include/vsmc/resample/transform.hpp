@@ -39,9 +39,13 @@ namespace vsmc
 
 /// \brief Transform uniform [0, 1] sequence into replication numbers
 /// \ingroup Resample
-template <typename IntType, typename U01SeqType>
+///
+/// \details
+/// The cumulative weights are accumulated in double precision whatever the
+/// type `RealType` of the weights.
+template <typename IntType, typename RealType, typename U01SeqType>
 inline void resample_trans_u01_rep(std::size_t M, std::size_t N,
-    const double *weight, U01SeqType &&u01seq, IntType *replication)
+    const RealType *weight, U01SeqType &&u01seq, IntType *replication)
 {
     // Given N sorted U01 random variates
     // Compute M replication numbers based on M weights
@@ -72,9 +76,9 @@ inline void resample_trans_u01_rep(std::size_t M, std::size_t N,
 
 /// \brief Transform uniform [0, 1] sequence into parent indices
 /// \ingroup Resample
-template <typename IntType, typename U01SeqType>
+template <typename IntType, typename RealType, typename U01SeqType>
 inline void resample_trans_u01_index(std::size_t M, std::size_t N,
-    const double *weight, U01SeqType &&u01seq, IntType *index)
+    const RealType *weight, U01SeqType &&u01seq, IntType *index)
 {
     if (M == 0 || N == 0)
         return;
@@ -133,6 +137,54 @@ inline void resample_trans_rep_index(
     }
 }
 
+/// \brief Transform replication numbers into parent indices, such that the
+/// particles can be copied in place
+/// \ingroup Resample
+///
+/// \details
+/// The `M` replication numbers sum to `N`. Each of the first `min(M, N)`
+/// particles with at least one child is its own first child, and the other
+/// children take the remaining positions among the first `N`. Thus a
+/// particle is never overwritten before its children are copied, and a
+/// system of `max(M, N)` particles can be resampled in place. The output has
+/// `max(M, N)` elements, and the positions `N` to `M - 1`, if any, are their
+/// own parents. If `M == N`, the result is the same as
+/// resample_trans_rep_index. If `M == 0`, there is no parent and nothing is
+/// written.
+template <typename IntType1, typename IntType2>
+inline void resample_trans_rep_index_inplace(
+    std::size_t M, std::size_t N, const IntType1 *replication, IntType2 *index)
+{
+    if (M == 0)
+        return;
+
+    if (N == 0) {
+        for (std::size_t dst = 0; dst != M; ++dst)
+            index[dst] = static_cast<IntType2>(dst);
+        return;
+    }
+
+    const std::size_t K = std::min(M, N);
+    IntType1 time = 0;
+    std::size_t src = 0;
+    for (std::size_t dst = 0; dst != N; ++dst) {
+        if (dst < K && replication[dst] != 0) {
+            index[dst] = static_cast<IntType2>(dst);
+        } else {
+            // move src to a position with more children left than those
+            // assigned, the first of which is itself if src < K
+            while (time + (src < K ? 1 : 0) >= replication[src]) {
+                time = 0;
+                ++src;
+            }
+            index[dst] = static_cast<IntType2>(src);
+            ++time;
+        }
+    }
+    for (std::size_t dst = N; dst < M; ++dst)
+        index[dst] = static_cast<IntType2>(dst);
+}
+
 /// \brief Transform parent indices into replication numbers
 /// \ingroup Resample
 template <typename IntType1, typename IntType2>
@@ -151,18 +203,22 @@ inline void resample_trans_index_rep(
 /// \brief Transform normalized weights to normalized residual and integrals,
 /// and return the number of remaining elements to be resampled
 /// \ingroup Resample
-template <typename IntType>
+template <typename IntType, typename RealType>
 inline std::size_t resample_trans_residual(std::size_t M, std::size_t N,
-    const double *weight, double *resid, IntType *integ)
+    const RealType *weight, RealType *resid, IntType *integ)
 {
     double integral = 0;
+    double sum = 0;
+    IntType R = 0;
     const double coeff = static_cast<double>(N);
     for (std::size_t i = 0; i != M; ++i) {
-        resid[i] = std::modf(coeff * weight[i], &integral);
+        const double r = std::modf(coeff * weight[i], &integral);
+        resid[i] = static_cast<RealType>(r);
         integ[i] = static_cast<IntType>(integral);
+        sum += r;
+        R += integ[i];
     }
-    mul(M, 1 / std::accumulate(resid, resid + M, 0.0), resid, resid);
-    IntType R = std::accumulate(integ, integ + M, static_cast<IntType>(0));
+    mul(M, static_cast<RealType>(1 / sum), resid, resid);
 
     return N - static_cast<std::size_t>(R);
 }
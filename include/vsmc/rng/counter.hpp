@@ -389,6 +389,47 @@ class CounterEngine
             r[i] = operator()();
     }
 
+    /// \brief Generate random integers into stack tiles and transform them
+    ///
+    /// \details
+    /// Generate exactly the same `n` random integers as `operator()(n, r)`.
+    /// However, instead of storing them into an output buffer, they are
+    /// generated into stack tiles of at most 1024 integers, and `op(k, u)` is
+    /// called for each tile, where `u` points to the `k` integers of the
+    /// tile. This allows the integers to be transformed while they are still
+    /// in the L1 cache, without an intermediate buffer.
+    template <typename BlockOp>
+    void generate(std::size_t n, BlockOp &&op)
+    {
+        const std::size_t remain = M_ - index_;
+
+        if (n <= remain) {
+            if (n != 0)
+                op(n, buffer_.data() + index_);
+            index_ += n;
+            return;
+        }
+
+        if (remain != 0)
+            op(remain, buffer_.data() + index_);
+        n -= remain;
+        index_ = M_;
+
+        const std::size_t k = 1024 / M_ == 0 ? 1 : 1024 / M_;
+        alignas(32) std::array<result_type, M_> tile[k];
+        while (n >= M_) {
+            const std::size_t b = std::min(n / M_, k);
+            generator_(ctr_, key_, b, tile);
+            op(b * M_, tile[0].data());
+            n -= b * M_;
+        }
+        if (n != 0) {
+            generator_(ctr_, key_, buffer_);
+            op(n, buffer_.data());
+            index_ = n;
+        }
+    }
+
     void discard(result_type nskip)
     {
         std::size_t n = static_cast<std::size_t>(nskip);
@@ -42,6 +42,71 @@
 namespace vsmc
 {
 
+namespace internal
+{
+
+/// \brief Construct the Walker alias table of normalized weights
+///
+/// \details
+/// Vose's algorithm. On return, `prob[i]` is the probability of accepting
+/// `i` and `alias[i]` the index returned otherwise. The table can be
+/// constructed in \f$O(N)\f$ time and each draw using it costs \f$O(1)\f$.
+template <typename RealType>
+inline void discrete_alias_table(
+    std::size_t n, const RealType *w, double *prob, std::size_t *alias)
+{
+    if (n == 0)
+        return;
+
+    Vector<std::size_t> work(n);
+    std::size_t *const small = work.data();
+    std::size_t *large = work.data() + n;
+    std::size_t ns = 0;
+    const double coeff = static_cast<double>(n);
+    for (std::size_t i = 0; i != n; ++i) {
+        prob[i] = coeff * w[i];
+        alias[i] = i;
+        if (prob[i] < 1)
+            small[ns++] = i;
+        else
+            *--large = i;
+    }
+
+    std::size_t *const last = work.data() + n;
+    while (ns != 0 && large != last) {
+        const std::size_t s = small[--ns];
+        const std::size_t l = *large;
+        alias[s] = l;
+        prob[l] -= 1 - prob[s];
+        if (prob[l] < 1) {
+            ++large;
+            small[ns++] = l;
+        }
+    }
+    while (large != last)
+        prob[*large++] = 1;
+    while (ns != 0)
+        prob[small[--ns]] = 1;
+}
+
+/// \brief Draw a sample using the Walker alias table
+template <typename IntType, typename RNGType>
+inline IntType discrete_alias_draw(
+    RNGType &rng, std::size_t n, const double *prob, const std::size_t *alias)
+{
+    U01CODistribution<double> u01;
+    double u = u01(rng) * static_cast<double>(n);
+    std::size_t i = static_cast<std::size_t>(u);
+    if (i >= n)
+        i = n - 1;
+
+    return static_cast<IntType>(u - static_cast<double>(i) < prob[i] ?
+            i :
+            alias[i]);
+}
+
+} // namespace vsmc::internal
+
 /// \brief Draw a single sample given weights
 /// \ingroup Distribution
 template <typename IntType>
@@ -86,6 +151,8 @@ class DiscreteDistribution
 
         Vector<double> probability() const { return probability_; }
 
+        std::size_t size() const { return probability_.size(); }
+
         friend bool operator==(
             const param_type &param1, const param_type &param2)
         {
@@ -142,6 +209,7 @@ class DiscreteDistribution
                     mul(probability.size(), 1 / sum, probability.data(),
                         probability.data());
                     param.probability_ = std::move(probability);
+                    param.alias_table();
                 } else {
                     is.setstate(std::ios_base::failbit);
                 }
@@ -152,6 +220,8 @@ class DiscreteDistribution
 
         private:
         Vector<double> probability_;
+        Vector<double> alias_prob_;
+        Vector<std::size_t> alias_index_;
 
         friend distribution_type;
 
@@ -169,6 +239,15 @@ class DiscreteDistribution
 #endif
             mul(probability_.size(), 1 / sum, probability_.data(),
                 probability_.data());
+            alias_table();
+        }
+
+        void alias_table()
+        {
+            alias_prob_.resize(probability_.size());
+            alias_index_.resize(probability_.size());
+            internal::discrete_alias_table(probability_.size(),
+                probability_.data(), alias_prob_.data(), alias_index_.data());
         }
 
         void reset() {}
@@ -202,7 +281,7 @@ class DiscreteDistribution
     template <typename UnaryOperation>
     DiscreteDistribution(
         std::size_t count, double xmin, double xmax, UnaryOperation &&unary_op)
-        : param_type(count, xmin, xmax, std::forward<UnaryOperation>(unary_op))
+        : param_(count, xmin, xmax, std::forward<UnaryOperation>(unary_op))
     {
     }
 
@@ -217,16 +296,39 @@ class DiscreteDistribution
 
     result_type max() const
     {
-        return param_.size() == 0 ? 0 : param_.size() - 1;
+        return param_.size() == 0 ? 0 :
+                                    static_cast<result_type>(param_.size() - 1);
     }
 
     Vector<double> probability() const { return param_.probability_; }
 
+    void reset() {}
+
+    const param_type &param() const { return param_; }
+
+    void param(const param_type &param) { param_ = param; }
+
+    void param(param_type &&param) { param_ = std::move(param); }
+
+    /// \brief Draw sample using the Walker alias table of the parameters
+    ///
+    /// \details
+    /// The alias table is constructed once together with the parameters.
+    /// Each draw costs \f$O(1)\f$ regardless of the number of weights
     template <typename RNGType>
     result_type operator()(RNGType &rng) const
     {
-        return operator()(
-            rng, param_.probability_.begin(), param_.probability_.end(), true);
+        return operator()(rng, param_);
+    }
+
+    template <typename RNGType>
+    result_type operator()(RNGType &rng, const param_type &param) const
+    {
+        if (param.size() == 0)
+            return 0;
+
+        return internal::discrete_alias_draw<result_type>(rng, param.size(),
+            param.alias_prob_.data(), param.alias_index_.data());
     }
 
     /// \brief Draw sample with external probabilities
@@ -38,6 +38,7 @@
 #include <vsmc/rng/chi_squared_distribution.hpp>
 #include <vsmc/rng/discrete_distribution.hpp>
 #include <vsmc/rng/exponential_distribution.hpp>
+#include <vsmc/rng/exponential_ziggurat_distribution.hpp>
 #include <vsmc/rng/extreme_value_distribution.hpp>
 #include <vsmc/rng/fisher_f_distribution.hpp>
 #include <vsmc/rng/gamma_distribution.hpp>
@@ -47,6 +48,7 @@
 #include <vsmc/rng/lognormal_distribution.hpp>
 #include <vsmc/rng/normal_distribution.hpp>
 #include <vsmc/rng/normal_mv_distribution.hpp>
+#include <vsmc/rng/normal_ziggurat_distribution.hpp>
 #include <vsmc/rng/pareto_distribution.hpp>
 #include <vsmc/rng/rayleigh_distribution.hpp>
 #include <vsmc/rng/student_t_distribution.hpp>
@@ -80,10 +80,11 @@ template <typename RealType, typename RNGType>
 inline void exponential_distribution_impl(
     RNGType &rng, std::size_t n, RealType *r, RealType lambda)
 {
-    u01_distribution(rng, n, r);
-    sub(n, static_cast<RealType>(1), r, r);
-    log(n, r, r);
-    mul(n, -1 / lambda, r, r);
+    u01_distribution_tile(rng, n, r, [r, lambda](std::size_t i, std::size_t k) {
+        sub(k, static_cast<RealType>(1), r + i, r + i);
+        log(k, r + i, r + i);
+        mul(k, -1 / lambda, r + i, r + i);
+    });
 }
 
 } // namespace vsmc::internal
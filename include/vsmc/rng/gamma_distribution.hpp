@@ -235,31 +235,32 @@ inline std::size_t gamma_distribution_impl_t(RNGType &rng, std::size_t n,
 {
     const RealType d = constant.d;
     const RealType c = constant.c;
-    RealType s[K * 3];
+    RealType s[K * 2];
     RealType *const u = s;
     RealType *const e = s + n;
-    RealType *const x = s + n * 2;
-
-    u01_distribution(rng, n * 2, s);
-    log(n, e, e);
-    mul(n, static_cast<RealType>(-1), e, e);
-    for (std::size_t i = 0; i != n; ++i) {
-        if (u[i] > d) {
-            u[i] = -std::log(c * (1 - u[i]));
-            e[i] += u[i];
-            u[i] = d + alpha * u[i];
-        }
-    }
-    log(n, u, x);
-    mul(n, c, x, x);
-    exp(n, x, x);
-    abs(n, x, u);
-    mul(n, beta, x, x);
 
+    // Each tile of e is transformed, together with the corresponding part of
+    // u, as soon as it is generated
     std::size_t m = 0;
-    for (std::size_t i = 0; i != n; ++i)
-        if (u[i] < e[i])
-            r[m++] = x[i];
+    u01_distribution_tile(rng, n * 2, s, [&](std::size_t i, std::size_t k) {
+        if (i + k <= n)
+            return;
+        const std::size_t p = std::max(i, n) - n;
+        const std::size_t q = i + k - n;
+        vmath::eval(q - p, e + p, -vmath::log(vmath::arg(e + p)));
+        for (std::size_t j = p; j != q; ++j) {
+            if (u[j] > d) {
+                u[j] = -std::log(c * (1 - u[j]));
+                e[j] += u[j];
+                u[j] = d + alpha * u[j];
+            }
+        }
+        vmath::eval(
+            q - p, u + p, vmath::exp(c * vmath::log(vmath::arg(u + p))));
+        for (std::size_t j = p; j != q; ++j)
+            if (u[j] < e[j])
+                r[m++] = beta * u[j];
+    });
 
     return m;
 }
@@ -276,20 +277,22 @@ inline std::size_t gamma_distribution_impl_w(RNGType &rng, std::size_t n,
     RealType *const e = s + n;
     RealType *const x = s + n * 2;
 
-    u01_distribution(rng, n * 2, s);
-    log(n * 2, s, s);
-    mul(n * 2, static_cast<RealType>(-1), s, s);
-    log(n, s, x);
-    mul(n, c, x, x);
-    exp(n, x, x);
-    add(n, u, e, u);
-    add(n, d, x, e);
-    mul(n, beta, x, x);
-
     std::size_t m = 0;
-    for (std::size_t i = 0; i != n; ++i)
-        if (u[i] > e[i])
-            r[m++] = x[i];
+    u01_distribution_tile(rng, n * 2, s, [&](std::size_t i, std::size_t k) {
+        vmath::eval(k, s + i, -vmath::log(vmath::arg(s + i)));
+        if (i < n) {
+            const std::size_t j = std::min(i + k, n);
+            vmath::eval(j - i, x + i,
+                vmath::exp(c * vmath::log(vmath::arg(u + i))));
+        }
+        if (i + k <= n)
+            return;
+        const std::size_t p = std::max(i, n) - n;
+        const std::size_t q = i + k - n;
+        for (std::size_t j = p; j != q; ++j)
+            if (u[j] + e[j] > d + x[j])
+                r[m++] = beta * x[j];
+    });
 
     return m;
 }
@@ -301,17 +304,16 @@ inline std::size_t gamma_distribution_impl_n(RNGType &rng, std::size_t n,
 {
     const RealType d = constant.d;
     const RealType c = constant.c;
-    RealType s[K * 5];
+    RealType s[K * 4];
     RealType *const u = s;
     RealType *const e = s + n;
     RealType *const v = s + n * 2;
     RealType *const w = s + n * 3;
-    RealType *const x = s + n * 4;
 
     u01_distribution(rng, n, u);
     normal_distribution(
         rng, n, w, static_cast<RealType>(0), static_cast<RealType>(1));
-    fma(n, c, w, static_cast<RealType>(1), v);
+    vmath::eval(n, v, c * vmath::arg(w) + 1);
     NormalDistribution<RealType> rnorm(0, 1);
     for (std::size_t i = 0; i != n; ++i) {
         if (v[i] <= 0) {
@@ -321,21 +323,21 @@ inline std::size_t gamma_distribution_impl_n(RNGType &rng, std::size_t n,
             } while (v[i] <= 0);
         }
     }
-    sqr(n, v, e);
-    mul(n, v, e, v);
-    sqr(n, w, e);
-    sqr(n, e, e);
-    fma(n, -static_cast<RealType>(0.0331), e, static_cast<RealType>(1), e);
-    mul(n, d * beta, v, x);
+    const auto av = vmath::arg(v);
+    const auto aw = vmath::arg(w);
+    vmath::eval(n, v, av * vmath::sqr(av));
+    vmath::eval(
+        n, e, 1 - static_cast<RealType>(0.0331) * vmath::sqr(vmath::sqr(aw)));
 
+    const RealType dbeta = d * beta;
     std::size_t m = 0;
     for (std::size_t i = 0; i != n; ++i) {
         if (u[i] < e[i]) {
-            r[m++] = x[i];
+            r[m++] = dbeta * v[i];
         } else {
             e[i] = w[i] * w[i] / 2 + d * (1 - v[i] + std::log(v[i]));
             if (std::log(u[i]) < e[i])
-                r[m++] = x[i];
+                r[m++] = dbeta * v[i];
         }
     }
 
@@ -347,9 +349,9 @@ inline std::size_t gamma_distribution_impl_e(RNGType &rng, std::size_t n,
     RealType *r, RealType, RealType beta,
     const GammaDistributionConstant<RealType> &)
 {
-    u01_distribution(rng, n, r);
-    log(n, r, r);
-    mul(n, -beta, r, r);
+    u01_distribution_tile(rng, n, r, [r, beta](std::size_t i, std::size_t k) {
+        vmath::eval(k, r + i, -beta * vmath::log(vmath::arg(r + i)));
+    });
 
     return n;
 }
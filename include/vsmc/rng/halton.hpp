@@ -0,0 +1,169 @@
+//============================================================================
+// vSMC/include/vsmc/rng/halton.hpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c) 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#ifndef VSMC_RNG_HALTON_HPP
+#define VSMC_RNG_HALTON_HPP
+
+#include <vsmc/rng/internal/common.hpp>
+#include <vsmc/rng/uniform_bits_distribution.hpp>
+
+#define VSMC_RUNTIME_ASSERT_RNG_HALTON_DIM(dim)                               \
+    VSMC_RUNTIME_ASSERT(                                                      \
+        (dim > 0), "**HaltonSequence** CONSTRUCTED WITH INVALID DIMENSION")
+
+namespace vsmc
+{
+
+/// \brief Halton sequence with optional random scrambling
+/// \ingroup QMC
+///
+/// \details
+/// The \f$j\f$th coordinate of the \f$n\f$th point is the radical inverse of
+/// \f$n + 1\f$ in the base of the \f$j\f$th prime number. The sequence has no
+/// limit on the dimension, though the quality of the high dimensional
+/// projections degrades without scrambling. The radical inverses are
+/// accumulated in at least double precision, and those rounded up to one are
+/// replaced by the largest `RealType` below one, such that each point lies
+/// strictly within \f$(0, 1)^d\f$.
+///
+/// `seek` computes any point directly, such that blocks of a sequence can be
+/// generated independently, e.g., in parallel. `scramble` applies a random
+/// permutation of the nonzero digits of each base, which breaks the
+/// correlations between the coordinates of large prime bases.
+template <typename RealType>
+class HaltonSequence
+{
+    static_assert(std::is_floating_point<RealType>::value,
+        "**HaltonSequence** USED WITH RealType OTHER THAN FLOATING POINT "
+        "TYPES");
+
+    public:
+    using result_type = RealType;
+
+    explicit HaltonSequence(std::size_t dim)
+        : dim_(dim), index_(0), base_(dim), offset_(dim + 1)
+    {
+        VSMC_RUNTIME_ASSERT_RNG_HALTON_DIM(dim);
+
+        std::uint32_t p = 2;
+        for (std::size_t d = 0; d != dim_; ++d, ++p) {
+            while (!is_prime(p))
+                ++p;
+            base_[d] = p;
+        }
+        offset_[0] = 0;
+        for (std::size_t d = 0; d != dim_; ++d)
+            offset_[d + 1] = offset_[d] + base_[d];
+        perm_.resize(offset_.back());
+        reset();
+    }
+
+    std::size_t dim() const { return dim_; }
+
+    /// \brief The index of the next point
+    std::uint64_t index() const { return index_; }
+
+    /// \brief Remove the scrambling and restart the sequence
+    void reset()
+    {
+        for (std::size_t d = 0; d != dim_; ++d)
+            for (std::uint32_t i = 0; i != base_[d]; ++i)
+                perm_[offset_[d] + i] = i;
+        seek(0);
+    }
+
+    /// \brief Scramble the sequence with new random digit permutations, and
+    /// restart it
+    template <typename RNGType>
+    void scramble(RNGType &rng)
+    {
+        UniformBitsDistribution<std::uint32_t> rbits;
+        reset();
+        for (std::size_t d = 0; d != dim_; ++d) {
+            std::uint32_t *const s = perm_.data() + offset_[d];
+            for (std::uint32_t i = base_[d] - 1; i > 1; --i)
+                std::swap(s[i], s[1 + rbits(rng) % i]);
+        }
+    }
+
+    /// \brief Set the index of the next point
+    void seek(std::uint64_t n) { index_ = n; }
+
+    /// \brief Skip the next `n` points
+    void discard(std::uint64_t n) { index_ += n; }
+
+    /// \brief Generate the next point
+    void operator()(result_type *r)
+    {
+        using acc_type = typename std::common_type<double, result_type>::type;
+
+        const result_type xmax = std::nextafter(
+            static_cast<result_type>(1), static_cast<result_type>(0));
+        const std::uint64_t n = ++index_;
+        for (std::size_t d = 0; d != dim_; ++d) {
+            const std::uint32_t b = base_[d];
+            const std::uint32_t *const s = perm_.data() + offset_[d];
+            const acc_type inv = static_cast<acc_type>(1) / b;
+            acc_type f = inv;
+            acc_type x = 0;
+            for (std::uint64_t k = n; k != 0; k /= b, f *= inv)
+                x += s[k % b] * f;
+            r[d] = std::min(static_cast<result_type>(x), xmax);
+        }
+    }
+
+    /// \brief Generate the next `n` points as an `n` by `dim()` row major
+    /// matrix
+    void operator()(std::size_t n, result_type *r)
+    {
+        for (std::size_t i = 0; i != n; ++i, r += dim_)
+            operator()(r);
+    }
+
+    private:
+    std::size_t dim_;
+    std::uint64_t index_;
+    Vector<std::uint32_t> base_;
+    Vector<std::size_t> offset_;
+    Vector<std::uint32_t> perm_;
+
+    static bool is_prime(std::uint32_t p)
+    {
+        for (std::uint32_t q = 2; q * q <= p; ++q)
+            if (p % q == 0)
+                return false;
+        return true;
+    }
+}; // class HaltonSequence
+
+} // namespace vsmc
+
+#endif // VSMC_RNG_HALTON_HPP
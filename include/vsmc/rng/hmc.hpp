@@ -0,0 +1,523 @@
+//============================================================================
+// vSMC/include/vsmc/rng/hmc.hpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c) 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#ifndef VSMC_RNG_HMC_HPP
+#define VSMC_RNG_HMC_HPP
+
+#include <vsmc/rng/internal/common.hpp>
+#include <vsmc/rng/normal_distribution.hpp>
+#include <vsmc/rng/u01_distribution.hpp>
+#include <vsmc/utility/covariance.hpp>
+
+#define VSMC_RUNTIME_ASSERT_RNG_HMC_PARAM(flag, Name)                         \
+    VSMC_RUNTIME_ASSERT(                                                      \
+        (flag), "**" #Name "** CONSTRUCTED WITH INVALID PARAMETERS")
+
+namespace vsmc
+{
+
+namespace internal
+{
+
+template <std::size_t Dim, typename RealType>
+inline bool hmc_check_param(std::size_t dim, std::size_t steps,
+    RealType step_size, RealType target)
+{
+    return (Dim == Dynamic || dim == Dim) && dim != 0 && steps != 0 &&
+        step_size >= 0 && target > 0 && target < 1;
+}
+
+inline void hmc_trmv(std::size_t dim, const float *l, float *x, bool trans)
+{
+    ::cblas_strmv(::CblasRowMajor, ::CblasLower,
+        trans ? ::CblasTrans : ::CblasNoTrans, ::CblasNonUnit,
+        static_cast<VSMC_CBLAS_INT>(dim), l, static_cast<VSMC_CBLAS_INT>(dim),
+        x, 1);
+}
+
+inline void hmc_trmv(std::size_t dim, const double *l, double *x, bool trans)
+{
+    ::cblas_dtrmv(::CblasRowMajor, ::CblasLower,
+        trans ? ::CblasTrans : ::CblasNoTrans, ::CblasNonUnit,
+        static_cast<VSMC_CBLAS_INT>(dim), l, static_cast<VSMC_CBLAS_INT>(dim),
+        x, 1);
+}
+
+inline void hmc_trmm(
+    std::size_t n, std::size_t dim, const float *l, float *x, bool trans)
+{
+    ::cblas_strmm(::CblasRowMajor, ::CblasRight, ::CblasLower,
+        trans ? ::CblasNoTrans : ::CblasTrans, ::CblasNonUnit,
+        static_cast<VSMC_CBLAS_INT>(n), static_cast<VSMC_CBLAS_INT>(dim), 1,
+        l, static_cast<VSMC_CBLAS_INT>(dim), x,
+        static_cast<VSMC_CBLAS_INT>(dim));
+}
+
+inline void hmc_trmm(
+    std::size_t n, std::size_t dim, const double *l, double *x, bool trans)
+{
+    ::cblas_dtrmm(::CblasRowMajor, ::CblasRight, ::CblasLower,
+        trans ? ::CblasNoTrans : ::CblasTrans, ::CblasNonUnit,
+        static_cast<VSMC_CBLAS_INT>(n), static_cast<VSMC_CBLAS_INT>(dim), 1,
+        l, static_cast<VSMC_CBLAS_INT>(dim), x,
+        static_cast<VSMC_CBLAS_INT>(dim));
+}
+
+/// \brief Leapfrog integrator and Metropolis correction shared by MALA and
+/// HMC
+///
+/// \details
+/// The inverse mass matrix \f$M^{-1} = LL^T\f$ is either diagonal or dense.
+/// Integration is performed in the whitened coordinates \f$x = Lz\f$ with
+/// standard Normal momentum, such that each leapfrog step costs one
+/// multiplication by \f$L\f$ and one by \f$L^T\f$, and each is a single
+/// `?trmm` call for a batch of particles.
+template <typename RealType, std::size_t Dim>
+class HMCBase
+{
+    public:
+    using result_type = RealType;
+
+    std::size_t dim() const { return dim_; }
+
+    /// \brief The number of leapfrog steps of each update
+    std::size_t steps() const { return steps_; }
+
+    /// \brief The leapfrog step size
+    result_type step_size() const { return step_size_; }
+
+    /// \brief The target acceptance rate
+    result_type target() const { return target_; }
+
+    /// \brief If the inverse mass matrix is dense
+    bool dense() const { return dense_; }
+
+    /// \brief Record the acceptance count of the last updates of `n`
+    /// particles, used by the next call to `update`
+    void accept(std::size_t acc, std::size_t n)
+    {
+        if (n != 0)
+            rate_ = static_cast<result_type>(acc) / static_cast<result_type>(n);
+    }
+
+    /// \brief Adapt the step size and re-estimate the mass matrix from the
+    /// particle system
+    ///
+    /// \details
+    /// The step size is multiplied by \f$\exp(r - r^*)\f$, where \f$r\f$ is
+    /// the acceptance rate recorded by `accept` since the last update and
+    /// \f$r^*\f$ is the target rate. The inverse mass matrix is set to the
+    /// covariance, or its diagonal, of the weighted particle system.
+    ///
+    /// \param layout The storage layout of `x`
+    /// \param n The number of particles
+    /// \param x The values of the particles, an `n` by `dim()` matrix
+    /// \param w The weights. If it is a null pointer, then all particles have
+    /// equal weights.
+    /// \param dense If `true`, use the full covariance matrix. Otherwise use
+    /// only the variances.
+    ///
+    /// \return `false` if the (diagonal) covariance matrix is not positive
+    /// definite, in which case the mass matrix of the previous update is kept
+    bool update(MatrixLayout layout, std::size_t n, const result_type *x,
+        const result_type *w, bool dense = false)
+    {
+        step_size_ *= std::exp(rate_ - target_);
+        rate_ = target_;
+
+        const std::size_t d = dim();
+        cov_(layout, n, d, x, w, nullptr, work_.data(), RowMajor, false,
+            true);
+        if (dense) {
+            if (cov_chol(d, work_.data(), work_.data(), RowMajor, false,
+                    true) != 0) {
+                return false;
+            }
+            std::fill(l_.begin(), l_.end(), 0);
+            const result_type *c = work_.data();
+            for (std::size_t i = 0; i != d; ++i)
+                for (std::size_t j = 0; j <= i; ++j)
+                    l_[i * d + j] = *c++;
+        } else {
+            for (std::size_t i = 0; i != d; ++i)
+                if (!(work_[i * (i + 1) / 2 + i] > 0))
+                    return false;
+            for (std::size_t i = 0; i != d; ++i)
+                sd_[i] = std::sqrt(work_[i * (i + 1) / 2 + i]);
+        }
+        dense_ = dense;
+
+        return true;
+    }
+
+    /// \brief One-step update
+    ///
+    /// \param rng RNG engine
+    /// \param x The current state value. It will be updated to the new value
+    /// after the MCMC move.
+    /// \param ltx If it is a non-null pointer, then it will be updated to the
+    /// value of \f$\log\gamma(x)\f$ after the MCMC move.
+    /// \param gx If both `ltx` and `gx` are non-null pointers, then they
+    /// point to the value and gradient of \f$\log\gamma(x)\f$ at the current
+    /// state, and both will be updated if the move is accepted. This saves
+    /// one evaluation of the log-target function for each update. Otherwise,
+    /// the log-target function is evaluated at the current state first.
+    /// \param log_target The log-target function
+    /// ~~~{.cpp}
+    /// result_type log_target(std::size_t dim, const result_type *x,
+    ///     result_type *grad);
+    /// ~~~
+    /// It returns the value of \f$\log\gamma(x)\f$ and writes its gradient to
+    /// `grad`.
+    ///
+    /// \return Acceptance count
+    template <typename RNGType, typename LogTargetType>
+    std::size_t operator()(RNGType &rng, result_type *x, result_type *ltx,
+        result_type *gx, LogTargetType &&log_target) const
+    {
+        const std::size_t d = dim();
+        Array<RealType, Dim * 4> work;
+        resize(work, d * 4);
+        result_type *const y = work.data();
+        result_type *const v = y + d;
+        result_type *const g = v + d;
+        result_type *const t = g + d;
+
+        result_type s = 0;
+        if (ltx != nullptr && gx != nullptr) {
+            s = *ltx;
+            std::copy_n(gx, d, g);
+        } else {
+            s = log_target(d, const_cast<const result_type *>(x), g);
+        }
+        normal_distribution(
+            rng, d, v, static_cast<result_type>(0), static_cast<result_type>(1));
+        const result_type k = kinetic(d, v);
+        std::copy_n(x, d, y);
+        result_type lt = 0;
+        leapfrog(1, y, v, g, t, [&](const result_type *z, result_type *h) {
+            lt = log_target(d, z, h);
+        });
+
+        U01Distribution<result_type> u01;
+        if (std::log(u01(rng)) < lt - kinetic(d, v) - s + k) {
+            std::copy_n(y, d, x);
+            if (ltx != nullptr)
+                *ltx = lt;
+            if (gx != nullptr)
+                std::copy_n(g, d, gx);
+            return 1;
+        }
+        if (ltx != nullptr)
+            *ltx = s;
+
+        return 0;
+    }
+
+    /// \brief One-step update without caching the gradient
+    template <typename RNGType, typename LogTargetType>
+    std::size_t operator()(RNGType &rng, result_type *x, result_type *ltx,
+        LogTargetType &&log_target) const
+    {
+        return operator()(rng, x, ltx, static_cast<result_type *>(nullptr),
+            std::forward<LogTargetType>(log_target));
+    }
+
+    /// \brief Multi-step update
+    template <typename RNGType, typename LogTargetType>
+    std::size_t operator()(std::size_t n, RNGType &rng, result_type *x,
+        result_type *ltx, result_type *gx, LogTargetType &&log_target) const
+    {
+        const std::size_t d = dim();
+        Array<RealType, Dim> g;
+        resize(g, d);
+
+        result_type s = 0;
+        if (ltx != nullptr && gx != nullptr) {
+            s = *ltx;
+            std::copy_n(gx, d, g.data());
+        } else {
+            s = log_target(d, const_cast<const result_type *>(x), g.data());
+        }
+        std::size_t acc = 0;
+        for (std::size_t i = 0; i != n; ++i) {
+            acc += operator()(rng, x, &s, g.data(),
+                std::forward<LogTargetType>(log_target));
+        }
+        if (ltx != nullptr)
+            *ltx = s;
+        if (gx != nullptr)
+            std::copy_n(g.data(), d, gx);
+
+        return acc;
+    }
+
+    /// \brief One-step update of a batch of particles
+    ///
+    /// \param rng RNG engine
+    /// \param n The number of particles
+    /// \param x The current state values, stored as an `n` by `dim()` row
+    /// major matrix
+    /// \param ltx If it is a non-null pointer, then it points to an array of
+    /// length `n`, updated to the values of \f$\log\gamma(x)\f$ after the MCMC
+    /// move
+    /// \param gx If both `ltx` and `gx` are non-null pointers, then `gx`
+    /// points to an `n` by `dim()` row major matrix, and they hold the values
+    /// and gradients of \f$\log\gamma(x)\f$ at the current states, updated
+    /// for each accepted move
+    /// \param log_target The batched log-target function
+    /// ~~~{.cpp}
+    /// void log_target(std::size_t n, std::size_t dim, const result_type *x,
+    ///     result_type *lt, result_type *grad);
+    /// ~~~
+    /// It writes the values of \f$\log\gamma(x)\f$ of the `n` rows of `x` to
+    /// `lt`, and their gradients to the rows of `grad`.
+    ///
+    /// \return Acceptance count
+    template <typename RNGType, typename LogTargetType>
+    std::size_t operator()(RNGType &rng, std::size_t n, result_type *x,
+        result_type *ltx, result_type *gx, LogTargetType &&log_target) const
+    {
+        const std::size_t d = dim();
+        const std::size_t m = n * d;
+        Vector<RealType> work(m * 4 + n * 4);
+        result_type *const y = work.data();
+        result_type *const v = y + m;
+        result_type *const g = v + m;
+        result_type *const t = g + m;
+        result_type *const s = t + m;
+        result_type *const lt = s + n;
+        result_type *const p = lt + n;
+        result_type *const u = p + n;
+
+        if (ltx != nullptr && gx != nullptr) {
+            std::copy_n(ltx, n, s);
+            std::copy_n(gx, m, g);
+        } else {
+            log_target(n, d, const_cast<const result_type *>(x), s, g);
+        }
+        normal_distribution(
+            rng, m, v, static_cast<result_type>(0), static_cast<result_type>(1));
+        for (std::size_t i = 0; i != n; ++i)
+            p[i] = kinetic(d, v + i * d) - s[i];
+        std::copy_n(x, m, y);
+        leapfrog(n, y, v, g, t, [&](const result_type *z, result_type *h) {
+            log_target(n, d, z, lt, h);
+        });
+        for (std::size_t i = 0; i != n; ++i)
+            p[i] += lt[i] - kinetic(d, v + i * d);
+        u01_distribution(rng, n, u);
+        log(n, u, u);
+
+        std::size_t acc = 0;
+        for (std::size_t i = 0; i != n; ++i) {
+            if (u[i] < p[i]) {
+                std::copy_n(y + i * d, d, x + i * d);
+                if (ltx != nullptr)
+                    ltx[i] = lt[i];
+                if (gx != nullptr)
+                    std::copy_n(g + i * d, d, gx + i * d);
+                ++acc;
+            } else if (ltx != nullptr) {
+                ltx[i] = s[i];
+            }
+        }
+
+        return acc;
+    }
+
+    protected:
+    HMCBase(std::size_t dim, std::size_t steps, result_type step_size,
+        result_type target)
+        : dim_(dim)
+        , steps_(steps)
+        , step_size_(step_size)
+        , target_(target)
+        , rate_(target)
+        , dense_(false)
+    {
+        static_assert(is_one_of<RealType, float, double>::value,
+            "**HMCBase** USED WITH RealType OTHER THAN float OR double");
+
+        resize(sd_, dim);
+        resize(l_, dim * dim);
+        resize(work_, dim * (dim + 1) / 2);
+        std::fill(sd_.begin(), sd_.end(), 1);
+    }
+
+    private:
+    std::size_t dim_;
+    std::size_t steps_;
+    result_type step_size_;
+    result_type target_;
+    result_type rate_;
+    bool dense_;
+    Array<RealType, Dim> sd_;
+    Array<RealType, Dim * Dim> l_;
+    Array<RealType, Dim *(Dim + 1) / 2> work_;
+    Covariance<RealType> cov_;
+
+    static result_type kinetic(std::size_t d, const result_type *v)
+    {
+        result_type k = 0;
+        for (std::size_t i = 0; i != d; ++i)
+            k += v[i] * v[i];
+
+        return k / 2;
+    }
+
+    // Multiply each of the n rows of t by L, or by L^T if trans is true
+    void mul_chol(std::size_t n, result_type *t, bool trans) const
+    {
+        const std::size_t d = dim();
+        if (!dense_) {
+            for (std::size_t i = 0; i != n; ++i, t += d)
+                mul(d, sd_.data(), t, t);
+        } else if (n == 1) {
+            hmc_trmv(d, l_.data(), t, trans);
+        } else {
+            hmc_trmm(n, d, l_.data(), t, trans);
+        }
+    }
+
+    template <typename EvalType>
+    void leapfrog(std::size_t n, result_type *y, result_type *v,
+        result_type *g, result_type *t, EvalType &&eval) const
+    {
+        const std::size_t m = n * dim();
+        const result_type h = step_size_ / 2;
+        std::copy_n(g, m, t);
+        mul_chol(n, t, true);
+        fma(m, t, h, v, v);
+        for (std::size_t i = 0; i != steps_; ++i) {
+            std::copy_n(v, m, t);
+            mul_chol(n, t, false);
+            fma(m, t, step_size_, y, y);
+            eval(const_cast<const result_type *>(y), g);
+            std::copy_n(g, m, t);
+            mul_chol(n, t, true);
+            fma(m, t, i + 1 == steps_ ? h : step_size_, v, v);
+        }
+    }
+}; // class HMCBase
+
+} // namespace vsmc::internal
+
+/// \brief Metropolis adjusted Langevin algorithm
+/// \ingroup HMC
+///
+/// \details
+/// The proposal is \f$y = x + \frac{\epsilon^2}{2}M^{-1}\nabla\log\gamma(x) +
+/// \epsilon Lz\f$, where \f$z\f$ is a vector of standard Normal random
+/// variates, \f$M^{-1} = LL^T\f$ is the inverse mass matrix and
+/// \f$\epsilon\f$ is the step size. This is a Hamiltonian Monte Carlo update
+/// with a single leapfrog step, and the Metropolis-Hastings ratio is computed
+/// as such. The update operators are documented in HMC.
+template <typename RealType, std::size_t Dim>
+class MALA : public internal::HMCBase<RealType, Dim>
+{
+    public:
+    using result_type = RealType;
+
+    /// \brief Construct a MALA kernel with identity mass matrix
+    ///
+    /// \param dim The dimension of the state. It must be equal to `Dim` if
+    /// `Dim != Dynamic`.
+    /// \param step_size The initial step size. If it is zero, then
+    /// \f$1.65 / d^{1/6}\f$ is used.
+    /// \param target The target acceptance rate
+    explicit MALA(std::size_t dim = Dim, result_type step_size = 0,
+        result_type target = static_cast<result_type>(0.574))
+        : internal::HMCBase<RealType, Dim>(dim, 1,
+              step_size > 0 ? step_size : static_cast<result_type>(1.65) /
+                      std::pow(static_cast<result_type>(dim),
+                          static_cast<result_type>(1) / 6),
+              target)
+    {
+        VSMC_RUNTIME_ASSERT_RNG_HMC_PARAM(
+            internal::hmc_check_param<Dim>(dim, 1, step_size, target), MALA);
+    }
+}; // class MALA
+
+/// \brief Hamiltonian Monte Carlo
+/// \ingroup HMC
+///
+/// \details
+/// Each update draws a standard Normal momentum in the coordinates whitened
+/// by the inverse mass matrix \f$M^{-1} = LL^T\f$, performs `steps()`
+/// leapfrog steps of size `step_size()` and accepts the end point with the
+/// usual Metropolis-Hastings probability. The log-target function returns
+/// \f$\log\gamma(x)\f$ and writes its gradient.
+///
+/// The mass matrix is the identity until `update` is called, which sets
+/// \f$M^{-1}\f$ to the (diagonal) covariance of the weighted particle system
+/// and adapts the step size toward the target acceptance rate recorded by
+/// `accept`. A typical move calls `update` once after each resampling, for
+/// example in `eval_pre` of a MoveTBB or MoveOMP subclass.
+///
+/// All update operators are `const` and do not share any scratch space, so a
+/// single kernel can be used concurrently from `eval_sp`, with `sp.rng()`.
+/// The batched operator integrates a block of particles together, with one
+/// level-3 BLAS call for each multiplication by the dense mass matrix, and it
+/// can also be applied to disjoint blocks in parallel, each with its own RNG,
+/// e.g., from `particle.rng_set()`.
+template <typename RealType, std::size_t Dim>
+class HMC : public internal::HMCBase<RealType, Dim>
+{
+    public:
+    using result_type = RealType;
+
+    /// \brief Construct a HMC kernel with identity mass matrix
+    ///
+    /// \param dim The dimension of the state. It must be equal to `Dim` if
+    /// `Dim != Dynamic`.
+    /// \param steps The number of leapfrog steps of each update
+    /// \param step_size The initial step size. If it is zero, then
+    /// \f$1 / d^{1/4}\f$ is used.
+    /// \param target The target acceptance rate
+    explicit HMC(std::size_t dim = Dim, std::size_t steps = 10,
+        result_type step_size = 0,
+        result_type target = static_cast<result_type>(0.65))
+        : internal::HMCBase<RealType, Dim>(dim, steps,
+              step_size > 0 ? step_size : static_cast<result_type>(1) /
+                      std::pow(static_cast<result_type>(dim),
+                          static_cast<result_type>(1) / 4),
+              target)
+    {
+        VSMC_RUNTIME_ASSERT_RNG_HMC_PARAM(
+            internal::hmc_check_param<Dim>(dim, steps, step_size, target),
+            HMC);
+    }
+}; // class HMC
+
+} // namespace vsmc
+
+#endif // VSMC_RNG_HMC_HPP
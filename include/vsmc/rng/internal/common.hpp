@@ -533,15 +533,36 @@ class CounterEngine;
 template <typename = double, std::size_t = Dynamic>
 class RandomWalk;
 
+template <typename = double, std::size_t = Dynamic>
+class RandomWalkBatch;
+
 template <typename = double, std::size_t = Dynamic, std::size_t = Dynamic>
 class RandomWalkG;
 
+template <typename = double>
+class SobolSequence;
+
+template <typename = double>
+class HaltonSequence;
+
+template <typename = double, std::size_t = Dynamic>
+class MALA;
+
+template <typename = double, std::size_t = Dynamic>
+class HMC;
+
 template <typename = double>
 class NormalProposal;
 
 template <typename = double, std::size_t = Dynamic>
 class NormalMVProposal;
 
+template <typename = double>
+class NormalProposalAdaptive;
+
+template <typename = double, std::size_t = Dynamic>
+class NormalMVProposalAdaptive;
+
 template <typename = double>
 class BetaDistribution;
 
@@ -557,6 +578,9 @@ class DiscreteDistribution;
 template <typename = double>
 class ExponentialDistribution;
 
+template <typename = double>
+class ExponentialZigguratDistribution;
+
 template <typename = double>
 class ExtremeValueDistribution;
 
@@ -581,6 +605,9 @@ class LognormalDistribution;
 template <typename = double>
 class NormalDistribution;
 
+template <typename = double>
+class NormalZigguratDistribution;
+
 template <typename = double, std::size_t = Dynamic>
 class NormalMVDistribution;
 
@@ -632,6 +659,10 @@ template <typename RealType, typename RNGType>
 inline void rng_rand(
     RNGType &, ExponentialDistribution<RealType> &, std::size_t, RealType *);
 
+template <typename RealType, typename RNGType>
+inline void rng_rand(RNGType &, ExponentialZigguratDistribution<RealType> &,
+    std::size_t, RealType *);
+
 template <typename RealType, typename RNGType>
 inline void rng_rand(
     RNGType &, ExtremeValueDistribution<RealType> &, std::size_t, RealType *);
@@ -664,6 +695,10 @@ template <typename RealType, typename RNGType>
 inline void rng_rand(
     RNGType &, NormalDistribution<RealType> &, std::size_t, RealType *);
 
+template <typename RealType, typename RNGType>
+inline void rng_rand(RNGType &, NormalZigguratDistribution<RealType> &,
+    std::size_t, RealType *);
+
 template <typename RealType, std::size_t Dim, typename RNGType>
 inline void rng_rand(
     RNGType &, NormalMVDistribution<RealType, Dim> &, std::size_t, RealType *);
@@ -716,6 +751,10 @@ template <typename RealType, typename RNGType>
 inline void exponential_distribution(
     RNGType &, std::size_t, RealType *, RealType);
 
+template <typename RealType, typename RNGType>
+inline void exponential_ziggurat_distribution(
+    RNGType &, std::size_t, RealType *, RealType);
+
 template <typename RealType, typename RNGType>
 inline void extreme_value_distribution(
     RNGType &, std::size_t, RealType *, RealType, RealType);
@@ -748,6 +787,10 @@ template <typename RealType, typename RNGType>
 inline void normal_distribution(
     RNGType &, std::size_t, RealType *, RealType, RealType);
 
+template <typename RealType, typename RNGType>
+inline void normal_ziggurat_distribution(
+    RNGType &, std::size_t, RealType *, RealType, RealType);
+
 template <typename RealType, typename RNGType>
 inline void normal_mv_distribution(RNGType &, std::size_t, RealType *,
     std::size_t, const RealType *, const RealType *);
@@ -219,6 +219,10 @@ class NormalDistribution
 namespace internal
 {
 
+// Box-Muller transformation of the pairs (u1[i], u2[i]), where u1 and u2 are
+// the first and second halves of the uniforms. Each tile of the first half is
+// transformed into the radii as soon as it is generated, and each tile of the
+// second half into the variates of its pairs
 template <std::size_t K, typename RealType, typename RNGType>
 inline void normal_distribution_impl(
     RNGType &rng, std::size_t n, RealType *r, RealType mean, RealType stddev)
@@ -227,15 +231,25 @@ inline void normal_distribution_impl(
     const std::size_t nu = n / 2;
     RealType *const u1 = r;
     RealType *const u2 = r + nu;
-    u01_distribution(rng, n, r);
-    log(nu, u1, s);
-    mul(nu, static_cast<RealType>(-2), s, s);
-    sqrt(nu, s, s);
-    mul(nu, const_pi_2<RealType>(), u2, u2);
-    sincos(nu, u2, u1, u2);
-    mul(nu, stddev, s, s);
-    fma(nu, s, u1, mean, u1);
-    fma(nu, s, u2, mean, u2);
+    u01_distribution_tile(rng, n, r, [&](std::size_t i, std::size_t k) {
+        const std::size_t j = std::min(i + k, nu);
+        if (i < j) {
+            vmath::eval(j - i, s + i,
+                stddev * vmath::sqrt(-2 * vmath::log(vmath::arg(u1 + i))));
+        }
+
+        if (i + k <= nu)
+            return;
+        const std::size_t p = std::max(i, nu) - nu;
+        const std::size_t q = std::min(i + k, nu * 2) - nu;
+        if (p < q) {
+            const auto as = vmath::arg(s + p);
+            mul(q - p, const_pi_2<RealType>(), u2 + p, u2 + p);
+            sincos(q - p, u2 + p, u1 + p, u2 + p);
+            vmath::eval(q - p, u1 + p, mean + as * vmath::arg(u1 + p));
+            vmath::eval(q - p, u2 + p, mean + as * vmath::arg(u2 + p));
+        }
+    });
 }
 
 } // namespace vsmc::internal
@@ -285,8 +285,8 @@ class NormalMVDistribution
         RNGType &rng, std::size_t n, result_type *r, const param_type &param)
     {
         normal_mv_distribution(rng, n, r, param.dim(),
-            (param.null_mean_ ? param.mean() : nullptr),
-            (param.null_chol_ ? param.chol() : nullptr));
+            (param.null_mean_ ? nullptr : param.mean()),
+            (param.null_chol_ ? nullptr : param.chol()));
     }
 
     friend bool operator==(
@@ -383,6 +383,14 @@ inline void normal_mv_distribution_mulchol(
 
 /// \brief Generating multivariate Normal random varaites
 /// \ingroup Distribution
+///
+/// \details
+/// The `n` variates are stored in `r` as an `n` by `dim` row major matrix.
+/// The whole block of standard Normal variates is generated first and the
+/// Cholesky factor is then applied to all rows by a single level-3 BLAS
+/// call `?trmm`, instead of one `?tpmv` call for each variate. The arguments
+/// `mean` and `chol` are the same as those of NormalMVDistribution and either
+/// can be a null pointer.
 template <typename RealType, typename RNGType>
 inline void normal_mv_distribution(RNGType &rng, std::size_t n, RealType *r,
     std::size_t dim, const RealType *mean, const RealType *chol)
@@ -391,7 +399,8 @@ inline void normal_mv_distribution(RNGType &rng, std::size_t n, RealType *r,
         "**normal_mv_distribution** USED WITH RealType OTHER THAN float OR "
         "double");
 
-    normal_distribution(rng, n * dim, r, 0.0, 1.0);
+    normal_distribution(
+        rng, n * dim, r, static_cast<RealType>(0), static_cast<RealType>(1));
     if (chol != nullptr) {
         Vector<RealType> cholf(dim * dim);
         for (std::size_t i = 0; i != dim; ++i)
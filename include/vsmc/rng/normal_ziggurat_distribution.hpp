@@ -0,0 +1,282 @@
+//============================================================================
+// vSMC/include/vsmc/rng/normal_ziggurat_distribution.hpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c) 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#ifndef VSMC_RNG_NORMAL_ZIGGURAT_DISTRIBUTION_HPP
+#define VSMC_RNG_NORMAL_ZIGGURAT_DISTRIBUTION_HPP
+
+#include <vsmc/rng/internal/common.hpp>
+#include <vsmc/rng/u01_distribution.hpp>
+#include <vsmc/rng/uniform_bits_distribution.hpp>
+
+namespace vsmc
+{
+
+namespace internal
+{
+
+template <typename RealType>
+inline bool normal_ziggurat_distribution_check_param(
+    RealType, RealType stddev)
+{
+    return stddev > 0;
+}
+
+/// \brief Tables of the 128 layers ziggurat for the standard Normal
+/// distribution
+///
+/// \details
+/// `x(i)` is the right edge of the \f$i\f$-th layer, with `x(0)` the width
+/// of the rectangle with the same area as the base layer (including the
+/// tail), and `x(128) = 0`. `f(i)` is the density (up to a constant)
+/// evaluated at `x(i)`.
+template <typename RealType>
+class NormalZigguratTable
+{
+    public:
+    static constexpr std::size_t size() { return 128; }
+
+    static constexpr RealType r()
+    {
+        return static_cast<RealType>(3.442619855899L);
+    }
+
+    static const NormalZigguratTable<RealType> &instance()
+    {
+        static NormalZigguratTable<RealType> table;
+
+        return table;
+    }
+
+    const RealType *x() const { return x_.data(); }
+
+    const RealType *f() const { return f_.data(); }
+
+    private:
+    std::array<RealType, 129> x_;
+    std::array<RealType, 129> f_;
+
+    NormalZigguratTable()
+    {
+        const long double r = 3.442619855899L;
+        const long double v = 9.91256303526217e-3L;
+        std::array<long double, 129> x;
+        x[0] = v / std::exp(-0.5L * r * r);
+        x[1] = r;
+        for (std::size_t i = 2; i != 128; ++i) {
+            x[i] = std::sqrt(
+                -2 * std::log(v / x[i - 1] + std::exp(-0.5L * x[i - 1] *
+                                                 x[i - 1])));
+        }
+        x[128] = 0;
+        for (std::size_t i = 0; i != 129; ++i) {
+            x_[i] = static_cast<RealType>(x[i]);
+            f_[i] = static_cast<RealType>(std::exp(-0.5L * x[i] * x[i]));
+        }
+    }
+
+    NormalZigguratTable(const NormalZigguratTable<RealType> &) = delete;
+
+    NormalZigguratTable<RealType> &operator=(
+        const NormalZigguratTable<RealType> &) = delete;
+}; // class NormalZigguratTable
+
+/// \brief Convert random bits to the layer index and a uniform on `[-1, 1)`
+///
+/// \details
+/// The lower 7 bits are used for the index and the higher \f$M\f$ bits for
+/// the uniform variate, where \f$M\f$ is the number of explicitly stored
+/// significand bits of `RealType`. Thus the conversion is exact and the
+/// SIMD implementation below produces identical results.
+template <typename RealType>
+inline RealType normal_ziggurat_u(std::uint64_t s)
+{
+    static constexpr int M = std::numeric_limits<RealType>::digits - 1;
+
+    return static_cast<RealType>(s >> (64 - M)) *
+        U01ImplPow2Inv<RealType, M - 1>::value -
+        1;
+}
+
+template <typename RealType, typename RNGType>
+inline RealType normal_ziggurat_slow(
+    RNGType &rng, std::uint64_t s, RealType z)
+{
+    const NormalZigguratTable<RealType> &table =
+        NormalZigguratTable<RealType>::instance();
+    const RealType *const x = table.x();
+    const RealType *const f = table.f();
+    const RealType r = NormalZigguratTable<RealType>::r();
+    U01OODistribution<RealType> u01;
+
+    while (true) {
+        const std::size_t i = static_cast<std::size_t>(s & 0x7F);
+        if (i == 0) {
+            RealType a = 0;
+            RealType b = 0;
+            do {
+                a = -std::log(u01(rng)) / r;
+                b = -std::log(u01(rng));
+            } while (b + b < a * a);
+            return z < 0 ? -(r + a) : r + a;
+        }
+        if (f[i + 1] + u01(rng) * (f[i] - f[i + 1]) <
+            std::exp(-z * z / 2))
+            return z;
+        s = UniformBits<std::uint64_t>::eval(rng);
+        z = normal_ziggurat_u<RealType>(s) * x[s & 0x7F];
+        if (std::abs(z) < x[(s & 0x7F) + 1])
+            return z;
+    }
+}
+
+template <typename RealType>
+inline void normal_ziggurat_fast(
+    std::size_t n, const std::uint64_t *s, RealType *r)
+{
+    const RealType *const x = NormalZigguratTable<RealType>::instance().x();
+    for (std::size_t i = 0; i != n; ++i)
+        r[i] = normal_ziggurat_u<RealType>(s[i]) * x[s[i] & 0x7F];
+}
+
+#if VSMC_HAS_AVX2
+
+inline void normal_ziggurat_fast(
+    std::size_t n, const std::uint64_t *s, double *r)
+{
+    const double *const x = NormalZigguratTable<double>::instance().x();
+    const __m256i mask = _mm256_set1_epi64x(0x7F);
+    const __m256i ebits = _mm256_set1_epi64x(0x4330000000000000LL);
+    const __m256d pow52 =
+        _mm256_set1_pd(static_cast<double>(U01ImplPow2L<52>::value));
+    const __m256d pow51inv =
+        _mm256_set1_pd(U01ImplPow2Inv<double, 51>::value);
+    const __m256d one = _mm256_set1_pd(1);
+
+    const std::size_t m = n / 4 * 4;
+    for (std::size_t i = 0; i != m; i += 4) {
+        const __m256i b =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+        const __m256i k = _mm256_and_si256(b, mask);
+        const __m256i v = _mm256_or_si256(_mm256_srli_epi64(b, 12), ebits);
+        __m256d u = _mm256_sub_pd(_mm256_castsi256_pd(v), pow52);
+        u = _mm256_sub_pd(_mm256_mul_pd(u, pow51inv), one);
+        const __m256d z = _mm256_mul_pd(u, _mm256_i64gather_pd(x, k, 8));
+        _mm256_storeu_pd(r + i, z);
+    }
+    for (std::size_t i = m; i != n; ++i)
+        r[i] = normal_ziggurat_u<double>(s[i]) * x[s[i] & 0x7F];
+}
+
+#endif // VSMC_HAS_AVX2
+
+template <std::size_t K, typename RealType, typename RNGType>
+inline void normal_ziggurat_distribution_impl(
+    RNGType &rng, std::size_t n, RealType *r, RealType mean, RealType stddev)
+{
+    const RealType *const x = NormalZigguratTable<RealType>::instance().x();
+    std::uint64_t s[K];
+    uniform_bits_distribution(rng, n, s);
+    normal_ziggurat_fast(n, s, r);
+    for (std::size_t i = 0; i != n; ++i)
+        if (!(std::abs(r[i]) < x[(s[i] & 0x7F) + 1]))
+            r[i] = normal_ziggurat_slow(rng, s[i], r[i]);
+    fma(n, stddev, r, mean, r);
+}
+
+} // namespace vsmc::internal
+
+/// \brief Normal distribution using the ziggurat method
+/// \ingroup Distribution
+///
+/// \details
+/// The 128 layers ziggurat method of Marsaglia and Tsang, with the
+/// improvements of Doornik. Each variate consumes one 64-bit random integer
+/// with probability about 0.988. When generating variates in batches, the
+/// common case of accepting the variate within the rectangular part of a
+/// layer is vectorized (using AVX2 gathers if `VSMC_HAS_AVX2` is true and
+/// `RealType` is `double`) and only the rejected variates are regenerated
+/// one at a time.
+template <typename RealType>
+class NormalZigguratDistribution
+{
+    VSMC_DEFINE_RNG_DISTRIBUTION_2(
+        NormalZiggurat, normal_ziggurat, mean, 0, stddev, 1)
+
+    public:
+    result_type min() const
+    {
+        return std::numeric_limits<result_type>::lowest();
+    }
+
+    result_type max() const { return std::numeric_limits<result_type>::max(); }
+
+    void reset() {}
+
+    private:
+    template <typename RNGType>
+    result_type generate(RNGType &rng, const param_type &param)
+    {
+        const RealType *const x =
+            internal::NormalZigguratTable<RealType>::instance().x();
+        const std::uint64_t s = UniformBits<std::uint64_t>::eval(rng);
+        RealType z = internal::normal_ziggurat_u<RealType>(s) * x[s & 0x7F];
+        if (!(std::abs(z) < x[(s & 0x7F) + 1]))
+            z = internal::normal_ziggurat_slow(rng, s, z);
+
+        return param.mean() + param.stddev() * z;
+    }
+}; // class NormalZigguratDistribution
+
+/// \brief Generating Normal random variates using the ziggurat method
+/// \ingroup Distribution
+template <typename RealType, typename RNGType>
+inline void normal_ziggurat_distribution(
+    RNGType &rng, std::size_t n, RealType *r, RealType mean, RealType stddev)
+{
+    static_assert(std::is_floating_point<RealType>::value,
+        "**normal_ziggurat_distribution** USED WITH RealType OTHER THAN "
+        "FLOATING POINT TYPES");
+
+    const std::size_t k = 1024;
+    const std::size_t m = n / k;
+    const std::size_t l = n % k;
+    for (std::size_t i = 0; i != m; ++i, r += k)
+        internal::normal_ziggurat_distribution_impl<k>(
+            rng, k, r, mean, stddev);
+    internal::normal_ziggurat_distribution_impl<k>(rng, l, r, mean, stddev);
+}
+
+VSMC_DEFINE_RNG_DISTRIBUTION_RAND_2(
+    NormalZiggurat, normal_ziggurat, mean, stddev)
+
+} // namespace vsmc
+
+#endif // VSMC_RNG_NORMAL_ZIGGURAT_DISTRIBUTION_HPP
@@ -36,6 +36,7 @@
 #include <vsmc/rng/normal_distribution.hpp>
 #include <vsmc/rng/normal_mv_distribution.hpp>
 #include <vsmc/rng/u01_distribution.hpp>
+#include <vsmc/utility/covariance.hpp>
 
 #define VSMC_RUNTIME_ASSERT_RNG_RANDOM_WALK_PROPOSAL_PARAM(flag, Name)        \
     VSMC_RUNTIME_ASSERT(                                                      \
@@ -147,6 +148,69 @@ class RandomWalk
         return 0;
     }
 
+    /// \brief One-step random walk update of a batch of particles
+    ///
+    /// \param rng RNG engine
+    /// \param n The number of particles
+    /// \param x The current state values, stored as an `n` by `dim()` row
+    /// major matrix. Each row will be updated to the new value after the MCMC
+    /// move.
+    /// \param ltx If it is a non-null pointer, then it points to an array of
+    /// length `n` of the values of \f$\log\gamma(x)\f$. Each will be updated
+    /// to the new value if the MCMC move of the row is accepted and left
+    /// unchanged otherwise.
+    /// \param log_target The batched log-target function
+    /// ~~~{.cpp}
+    /// void log_target(std::size_t n, std::size_t dim, const result_type *x,
+    ///     result_type *lt);
+    /// ~~~
+    /// It writes the values of \f$\log\gamma(x)\f$ of the `n` rows of `x`
+    /// to `lt`.
+    /// \param proposal The batched proposal function. It takes the form,
+    /// ~~~{.cpp}
+    /// void proposal(RNGType &rng, std::size_t n, std::size_t dim,
+    ///     const result_type *x, result_type *y, result_type *q);
+    /// ~~~
+    /// After the call, the function return the proposed values in the rows of
+    /// `y` and the values of \f$\log(q(y, x) / q(x, y))\f$ in `q`.
+    /// NormalProposal and NormalMVProposal provide such an operator. The
+    /// latter generates all `n` proposals with a single level-3 BLAS call.
+    ///
+    /// \return Acceptance count
+    template <typename RNGType, typename LogTargetType, typename ProposalType>
+    std::size_t operator()(RNGType &rng, std::size_t n, result_type *x,
+        result_type *ltx, LogTargetType &&log_target, ProposalType &&proposal)
+    {
+        const std::size_t d = dim();
+        batch_.resize(n * (d + 4));
+        result_type *const y = batch_.data();
+        result_type *const q = y + n * d;
+        result_type *const s = q + n;
+        result_type *const t = s + n;
+        result_type *const u = t + n;
+
+        proposal(rng, n, d, const_cast<const result_type *>(x), y, q);
+        if (ltx == nullptr)
+            log_target(n, d, const_cast<const result_type *>(x), s);
+        else
+            std::copy_n(ltx, n, s);
+        log_target(n, d, const_cast<const result_type *>(y), t);
+        u01_distribution(rng, n, u);
+        log(n, u, u);
+
+        std::size_t acc = 0;
+        for (std::size_t i = 0; i != n; ++i) {
+            if (u[i] < t[i] - s[i] + q[i]) {
+                std::copy_n(y + i * d, d, x + i * d);
+                if (ltx != nullptr)
+                    ltx[i] = t[i];
+                ++acc;
+            }
+        }
+
+        return acc;
+    }
+
     /// \brief Multi-step random walk update
     template <typename RNGType, typename LogTargetType, typename ProposalType>
     std::size_t operator()(std::size_t n, RNGType &rng, result_type *x,
@@ -188,8 +252,184 @@ class RandomWalk
     private:
     internal::Array<RealType, Dim> x_;
     internal::Array<RealType, Dim> y_;
+    Vector<RealType> batch_;
 }; // class RandomWalk
 
+/// \brief Random walk MCMC update of all particles at once
+/// \ingroup RandomWalk
+///
+/// \details
+/// Unlike RandomWalk, which updates one particle at a time, this class
+/// updates a range of particles whose states are stored in column major
+/// order, given a pointer and a leading dimension. The log-target and
+/// proposal functions are called once for all particles, and the
+/// accept-reject step is computed across particles, so that it can be
+/// vectorized. For a `StateMatrix<ColMajor, Dim, RealType>`, see
+/// `random_walk_batch` in `<vsmc/core/random_walk_batch.hpp>`.
+template <typename RealType, std::size_t Dim>
+class RandomWalkBatch
+{
+    public:
+    using result_type = RealType;
+
+    /// \brief Only usable when `Dim != Dynamic`
+    RandomWalkBatch() : dim_(Dim)
+    {
+        static_assert(Dim != Dynamic,
+            "**RandomWalkBatch** OBJECT DECLARED WITH DYNAMIC DIMENSION");
+    }
+
+    /// \brief Only usable when `Dim == Dynamic`
+    RandomWalkBatch(std::size_t dim) : dim_(dim)
+    {
+        static_assert(Dim == Dynamic,
+            "**RandomWalkBatch** OBJECT DECLARED WITH FIXED DIMENSION");
+    }
+
+    std::size_t dim() const { return dim_; }
+
+    /// \brief The acceptance counts of each particle by the last call
+    const Vector<std::size_t> &accept() const { return accept_; }
+
+    /// \brief One-step random walk update of `n` particles
+    ///
+    /// \param rng RNG engine
+    /// \param n The number of particles
+    /// \param ld The leading dimension of `x`. The `d`-th component of the
+    /// `i`-th particle is `x[d * ld + i]`.
+    /// \param x The current state values. Each particle will be updated to
+    /// the new value after the MCMC move.
+    /// \param ltx If it is a non-null pointer, then it points to an array of
+    /// length `n` of the values of \f$\log\gamma(x)\f$. Each will be updated
+    /// to the new value if the MCMC move of the particle is accepted and left
+    /// unchanged otherwise.
+    /// \param log_target The batched log-target function
+    /// ~~~{.cpp}
+    /// void log_target(std::size_t n, std::size_t dim, const result_type *x,
+    ///     result_type *lt);
+    /// ~~~
+    /// It writes the values of \f$\log\gamma(x)\f$ of the `n` particles to
+    /// `lt`, where `x` is an `n` by `dim` column major matrix.
+    /// \param proposal The batched proposal function. It takes the form,
+    /// ~~~{.cpp}
+    /// void proposal(RNGType &rng, std::size_t n, std::size_t dim,
+    ///     const result_type *x, result_type *y, result_type *q);
+    /// ~~~
+    /// where `x` and `y` are `n` by `dim` column major matrices. After the
+    /// call, the function return the proposed values in `y` and the values
+    /// of \f$\log(q(y, x) / q(x, y))\f$ in `q`. NormalProposal provides such
+    /// an operator.
+    ///
+    /// \return The total acceptance count. The counts of each particle are
+    /// returned by `accept()`.
+    template <typename RNGType, typename LogTargetType, typename ProposalType>
+    std::size_t operator()(RNGType &rng, std::size_t n, std::size_t ld,
+        result_type *x, result_type *ltx, LogTargetType &&log_target,
+        ProposalType &&proposal)
+    {
+        accept_.resize(n);
+        std::fill(accept_.begin(), accept_.end(), 0);
+
+        return update(rng, n, ld, x, ltx,
+            std::forward<LogTargetType>(log_target),
+            std::forward<ProposalType>(proposal));
+    }
+
+    /// \brief Multi-step random walk update of `n` particles
+    template <typename RNGType, typename LogTargetType, typename ProposalType>
+    std::size_t operator()(std::size_t steps, RNGType &rng, std::size_t n,
+        std::size_t ld, result_type *x, result_type *ltx,
+        LogTargetType &&log_target, ProposalType &&proposal)
+    {
+        accept_.resize(n);
+        std::fill(accept_.begin(), accept_.end(), 0);
+
+        Vector<result_type> lt;
+        if (ltx == nullptr) {
+            lt.resize(n);
+            load(n, ld, x);
+            log_target(n, dim(), const_cast<const result_type *>(x_.data()),
+                lt.data());
+            ltx = lt.data();
+        }
+
+        std::size_t acc = 0;
+        for (std::size_t i = 0; i != steps; ++i) {
+            acc += update(rng, n, ld, x, ltx,
+                std::forward<LogTargetType>(log_target),
+                std::forward<ProposalType>(proposal));
+        }
+
+        return acc;
+    }
+
+    private:
+    std::size_t dim_;
+    Vector<result_type> x_;
+    Vector<result_type> y_;
+    Vector<result_type> w_;
+    Vector<std::size_t> accept_;
+
+    void load(std::size_t n, std::size_t ld, const result_type *x)
+    {
+        x_.resize(n * dim());
+        for (std::size_t d = 0; d != dim(); ++d)
+            std::copy_n(x + d * ld, n, x_.data() + d * n);
+    }
+
+    template <typename RNGType, typename LogTargetType, typename ProposalType>
+    std::size_t update(RNGType &rng, std::size_t n, std::size_t ld,
+        result_type *x, result_type *ltx, LogTargetType &&log_target,
+        ProposalType &&proposal)
+    {
+        y_.resize(n * dim());
+        w_.resize(n * 5);
+        result_type *const q = w_.data();
+        result_type *const s = q + n;
+        result_type *const t = s + n;
+        result_type *const u = t + n;
+        result_type *const a = u + n;
+
+        const result_type *xc = x;
+        if (ld != n || ltx == nullptr) {
+            load(n, ld, x);
+            xc = x_.data();
+        }
+        proposal(rng, n, dim(), xc, y_.data(), q);
+        if (ltx == nullptr)
+            log_target(n, dim(), xc, s);
+        else
+            std::copy_n(ltx, n, s);
+        log_target(n, dim(), const_cast<const result_type *>(y_.data()), t);
+        u01_distribution(rng, n, u);
+        vmath::eval(n, u, vmath::log(vmath::arg(u)));
+
+        // a[i] is 1 if the move is accepted and 0 otherwise
+        const result_type one = 1;
+        const result_type zero = 0;
+        for (std::size_t i = 0; i != n; ++i)
+            a[i] = u[i] < t[i] - s[i] + q[i] ? one : zero;
+        for (std::size_t d = 0; d != dim(); ++d) {
+            result_type *const xd = x + d * ld;
+            const result_type *const yd = y_.data() + d * n;
+            for (std::size_t i = 0; i != n; ++i)
+                xd[i] = a[i] != 0 ? yd[i] : xd[i];
+        }
+        if (ltx != nullptr)
+            for (std::size_t i = 0; i != n; ++i)
+                ltx[i] = a[i] != 0 ? t[i] : ltx[i];
+
+        std::size_t acc = 0;
+        for (std::size_t i = 0; i != n; ++i) {
+            const std::size_t c = static_cast<std::size_t>(a[i]);
+            accept_[i] += c;
+            acc += c;
+        }
+
+        return acc;
+    }
+}; // class RandomWalkBatch
+
 /// \brief Random walk MCMC update with test function
 /// \ingroup RandomWalk
 template <typename RealType, std::size_t DimX, std::size_t DimG>
@@ -375,6 +615,12 @@ inline bool normal_mv_proposal_check_param(
     return true;
 }
 
+template <typename RealType>
+inline bool normal_proposal_adaptive_check_param(RealType target)
+{
+    return target > 0 && target < 1;
+}
+
 template <typename RealType>
 RealType normal_proposal_q(RealType x, RealType &y, RealType z)
 {
@@ -454,6 +700,49 @@ class NormalProposal
         }
     }
 
+    /// \brief Propose new values for a batch of `n` particles
+    ///
+    /// \details
+    /// The states `x` and proposals `y` are stored as `n` by `dim` column
+    /// major matrices, and each component is proposed independently. If `dim
+    /// == 1`, this is also the row major layout used by RandomWalk.
+    template <typename RNGType>
+    void operator()(RNGType &rng, std::size_t n, std::size_t dim,
+        const result_type *x, result_type *y, result_type *q)
+    {
+        rnorm_(rng, n * dim, y);
+        if (flag_ == 0) {
+            add(n * dim, x, y, y);
+            std::fill_n(q, n, 0);
+            return;
+        }
+
+        std::fill_n(q, n, 0);
+        for (std::size_t d = 0; d != dim; ++d, x += n, y += n) {
+            switch (flag_) {
+                case 1:
+                    for (std::size_t i = 0; i != n; ++i) {
+                        q[i] += internal::normal_proposal_qb(
+                            x[i], y[i], y[i], b_);
+                    }
+                    break;
+                case 2:
+                    for (std::size_t i = 0; i != n; ++i) {
+                        q[i] += internal::normal_proposal_qa(
+                            x[i], y[i], y[i], a_);
+                    }
+                    break;
+                case 3:
+                    for (std::size_t i = 0; i != n; ++i) {
+                        q[i] += internal::normal_proposal_qab(
+                            x[i], y[i], y[i], a_, b_);
+                    }
+                    break;
+                default: break;
+            }
+        }
+    }
+
     private:
     NormalDistribution<RealType> rnorm_;
     result_type a_;
@@ -511,23 +800,59 @@ class NormalMVProposal
         RNGType &rng, std::size_t, const result_type *x, result_type *y)
     {
         rnorm_(rng, z_.data());
+
+        return propose(x, y, z_.data());
+    }
+
+    /// \brief Propose new values for a batch of `n` particles
+    ///
+    /// \details
+    /// The states `x` and proposals `y` are stored as `n` by `dim()` row major
+    /// matrices. The Normal increments of all particles are generated by
+    /// `normal_mv_distribution`, which applies the Cholesky factor with a
+    /// single level-3 BLAS call.
+    template <typename RNGType>
+    void operator()(RNGType &rng, std::size_t n, std::size_t,
+        const result_type *x, result_type *y, result_type *q)
+    {
+        const std::size_t d = dim();
+        rnorm_(rng, n, y);
+        if (bounded_) {
+            for (std::size_t i = 0; i != n; ++i, x += d, y += d)
+                q[i] = propose(x, y, y);
+        } else {
+            add(n * d, x, y, y);
+            std::fill_n(q, n, 0);
+        }
+    }
+
+    private:
+    NormalMVDistribution<RealType, Dim> rnorm_;
+    internal::Array<RealType, Dim> a_;
+    internal::Array<RealType, Dim> b_;
+    internal::Array<RealType, Dim> z_;
+    internal::Array<unsigned, Dim> flag_;
+    bool bounded_;
+
+    // z may alias y
+    result_type propose(
+        const result_type *x, result_type *y, const result_type *z) const
+    {
         result_type q = 0;
         for (std::size_t i = 0; i != dim(); ++i) {
             switch (flag_[i]) {
                 case 0:
-                    q += internal::normal_proposal_q(x[i], y[i], z_[i]);
+                    q += internal::normal_proposal_q(x[i], y[i], z[i]);
                     break;
                 case 1:
-                    q +=
-                        internal::normal_proposal_qb(x[i], y[i], z_[i], b_[i]);
+                    q += internal::normal_proposal_qb(x[i], y[i], z[i], b_[i]);
                     break;
                 case 2:
-                    q +=
-                        internal::normal_proposal_qa(x[i], y[i], z_[i], a_[i]);
+                    q += internal::normal_proposal_qa(x[i], y[i], z[i], a_[i]);
                     break;
                 case 3:
                     q += internal::normal_proposal_qab(
-                        x[i], y[i], z_[i], a_[i], b_[i]);
+                        x[i], y[i], z[i], a_[i], b_[i]);
                     break;
                 default: break;
             }
@@ -536,13 +861,6 @@ class NormalMVProposal
         return q;
     }
 
-    private:
-    NormalMVDistribution<RealType, Dim> rnorm_;
-    internal::Array<RealType, Dim> a_;
-    internal::Array<RealType, Dim> b_;
-    internal::Array<RealType, Dim> z_;
-    internal::Array<unsigned, Dim> flag_;
-
     void init(std::size_t dim, const result_type *a, const result_type *b)
     {
         if (a == nullptr) {
@@ -559,10 +877,12 @@ class NormalMVProposal
             std::copy_n(b, dim, b_.begin());
         }
 
+        bounded_ = false;
         for (std::size_t i = 0; i != dim; ++i) {
             unsigned lower = std::isfinite(a_[i]) ? 1 : 0;
             unsigned upper = std::isfinite(b_[i]) ? 1 : 0;
             flag_[i] = (lower << 1) + upper;
+            bounded_ = bounded_ || flag_[i] != 0;
         }
 
         VSMC_RUNTIME_ASSERT_RNG_RANDOM_WALK_PROPOSAL_PARAM(
@@ -572,6 +892,272 @@ class NormalMVProposal
     }
 }; // class NormalMVProposal
 
+namespace internal
+{
+
+template <typename RealType>
+class NormalProposalAdaptiveScale
+{
+    public:
+    NormalProposalAdaptiveScale(RealType scale, RealType target)
+        : scale_(scale), target_(target), rate_(target)
+    {
+        VSMC_RUNTIME_ASSERT_RNG_RANDOM_WALK_PROPOSAL_PARAM(
+            normal_proposal_adaptive_check_param(target),
+            NormalAdaptive);
+    }
+
+    RealType scale() const { return scale_; }
+
+    RealType target() const { return target_; }
+
+    void accept(std::size_t acc, std::size_t n)
+    {
+        if (n != 0)
+            rate_ = static_cast<RealType>(acc) / static_cast<RealType>(n);
+    }
+
+    protected:
+    void adapt()
+    {
+        scale_ *= std::exp(rate_ - target_);
+        rate_ = target_;
+    }
+
+    private:
+    RealType scale_;
+    RealType target_;
+    RealType rate_;
+}; // class NormalProposalAdaptiveScale
+
+} // namespace vsmc::internal
+
+/// \brief Normal random walk proposal with adaptive scale
+/// \ingroup RandomWalk
+///
+/// \details
+/// The standard deviation of the proposal is \f$\lambda\sigma\f$, where
+/// \f$\sigma^2\f$ is the variance of the current weighted particle system,
+/// re-estimated by `update`, and \f$\lambda\f$ is a scale factor. Each call
+/// to `update` multiplies \f$\lambda\f$ by \f$\exp(r - r^*)\f$, where
+/// \f$r\f$ is the acceptance rate recorded by `accept` since the last update
+/// and \f$r^*\f$ is the target rate. A typical MCMC move that uses this
+/// proposal calls `update` once after each resampling, with the particles and
+/// their normalized weights, performs the random walk updates, and records
+/// the acceptance count with `accept`.
+template <typename RealType>
+class NormalProposalAdaptive
+    : public internal::NormalProposalAdaptiveScale<RealType>
+{
+    public:
+    using result_type = RealType;
+
+    /// \brief Construct an adaptive Normal random walk proposal
+    ///
+    /// \param a The lower bound of the support of the target distribution
+    /// \param b The upper bound of the support of the target distribution
+    /// \param target The target acceptance rate
+    /// \param scale The initial scale factor \f$\lambda\f$
+    explicit NormalProposalAdaptive(
+        result_type a = -std::numeric_limits<result_type>::infinity(),
+        result_type b = std::numeric_limits<result_type>::infinity(),
+        result_type target = static_cast<result_type>(0.44),
+        result_type scale = static_cast<result_type>(2.38))
+        : internal::NormalProposalAdaptiveScale<RealType>(scale, target)
+        , proposal_(scale, a, b)
+        , sd_(1)
+        , stddev_(scale)
+    {
+    }
+
+    result_type a() const { return proposal_.a(); }
+    result_type b() const { return proposal_.b(); }
+
+    /// \brief The standard deviation of the proposal
+    result_type stddev() const { return stddev_; }
+
+    /// \brief Re-estimate the variance from the particle system and adapt the
+    /// scale factor
+    ///
+    /// \param n The number of particles
+    /// \param x The values of the particles
+    /// \param w The weights. If it is a null pointer, then all particles have
+    /// equal weights.
+    ///
+    /// \return `false` if the variance is not positive, in which case the
+    /// variance estimated by the previous update is kept
+    bool update(std::size_t n, const result_type *x, const result_type *w)
+    {
+        this->adapt();
+        result_type var = 0;
+        cov_(RowMajor, n, 1, x, w, nullptr, &var);
+        const bool success = var > 0;
+        if (success)
+            sd_ = std::sqrt(var);
+        stddev_ = this->scale() * sd_;
+        proposal_ = NormalProposal<RealType>(stddev_, a(), b());
+
+        return success;
+    }
+
+    template <typename RNGType>
+    result_type operator()(
+        RNGType &rng, std::size_t dim, const result_type *x, result_type *y)
+    {
+        return proposal_(rng, dim, x, y);
+    }
+
+    template <typename RNGType>
+    void operator()(RNGType &rng, std::size_t n, std::size_t dim,
+        const result_type *x, result_type *y, result_type *q)
+    {
+        proposal_(rng, n, dim, x, y, q);
+    }
+
+    private:
+    NormalProposal<RealType> proposal_;
+    Covariance<RealType> cov_;
+    result_type sd_;
+    result_type stddev_;
+}; // class NormalProposalAdaptive
+
+/// \brief Multivariate Normal random walk proposal with adaptive scale and
+/// covariance
+/// \ingroup RandomWalk
+///
+/// \details
+/// The covariance of the proposal is \f$\lambda^2\Sigma\f$, where
+/// \f$\Sigma\f$ is the covariance of the current weighted particle system,
+/// re-estimated by `update`, and \f$\lambda\f$ is a scale factor, adapted
+/// toward the target acceptance rate the same way as NormalProposalAdaptive.
+template <typename RealType, std::size_t Dim>
+class NormalMVProposalAdaptive
+    : public internal::NormalProposalAdaptiveScale<RealType>
+{
+    public:
+    using result_type = RealType;
+
+    /// \brief Only usable when `Dim != Dynamic`
+    ///
+    /// \param a The lower bounds of the support of the target distribution.
+    /// \param b The upper bounds of the support of the target distribution.
+    /// \param target The target acceptance rate
+    /// \param scale The initial scale factor \f$\lambda\f$. If it is zero,
+    /// then \f$2.38 / \sqrt{d}\f$ is used.
+    explicit NormalMVProposalAdaptive(const result_type *a = nullptr,
+        const result_type *b = nullptr,
+        result_type target = static_cast<result_type>(0.234),
+        result_type scale = 0)
+        : internal::NormalProposalAdaptiveScale<RealType>(
+              scale_init(Dim, scale), target)
+        , proposal_(nullptr, a, b)
+    {
+        static_assert(Dim != Dynamic,
+            "**NormalMVProposalAdaptive** OBJECT DECLARED WITH DYNAMIC "
+            "DIMENSION");
+        init();
+    }
+
+    /// \brief Only usable when `Dim == Dynamic`
+    explicit NormalMVProposalAdaptive(std::size_t dim,
+        const result_type *a = nullptr, const result_type *b = nullptr,
+        result_type target = static_cast<result_type>(0.234),
+        result_type scale = 0)
+        : internal::NormalProposalAdaptiveScale<RealType>(
+              scale_init(dim, scale), target)
+        , proposal_(dim, nullptr, a, b)
+        , l_(dim * (dim + 1) / 2)
+        , chol_(dim * (dim + 1) / 2)
+    {
+        static_assert(Dim == Dynamic,
+            "**NormalMVProposalAdaptive** OBJECT DECLARED WITH FIXED "
+            "DIMENSION");
+        init();
+    }
+
+    std::size_t dim() const { return proposal_.dim(); }
+    const result_type *a() const { return proposal_.a(); }
+    const result_type *b() const { return proposal_.b(); }
+
+    /// \brief The lower triangular elements of the Cholesky decomposition of
+    /// the proposal covariance matrix, packed row by row
+    const result_type *chol() const { return chol_.data(); }
+
+    /// \brief Re-estimate the covariance from the particle system and adapt
+    /// the scale factor
+    ///
+    /// \param layout The storage layout of `x`
+    /// \param n The number of particles
+    /// \param x The values of the particles, an `n` by `dim()` matrix
+    /// \param w The weights. If it is a null pointer, then all particles have
+    /// equal weights.
+    ///
+    /// \return `false` if the covariance matrix is not positive definite, in
+    /// which case the covariance estimated by the previous update is kept
+    bool update(MatrixLayout layout, std::size_t n, const result_type *x,
+        const result_type *w)
+    {
+        this->adapt();
+        cov_(layout, n, dim(), x, w, nullptr, chol_.data(), RowMajor, false,
+            true);
+        const bool success =
+            cov_chol(dim(), chol_.data(), chol_.data(), RowMajor, false,
+                true) == 0;
+        if (success)
+            std::copy(chol_.begin(), chol_.end(), l_.begin());
+        mul(l_.size(), this->scale(), l_.data(), chol_.data());
+        reset(std::integral_constant<bool, Dim == Dynamic>());
+
+        return success;
+    }
+
+    template <typename RNGType>
+    result_type operator()(
+        RNGType &rng, std::size_t dim, const result_type *x, result_type *y)
+    {
+        return proposal_(rng, dim, x, y);
+    }
+
+    template <typename RNGType>
+    void operator()(RNGType &rng, std::size_t n, std::size_t dim,
+        const result_type *x, result_type *y, result_type *q)
+    {
+        proposal_(rng, n, dim, x, y, q);
+    }
+
+    private:
+    NormalMVProposal<RealType, Dim> proposal_;
+    Covariance<RealType> cov_;
+    internal::Array<RealType, Dim *(Dim + 1) / 2> l_;
+    internal::Array<RealType, Dim *(Dim + 1) / 2> chol_;
+
+    static result_type scale_init(std::size_t dim, result_type scale)
+    {
+        return scale > 0 ? scale : static_cast<result_type>(2.38) /
+                std::sqrt(static_cast<result_type>(dim));
+    }
+
+    void init()
+    {
+        std::fill(l_.begin(), l_.end(), 0);
+        for (std::size_t i = 0; i != dim(); ++i)
+            l_[i * (i + 1) / 2 + i] = 1;
+        mul(l_.size(), this->scale(), l_.data(), chol_.data());
+        reset(std::integral_constant<bool, Dim == Dynamic>());
+    }
+
+    void reset(std::false_type)
+    {
+        proposal_ = NormalMVProposal<RealType, Dim>(chol_.data(), a(), b());
+    }
+
+    void reset(std::true_type)
+    {
+        proposal_ =
+            NormalMVProposal<RealType, Dim>(dim(), chol_.data(), a(), b());
+    }
+}; // class NormalMVProposalAdaptive
+
 } // namespace vsmc
 
 #endif // VSMC_RNG_RANDOM_WALK_HPP
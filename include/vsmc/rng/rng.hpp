@@ -35,9 +35,12 @@
 #include <vsmc/internal/config.h>
 #include <vsmc/rng/distribution.hpp>
 #include <vsmc/rng/engine.hpp>
+#include <vsmc/rng/halton.hpp>
+#include <vsmc/rng/hmc.hpp>
 #include <vsmc/rng/random_walk.hpp>
 #include <vsmc/rng/rng_set.hpp>
 #include <vsmc/rng/seed.hpp>
+#include <vsmc/rng/sobol.hpp>
 #include <vsmc/rng/u01.hpp>
 #include <vsmc/rng/u01_sequence.hpp>
 
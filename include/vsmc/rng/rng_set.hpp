@@ -52,6 +52,65 @@
 namespace vsmc
 {
 
+namespace internal
+{
+
+// Allocator adaptor for which elements constructed without arguments are left
+// unconstructed, such that they can be constructed in place later by the
+// threads that first touch their memory. The user shall construct each such
+// element before any other use, including destruction
+template <typename Alloc>
+class DeferInitAllocator : public Alloc
+{
+    using traits = std::allocator_traits<Alloc>;
+
+    public:
+    template <typename U>
+    class rebind
+    {
+        public:
+        using other =
+            DeferInitAllocator<typename traits::template rebind_alloc<U>>;
+    }; // class rebind
+
+    DeferInitAllocator() = default;
+
+    template <typename U>
+    DeferInitAllocator(const DeferInitAllocator<U> &other)
+        : Alloc(static_cast<const U &>(other))
+    {
+    }
+
+    template <typename U>
+    void construct(U *)
+    {
+    }
+
+    template <typename U, typename... Args>
+    void construct(U *ptr, Args &&... args)
+    {
+        traits::construct(static_cast<Alloc &>(*this), ptr,
+            std::forward<Args>(args)...);
+    }
+}; // class DeferInitAllocator
+
+template <typename Alloc1, typename Alloc2>
+inline bool operator==(const DeferInitAllocator<Alloc1> &alloc1,
+    const DeferInitAllocator<Alloc2> &alloc2)
+{
+    return static_cast<const Alloc1 &>(alloc1) ==
+        static_cast<const Alloc2 &>(alloc2);
+}
+
+template <typename Alloc1, typename Alloc2>
+inline bool operator!=(const DeferInitAllocator<Alloc1> &alloc1,
+    const DeferInitAllocator<Alloc2> &alloc2)
+{
+    return !(alloc1 == alloc2);
+}
+
+} // namespace vsmc::internal
+
 /// \brief Scalar RNG set
 /// \ingroup RNG
 template <typename RNGType>
@@ -65,7 +124,7 @@ class RNGSetScalar
 
     size_type size() const { return size_; }
 
-    void resize(std::size_t) {}
+    void resize(std::size_t n) { size_ = n; }
 
     void seed() { Seed::instance().seed_rng(rng_); }
 
@@ -83,42 +142,60 @@ class RNGSetVector
 {
     public:
     using rng_type = RNGType;
-    using size_type = typename AlignedVector<rng_type>::size_type;
+    using size_type = std::size_t;
 
     explicit RNGSetVector(size_type N = 0) : size_(N), rng_(size_, rng_type())
     {
         seed();
     }
 
+    /// \brief Construct `N` RNGs, each range of which, as partitioned by the
+    /// first touch policy, is constructed in place and seeded by the thread
+    /// that will use them
+    ///
+    /// \details
+    /// The seeds are the same as those of `RNGSetVector(N)`
+    RNGSetVector(size_type N, FirstTouch touch) : size_(N)
+    {
+        rng_.resize(size_); // Allocate only, see internal::DeferInitAllocator
+        rng_type *const ptr = rng_.data();
+        internal::first_touch(
+            size_, touch, [ptr](std::size_t i, std::size_t j) {
+                for (; i != j; ++i)
+                    ::new (static_cast<void *>(ptr + i)) rng_type();
+            });
+        Seed::instance().seed_rng(rng_.begin(), rng_.end(), touch);
+    }
+
     size_type size() const { return size_; }
 
+    /// \brief Change the number of RNGs
+    ///
+    /// \details
+    /// The first `min(n, size())` RNGs are retained and the new ones are
+    /// seeded. The capacity grows geometrically.
     void resize(std::size_t n)
     {
         if (n == rng_.size())
             return;
 
-        if (n < rng_.size())
-            rng_.resize(n);
-
-        rng_.reserve(n);
-        rng_type rng;
-        for (std::size_t i = rng_.size(); i != n; ++i) {
-            Seed::instance().seed_rng(rng);
-            rng_.push_back(rng);
-        }
+        const std::size_t m = rng_.size();
+        internal::reserve_geometric(rng_, n);
+        rng_.resize(n, rng_type());
+        if (n > m)
+            Seed::instance().seed_rng(rng_.begin() + m, rng_.end());
+        size_ = n;
     }
 
-    void seed()
-    {
-        for (auto &rng : rng_)
-            Seed::instance().seed_rng(rng);
-    }
+    void seed() { Seed::instance().seed_rng(rng_.begin(), rng_.end()); }
 
     rng_type &operator[](size_type id) { return rng_[id % size_]; }
 
     private:
     std::size_t size_;
-    AlignedVector<rng_type> rng_;
+    std::vector<rng_type,
+        internal::DeferInitAllocator<AlignedAllocator<rng_type>>>
+        rng_;
 }; // class RNGSetVector
 
 #if VSMC_HAS_TBB
@@ -144,7 +221,9 @@ class RNGSetTBB
 
     size_type size() const { return size_; }
 
-    void resize(std::size_t) {}
+    /// \brief Change the number of particles, while the thread local RNGs
+    /// are retained
+    void resize(std::size_t n) { size_ = n; }
 
     void seed() { rng_.clear(); }
 
@@ -34,6 +34,9 @@
 
 #include <vsmc/rng/internal/common.hpp>
 #include <vsmc/rng/counter.hpp>
+#if VSMC_USE_TBB
+#include <tbb/parallel_for.h>
+#endif
 
 #define VSMC_RUNTIME_ASSERT_RNG_SEED_GENERATOR_MODULO(div, rem)               \
     VSMC_RUNTIME_ASSERT((div > rem),                                          \
@@ -59,6 +62,59 @@
 namespace vsmc
 {
 
+namespace internal
+{
+
+template <typename RNGIter, typename SeedType>
+inline void seed_rng_range(RNGIter first, std::size_t n, SeedType &&seed,
+    std::input_iterator_tag)
+{
+    for (std::size_t i = 0; i != n; ++i, ++first)
+        first->seed(seed(i));
+}
+
+template <typename RNGIter, typename SeedType>
+inline void seed_rng_range(RNGIter first, std::size_t n, SeedType &&seed,
+    std::random_access_iterator_tag)
+{
+#if VSMC_USE_TBB
+    ::tbb::parallel_for(::tbb::blocked_range<std::size_t>(0, n, 1024),
+        [first, &seed](const ::tbb::blocked_range<std::size_t> &range) {
+            for (std::size_t i = range.begin(); i != range.end(); ++i)
+                first[static_cast<std::ptrdiff_t>(i)].seed(seed(i));
+        });
+#else  // VSMC_USE_TBB
+    seed_rng_range(first, n, std::forward<SeedType>(seed),
+        std::input_iterator_tag());
+#endif // VSMC_USE_TBB
+}
+
+// Seed `n` RNGs starting at `first` within each range as partitioned by the
+// first touch policy
+template <typename RNGIter, typename SeedType>
+inline void seed_rng_range(
+    RNGIter first, std::size_t n, SeedType &&seed, FirstTouch touch)
+{
+    first_touch(n, touch, [first, &seed](std::size_t i, std::size_t j) {
+        for (; i != j; ++i)
+            first[static_cast<std::ptrdiff_t>(i)].seed(seed(i));
+    });
+}
+
+/// \brief Seed `n` RNGs starting at `first`, the `i`-th with `seed(i)`
+///
+/// \details
+/// `seed(i)` shall be thread-safe. If `RNGIter` is a random access iterator
+/// and TBB is used, the RNGs are seeded in parallel.
+template <typename RNGIter, typename SeedType>
+inline void seed_rng_range(RNGIter first, std::size_t n, SeedType &&seed)
+{
+    seed_rng_range(first, n, std::forward<SeedType>(seed),
+        typename std::iterator_traits<RNGIter>::iterator_category());
+}
+
+} // namespace vsmc::internal
+
 /// \brief Seed generator
 /// \ingroup RNG
 ///
@@ -78,9 +134,17 @@ namespace vsmc
 /// the SeedGenerator using the `modulo` member such that \f$D\f$ is the number
 /// of total nodes and \f$R\f$ is the rank of each node, counting from zero.
 ///
-/// For multithreading programs, the access to this member function shall be
-/// protected by mutex, if it is called from multiple threads. Or one can use
-/// distinct type `ID` to initialized distinct SeedGenerator instances.
+/// The member functions `get`, `skip` and `seed_rng` are lock-free and can be
+/// called from multiple threads. The member functions `set` and `modulo`
+/// shall not be called concurrently with any other member function. Or one
+/// can use distinct type `ID` to initialized distinct SeedGenerator
+/// instances.
+///
+/// To seed a large number of RNGs, use `seed_rng(first, last)`, which
+/// reserves a contiguous block of internal seeds with a single atomic
+/// operation and then seeds each RNG independently (in parallel if TBB is
+/// used). The result is the same as calling `seed_rng(rng)` sequentially for
+/// each RNG in the range.
 template <typename ID, typename ResultType = VSMC_SEED_RESULT_TYPE>
 class SeedGenerator
 {
@@ -111,17 +175,52 @@ class SeedGenerator
         rng.seed(get());
     }
 
-    /// \brief Get a new seed
+    /// \brief Seed a range of RNGs with consecutive seeds
     ///
     /// \details
-    /// This member function is thread safe
-    result_type get()
+    /// Equivalent to calling `seed_rng(rng)` for each RNG in the range
+    /// `[first, last)`, but the internal seed is advanced only once
+    template <typename RNGIter>
+    void seed_rng(RNGIter first, RNGIter last)
     {
-        skip();
+        const std::size_t n =
+            static_cast<std::size_t>(std::distance(first, last));
+        if (n == 0)
+            return;
+
+        const result_type s = reserve(static_cast<skip_type>(n));
+        internal::seed_rng_range(first, n, [this, s](std::size_t i) {
+            return output(next(s, static_cast<skip_type>(i + 1)));
+        });
+    }
 
-        return seed_ * divisor_ + remainder_;
+    /// \brief Seed a range of random access RNGs with consecutive seeds, in
+    /// parallel as partitioned by the first touch policy
+    ///
+    /// \details
+    /// The result is the same as `seed_rng(first, last)`
+    template <typename RNGIter>
+    void seed_rng(RNGIter first, RNGIter last, FirstTouch touch)
+    {
+        const std::size_t n =
+            static_cast<std::size_t>(std::distance(first, last));
+        if (n == 0)
+            return;
+
+        const result_type s = reserve(static_cast<skip_type>(n));
+        internal::seed_rng_range(first, n,
+            [this, s](std::size_t i) {
+                return output(next(s, static_cast<skip_type>(i + 1)));
+            },
+            touch);
     }
 
+    /// \brief Get a new seed
+    ///
+    /// \details
+    /// This member function is thread safe and lock-free
+    result_type get() { return output(next(reserve(1), 1)); }
+
     result_type get_scalar() { return get(); }
 
     /// \brief Set the internal seed
@@ -161,21 +260,10 @@ class SeedGenerator
     }
 
     /// \brief Skip the internal seed by a given steps
-    void skip(skip_type steps)
-    {
-        result_type incr = steps % seed_max_;
-        result_type diff = seed_max_ - seed_;
-        seed_ = incr <= diff ? (seed_ + incr) : (incr - diff);
-    }
+    void skip(skip_type steps) { reserve(steps); }
 
     /// \brief Skip the internal seed by 1 step
-    void skip()
-    {
-        if (seed_ < seed_max_)
-            ++seed_;
-        else
-            seed_ = 1;
-    }
+    void skip() { reserve(1); }
 
     template <typename CharT, typename Traits>
     friend std::basic_ostream<CharT, Traits> &operator<<(
@@ -185,7 +273,7 @@ class SeedGenerator
         if (!os.good())
             return os;
 
-        os << sg.seed_ << ' ';
+        os << sg.seed() << ' ';
         os << sg.divisor_ << ' ';
         os << sg.remainder_;
 
@@ -225,6 +313,32 @@ class SeedGenerator
     {
         modulo(divisor_, remainder_);
     }
+
+    result_type output(result_type s) const
+    {
+        return s * divisor_ + remainder_;
+    }
+
+    // The internal seed after skipping `s` by `steps`
+    result_type next(result_type s, skip_type steps) const
+    {
+        result_type incr = steps % seed_max_;
+        result_type diff = seed_max_ - s;
+
+        return incr <= diff ? (s + incr) : (incr - diff);
+    }
+
+    // Advance the internal seed by `steps` atomically and return its value
+    // before the advance
+    result_type reserve(skip_type steps)
+    {
+        result_type s = seed_.load(std::memory_order_relaxed);
+        while (!seed_.compare_exchange_weak(s, next(s, steps),
+            std::memory_order_relaxed, std::memory_order_relaxed)) {
+        }
+
+        return s;
+    }
 }; // class SeedGenerator
 
 /// \brief Seed generator counters
@@ -247,6 +361,10 @@ class SeedGenerator
 /// s.back() = world.rank();
 /// seed.set(s);
 /// ~~~
+///
+/// The generator keeps the key set by `set` fixed and maintains an atomic
+/// count of the number of increments since. Thus `get`, `skip` and
+/// `seed_rng` are lock-free.
 template <typename ID, typename ResultType, std::size_t K>
 class SeedGenerator<ID, std::array<ResultType, K>>
 {
@@ -286,34 +404,76 @@ class SeedGenerator<ID, std::array<ResultType, K>>
                                        internal::KeyType<RNGType>>::value>());
     }
 
-    result_type get()
+    /// \brief Seed a range of RNGs with consecutive seeds
+    ///
+    /// \details
+    /// Equivalent to calling `seed_rng(rng)` for each RNG in the range
+    /// `[first, last)`, but the internal counter is advanced only once
+    template <typename RNGIter>
+    void seed_rng(RNGIter first, RNGIter last)
+    {
+        using rng_type = typename std::iterator_traits<RNGIter>::value_type;
+
+        const std::size_t n =
+            static_cast<std::size_t>(std::distance(first, last));
+        if (n == 0)
+            return;
+
+        seed_rng_dispatch(first, n,
+            std::integral_constant<bool,
+                              std::is_same<result_type,
+                                       internal::KeyType<rng_type>>::value>());
+    }
+
+    /// \brief Seed a range of random access RNGs with consecutive seeds, in
+    /// parallel as partitioned by the first touch policy
+    ///
+    /// \details
+    /// The result is the same as `seed_rng(first, last)`
+    template <typename RNGIter>
+    void seed_rng(RNGIter first, RNGIter last, FirstTouch touch)
     {
-        std::lock_guard<std::mutex> lock_(mtx_);
-        skip();
+        using rng_type = typename std::iterator_traits<RNGIter>::value_type;
+
+        const std::size_t n =
+            static_cast<std::size_t>(std::distance(first, last));
+        if (n == 0)
+            return;
 
-        return seed_;
+        seed_rng_dispatch(first, n,
+            std::integral_constant<bool,
+                              std::is_same<result_type,
+                                       internal::KeyType<rng_type>>::value>(),
+            touch);
     }
 
+    /// \brief Get a new seed
+    ///
+    /// \details
+    /// This member function is thread safe and lock-free
+    result_type get() { return key(reserve(1) + 1); }
+
     ResultType get_scalar()
     {
-        result_type s1(get());
-        result_type s2(get());
-        for (std::size_t k = 0; k != K; ++k)
-            if (s1[k] != s2[k])
-                return s2[k];
+        const std::uint64_t c = reserve(2);
 
-        return std::get<0>(s2);
+        return scalar(key(c + 1), key(c + 2));
     }
 
     void set(ResultType s)
     {
         seed_.fill(0);
         seed_.front() = s;
+        count_ = 0;
     }
 
-    void set(result_type seed) { seed_ = seed; }
+    void set(result_type seed)
+    {
+        seed_ = seed;
+        count_ = 0;
+    }
 
-    result_type seed() const { return seed_; }
+    result_type seed() const { return key(count_.load()); }
 
     result_type seed_max() const { return seed_max_; }
 
@@ -329,12 +489,12 @@ class SeedGenerator<ID, std::array<ResultType, K>>
         remainder_ = rem;
         seed_max_.fill(std::numeric_limits<skip_type>::max());
 
-        set(seed_);
+        set(seed());
     }
 
-    void skip(skip_type steps) { increment(seed_, steps); }
+    void skip(skip_type steps) { reserve(steps); }
 
-    void skip() { increment(seed_); }
+    void skip() { reserve(1); }
 
     template <typename CharT, typename Traits>
     friend std::basic_ostream<CharT, Traits> &operator<<(
@@ -344,7 +504,7 @@ class SeedGenerator<ID, std::array<ResultType, K>>
         if (!os.good())
             return os;
 
-        os << sg.seed_ << ' ';
+        os << sg.seed() << ' ';
         os << sg.divisor_ << ' ';
         os << sg.remainder_ << ' ';
 
@@ -379,15 +539,48 @@ class SeedGenerator<ID, std::array<ResultType, K>>
     result_type seed_max_;
     skip_type divisor_;
     skip_type remainder_;
-    std::mutex mtx_;
+    std::atomic<std::uint64_t> count_;
 
-    SeedGenerator() : divisor_(1), remainder_(0)
+    SeedGenerator() : divisor_(1), remainder_(0), count_(0)
     {
         seed_.fill(0);
         seed_max_.fill(0);
         modulo(divisor_, remainder_);
     }
 
+    // Advance the counter by `steps` atomically and return its value before
+    // the advance
+    std::uint64_t reserve(std::uint64_t steps)
+    {
+        return count_.fetch_add(steps, std::memory_order_relaxed);
+    }
+
+    // The internal seed after `c` increments since the last call to `set`
+    result_type key(std::uint64_t c) const
+    {
+        static constexpr int W = std::numeric_limits<ResultType>::digits;
+
+        result_type s(seed_);
+        for (std::size_t k = 0; k != K && c != 0; ++k) {
+            const ResultType r = static_cast<ResultType>(c);
+            c = W < 64 ? (c >> (W % 64)) : 0;
+            s[k] += r;
+            if (s[k] < r)
+                ++c;
+        }
+
+        return s;
+    }
+
+    static ResultType scalar(const result_type &s1, const result_type &s2)
+    {
+        for (std::size_t k = 0; k != K; ++k)
+            if (s1[k] != s2[k])
+                return s2[k];
+
+        return std::get<0>(s2);
+    }
+
     template <typename RNGType>
     void seed_rng_dispatch(RNGType &rng, std::true_type)
     {
@@ -399,6 +592,28 @@ class SeedGenerator<ID, std::array<ResultType, K>>
     {
         rng.seed(get_scalar());
     }
+
+    template <typename RNGIter, typename... Args>
+    void seed_rng_dispatch(
+        RNGIter first, std::size_t n, std::true_type, Args &&... args)
+    {
+        const std::uint64_t c = reserve(n);
+        internal::seed_rng_range(first, n,
+            [this, c](std::size_t i) { return key(c + i + 1); },
+            std::forward<Args>(args)...);
+    }
+
+    template <typename RNGIter, typename... Args>
+    void seed_rng_dispatch(
+        RNGIter first, std::size_t n, std::false_type, Args &&... args)
+    {
+        const std::uint64_t c = reserve(2 * n);
+        internal::seed_rng_range(first, n,
+            [this, c](std::size_t i) {
+                return scalar(key(c + 2 * i + 1), key(c + 2 * i + 2));
+            },
+            std::forward<Args>(args)...);
+    }
 }; // class SeedGenerator
 
 /// \brief The default Seed type
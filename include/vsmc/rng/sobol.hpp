@@ -0,0 +1,252 @@
+//============================================================================
+// vSMC/include/vsmc/rng/sobol.hpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c) 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#ifndef VSMC_RNG_SOBOL_HPP
+#define VSMC_RNG_SOBOL_HPP
+
+#include <vsmc/rng/internal/common.hpp>
+#include <vsmc/rng/uniform_bits_distribution.hpp>
+
+#define VSMC_RUNTIME_ASSERT_RNG_SOBOL_DIM(dim)                                \
+    VSMC_RUNTIME_ASSERT((dim > 0 && dim <= internal::sobol_max_dim()),       \
+        "**SobolSequence** CONSTRUCTED WITH INVALID DIMENSION")
+
+namespace vsmc
+{
+
+namespace internal
+{
+
+inline constexpr std::size_t sobol_max_dim() { return 21; }
+
+// Degrees, coefficients and initial direction numbers of the primitive
+// polynomials of dimensions 2 to 21 (Joe and Kuo, 2008)
+inline const std::uint32_t *sobol_poly(std::size_t d)
+{
+    static const std::uint32_t poly[][9] = {
+        {1, 0, 1},                         // 2
+        {2, 1, 1, 3},                      // 3
+        {3, 1, 1, 3, 1},                   // 4
+        {3, 2, 1, 1, 1},                   // 5
+        {4, 1, 1, 1, 3, 3},                // 6
+        {4, 4, 1, 3, 5, 13},               // 7
+        {5, 2, 1, 1, 5, 5, 17},            // 8
+        {5, 4, 1, 1, 5, 5, 5},             // 9
+        {5, 7, 1, 1, 7, 11, 19},           // 10
+        {5, 11, 1, 1, 5, 1, 1},            // 11
+        {5, 13, 1, 1, 1, 3, 11},           // 12
+        {5, 14, 1, 3, 5, 5, 31},           // 13
+        {6, 1, 1, 3, 3, 9, 7, 49},         // 14
+        {6, 13, 1, 1, 1, 15, 21, 21},      // 15
+        {6, 16, 1, 3, 1, 13, 27, 49},      // 16
+        {6, 19, 1, 1, 1, 15, 7, 5},        // 17
+        {6, 22, 1, 3, 1, 15, 13, 25},      // 18
+        {6, 25, 1, 1, 5, 5, 19, 61},       // 19
+        {7, 1, 1, 3, 7, 11, 23, 15, 103},  // 20
+        {7, 4, 1, 3, 7, 13, 13, 15, 69}};  // 21
+
+    return poly[d - 1];
+}
+
+// The 32 direction numbers of dimension d, the most significant bit first
+inline void sobol_direction(std::size_t d, std::uint32_t *v)
+{
+    if (d == 0) {
+        for (std::size_t k = 0; k != 32; ++k)
+            v[k] = static_cast<std::uint32_t>(1) << (31 - k);
+        return;
+    }
+
+    const std::uint32_t *p = sobol_poly(d);
+    const std::size_t s = p[0];
+    const std::uint32_t a = p[1];
+    for (std::size_t k = 0; k != s; ++k)
+        v[k] = p[k + 2] << (31 - k);
+    for (std::size_t k = s; k != 32; ++k) {
+        v[k] = v[k - s] ^ (v[k - s] >> s);
+        for (std::size_t i = 1; i != s; ++i)
+            if ((a >> (s - 1 - i)) & 1)
+                v[k] ^= v[k - i];
+    }
+}
+
+inline std::uint32_t sobol_parity(std::uint32_t x)
+{
+    x ^= x >> 16;
+    x ^= x >> 8;
+    x ^= x >> 4;
+    x ^= x >> 2;
+    x ^= x >> 1;
+
+    return x & 1;
+}
+
+} // namespace vsmc::internal
+
+/// \brief Sobol sequence with optional random scrambling
+/// \ingroup QMC
+///
+/// \details
+/// The sequence is generated in Gray code order with 32-bit direction numbers
+/// of Joe and Kuo (2008), up to `max_dim()` dimensions and \f$2^{32}\f$
+/// points. Each coordinate is truncated to its \f$W\f$ most significant bits,
+/// where \f$W\f$ is the smaller of 32 and one less than the number of
+/// significand bits of `RealType`, and returned at the center of its
+/// \f$2^{-W}\f$ cell. The conversion is exact, and thus each point lies
+/// strictly within \f$(0, 1)^d\f$.
+///
+/// `seek` computes any point directly, such that blocks of a sequence can be
+/// generated independently, e.g., in parallel. `scramble` applies a random
+/// linear matrix scrambling followed by a random digital shift (Matousek,
+/// 1998), which preserves the net properties of the sequence and makes each
+/// point uniformly distributed.
+template <typename RealType>
+class SobolSequence
+{
+    static_assert(std::is_floating_point<RealType>::value,
+        "**SobolSequence** USED WITH RealType OTHER THAN FLOATING POINT TYPES");
+
+    public:
+    using result_type = RealType;
+
+    explicit SobolSequence(std::size_t dim)
+        : dim_(dim), index_(0), v_(dim * 32), x_(dim), shift_(dim)
+    {
+        VSMC_RUNTIME_ASSERT_RNG_SOBOL_DIM(dim);
+        reset();
+    }
+
+    /// \brief The maximum dimension supported
+    static constexpr std::size_t max_dim() { return internal::sobol_max_dim(); }
+
+    std::size_t dim() const { return dim_; }
+
+    /// \brief The index of the next point
+    std::uint64_t index() const { return index_; }
+
+    /// \brief Remove the scrambling and restart the sequence
+    void reset()
+    {
+        for (std::size_t d = 0; d != dim_; ++d)
+            internal::sobol_direction(d, v_.data() + d * 32);
+        std::fill(shift_.begin(), shift_.end(), 0);
+        seek(0);
+    }
+
+    /// \brief Scramble the sequence with new random matrices and shifts, and
+    /// restart it
+    template <typename RNGType>
+    void scramble(RNGType &rng)
+    {
+        UniformBitsDistribution<std::uint32_t> rbits;
+        std::uint32_t v0[32];
+        std::uint32_t l[32];
+        for (std::size_t d = 0; d != dim_; ++d) {
+            // Row r of the lower triangular matrix has a unit diagonal and
+            // random bits at the 31 - r more significant positions
+            for (std::size_t r = 0; r != 32; ++r) {
+                const std::uint32_t diag = static_cast<std::uint32_t>(1)
+                    << (31 - r);
+                l[r] = diag | (r == 0 ? 0 : rbits(rng) & ~(diag - 1));
+            }
+            internal::sobol_direction(d, v0);
+            std::uint32_t *const v = v_.data() + d * 32;
+            for (std::size_t k = 0; k != 32; ++k) {
+                v[k] = 0;
+                for (std::size_t r = 0; r != 32; ++r)
+                    v[k] |= internal::sobol_parity(l[r] & v0[k]) << (31 - r);
+            }
+            shift_[d] = rbits(rng);
+        }
+        seek(0);
+    }
+
+    /// \brief Set the index of the next point
+    void seek(std::uint64_t n)
+    {
+        index_ = n;
+        const std::uint32_t g = static_cast<std::uint32_t>(n ^ (n >> 1));
+        for (std::size_t d = 0; d != dim_; ++d) {
+            const std::uint32_t *const v = v_.data() + d * 32;
+            std::uint32_t x = shift_[d];
+            for (std::size_t k = 0; k != 32; ++k)
+                if ((g >> k) & 1)
+                    x ^= v[k];
+            x_[d] = x;
+        }
+    }
+
+    /// \brief Skip the next `n` points
+    void discard(std::uint64_t n) { seek(index_ + n); }
+
+    /// \brief Generate the next point
+    void operator()(result_type *r)
+    {
+        static constexpr int W =
+            std::numeric_limits<result_type>::digits - 1 < 32 ?
+            std::numeric_limits<result_type>::digits - 1 :
+            32;
+
+        const result_type scale = static_cast<result_type>(1) /
+            static_cast<result_type>(static_cast<std::uint64_t>(1) << W);
+        const result_type half = static_cast<result_type>(0.5);
+        for (std::size_t d = 0; d != dim_; ++d) {
+            r[d] = (static_cast<result_type>(x_[d] >> (32 - W)) + half) *
+                scale;
+        }
+
+        std::size_t c = 0;
+        for (std::uint64_t i = index_; (i & 1) != 0 && c != 31; i >>= 1)
+            ++c;
+        for (std::size_t d = 0; d != dim_; ++d)
+            x_[d] ^= v_[d * 32 + c];
+        ++index_;
+    }
+
+    /// \brief Generate the next `n` points as an `n` by `dim()` row major
+    /// matrix
+    void operator()(std::size_t n, result_type *r)
+    {
+        for (std::size_t i = 0; i != n; ++i, r += dim_)
+            operator()(r);
+    }
+
+    private:
+    std::size_t dim_;
+    std::uint64_t index_;
+    Vector<std::uint32_t> v_;
+    Vector<std::uint32_t> x_;
+    Vector<std::uint32_t> shift_;
+}; // class SobolSequence
+
+} // namespace vsmc
+
+#endif // VSMC_RNG_SOBOL_HPP
@@ -81,6 +81,106 @@ class U01ImplPow2Inv
 namespace internal
 {
 
+/// \brief Vectorized bulk conversion of integers to floating points
+///
+/// \details
+/// Compute `r[i] = a * v + b` where `v = (u[i] << L) >> R`, plus its least
+/// significant bit if `Odd` is true. Return the number of elements
+/// converted, which are always the leading ones. The generic version does
+/// nothing, and the AVX2 versions are only provided for combinations of
+/// types where every step of the conversion is exact. Therefore the results
+/// are bit-identical to the scalar conversions in U01LRImpl.
+template <int L, int R, bool Odd, typename UIntType, typename RealType>
+inline std::size_t u01_lr_simd(
+    std::size_t, const UIntType *, RealType *, RealType, RealType) noexcept
+{
+    return 0;
+}
+
+#if VSMC_HAS_AVX2
+
+template <int L, int R, bool Odd>
+inline std::size_t u01_lr_simd(std::size_t n, const std::uint32_t *u,
+    double *r, double a, double b) noexcept
+{
+    const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000U));
+    const __m128i one = _mm_set1_epi32(1);
+    const __m256d pow31 = _mm256_set1_pd(2147483648.0);
+    const __m256d va = _mm256_set1_pd(a);
+    const __m256d vb = _mm256_set1_pd(b);
+
+    const std::size_t m = n / 4 * 4;
+    for (std::size_t i = 0; i != m; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(u + i));
+        v = _mm_srli_epi32(_mm_slli_epi32(v, L), R);
+        __m256d d = _mm256_add_pd(
+            _mm256_cvtepi32_pd(_mm_xor_si128(v, bias)), pow31);
+        if (Odd) {
+            d = _mm256_add_pd(
+                d, _mm256_cvtepi32_pd(_mm_and_si128(v, one)));
+        }
+        _mm256_storeu_pd(r + i, _mm256_add_pd(_mm256_mul_pd(d, va), vb));
+    }
+
+    return m;
+}
+
+template <int L, int R, bool Odd>
+inline std::size_t u01_lr_simd(std::size_t n, const std::uint64_t *u,
+    double *r, double a, double b) noexcept
+{
+    const __m256i mask = _mm256_set1_epi64x(0xFFFFFFFFLL);
+    const __m256i ebits = _mm256_set1_epi64x(0x4330000000000000LL);
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256d pow52 = _mm256_set1_pd(4503599627370496.0);
+    const __m256d pow32 = _mm256_set1_pd(4294967296.0);
+    const __m256d va = _mm256_set1_pd(a);
+    const __m256d vb = _mm256_set1_pd(b);
+
+    const std::size_t m = n / 4 * 4;
+    for (std::size_t i = 0; i != m; i += 4) {
+        __m256i v =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(u + i));
+        v = _mm256_srli_epi64(_mm256_slli_epi64(v, L), R);
+        if (Odd)
+            v = _mm256_add_epi64(v, _mm256_and_si256(v, one));
+        const __m256i hi = _mm256_or_si256(_mm256_srli_epi64(v, 32), ebits);
+        const __m256i lo = _mm256_or_si256(_mm256_and_si256(v, mask), ebits);
+        const __m256d dh = _mm256_sub_pd(_mm256_castsi256_pd(hi), pow52);
+        const __m256d dl = _mm256_sub_pd(_mm256_castsi256_pd(lo), pow52);
+        const __m256d d = _mm256_add_pd(_mm256_mul_pd(dh, pow32), dl);
+        _mm256_storeu_pd(r + i, _mm256_add_pd(_mm256_mul_pd(d, va), vb));
+    }
+
+    return m;
+}
+
+template <int L, int R, bool Odd>
+inline std::size_t u01_lr_simd(std::size_t n, const std::uint32_t *u,
+    float *r, float a, float b) noexcept
+{
+    static_assert(R > 1, "**u01_lr_simd** USED WITH OVERFLOWING SHIFTS");
+
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256 va = _mm256_set1_ps(a);
+    const __m256 vb = _mm256_set1_ps(b);
+
+    const std::size_t m = n / 8 * 8;
+    for (std::size_t i = 0; i != m; i += 8) {
+        __m256i v =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(u + i));
+        v = _mm256_srli_epi32(_mm256_slli_epi32(v, L), R);
+        if (Odd)
+            v = _mm256_add_epi32(v, _mm256_and_si256(v, one));
+        const __m256 d = _mm256_cvtepi32_ps(v);
+        _mm256_storeu_ps(r + i, _mm256_add_ps(_mm256_mul_ps(d, va), vb));
+    }
+
+    return m;
+}
+
+#endif // VSMC_HAS_AVX2
+
 template <typename, typename, typename, typename>
 class U01LRImpl;
 
@@ -104,11 +204,13 @@ class U01LRImpl<UIntType, RealType, Closed, Closed>
 
     static void eval(std::size_t n, const UIntType *u, RealType *r) noexcept
     {
-        for (std::size_t i = 0; i != n; ++i) {
+        const std::size_t k = u01_lr_simd<L, R + L, true>(n, u, r,
+            U01ImplPow2Inv<RealType, P + 1>::value, static_cast<RealType>(0));
+        for (std::size_t i = k; i != n; ++i) {
             r[i] = trans((u[i] << L) >> (R + L),
                 std::integral_constant<bool, (V < W)>());
         }
-        mul(n, U01ImplPow2Inv<RealType, P + 1>::value, r, r);
+        mul(n - k, U01ImplPow2Inv<RealType, P + 1>::value, r + k, r + k);
     }
 
     private:
@@ -140,9 +242,11 @@ class U01LRImpl<UIntType, RealType, Closed, Open>
 
     static void eval(std::size_t n, const UIntType *u, RealType *r) noexcept
     {
-        for (std::size_t i = 0; i != n; ++i)
+        const std::size_t k = u01_lr_simd<0, R, false>(n, u, r,
+            U01ImplPow2Inv<RealType, P>::value, static_cast<RealType>(0));
+        for (std::size_t i = k; i != n; ++i)
             r[i] = u[i] >> R;
-        mul(n, U01ImplPow2Inv<RealType, P>::value, r, r);
+        mul(n - k, U01ImplPow2Inv<RealType, P>::value, r + k, r + k);
     }
 }; // class U01LRImpl
 
@@ -164,10 +268,13 @@ class U01LRImpl<UIntType, RealType, Open, Closed>
 
     static void eval(std::size_t n, const UIntType *u, RealType *r) noexcept
     {
-        for (std::size_t i = 0; i != n; ++i)
+        const std::size_t k = u01_lr_simd<0, R, false>(n, u, r,
+            U01ImplPow2Inv<RealType, P>::value,
+            U01ImplPow2Inv<RealType, P>::value);
+        for (std::size_t i = k; i != n; ++i)
             r[i] = u[i] >> R;
-        fma(n, U01ImplPow2Inv<RealType, P>::value, r,
-            U01ImplPow2Inv<RealType, P>::value, r);
+        fma(n - k, U01ImplPow2Inv<RealType, P>::value, r + k,
+            U01ImplPow2Inv<RealType, P>::value, r + k);
     }
 }; // class U01LRImpl
 
@@ -189,10 +296,13 @@ class U01LRImpl<UIntType, RealType, Open, Open>
 
     static void eval(std::size_t n, const UIntType *u, RealType *r) noexcept
     {
-        for (std::size_t i = 0; i != n; ++i)
+        const std::size_t k = u01_lr_simd<0, R, false>(n, u, r,
+            U01ImplPow2Inv<RealType, P - 1>::value,
+            U01ImplPow2Inv<RealType, P>::value);
+        for (std::size_t i = k; i != n; ++i)
             r[i] = u[i] >> R;
-        fma(n, U01ImplPow2Inv<RealType, P - 1>::value, r,
-            U01ImplPow2Inv<RealType, P>::value, r);
+        fma(n - k, U01ImplPow2Inv<RealType, P - 1>::value, r + k,
+            U01ImplPow2Inv<RealType, P>::value, r + k);
     }
 }; // class U01LRImpl
 
@@ -171,46 +171,146 @@ class U01OODistribution
 namespace internal
 {
 
-template <std::size_t K, typename RealType, typename RNGType>
-inline void u01_distribution_impl(RNGType &rng, std::size_t n, RealType *r)
+template <std::size_t K, typename Left, typename Right, typename RealType,
+    typename RNGType>
+inline void u01_lr_distribution_impl(RNGType &rng, std::size_t n, RealType *r)
 {
     U01UIntType<RNGType> s[K];
     uniform_bits_distribution(rng, n, s);
-    u01_co<U01UIntType<RNGType>, RealType>(n, s, r);
+    u01_lr<U01UIntType<RNGType>, RealType, Left, Right>(n, s, r);
+}
+
+template <std::size_t K, typename Left, typename Right, typename RealType,
+    typename Generator>
+inline void u01_lr_distribution_impl(CounterEngine<Generator> &rng,
+    std::size_t n, RealType *r, std::false_type)
+{
+    U01UIntType<CounterEngine<Generator>> s[K];
+    uniform_bits_distribution(rng, n, s);
+    u01_lr<U01UIntType<CounterEngine<Generator>>, RealType, Left, Right>(
+        n, s, r);
+}
+
+template <std::size_t K, typename Left, typename Right, typename RealType,
+    typename Generator>
+inline void u01_lr_distribution_impl(CounterEngine<Generator> &rng,
+    std::size_t n, RealType *r, std::true_type)
+{
+    using result_type = typename CounterEngine<Generator>::result_type;
+
+    rng.generate(n, [&r](std::size_t k, const result_type *u) {
+        u01_lr<result_type, RealType, Left, Right>(k, u, r);
+        r += k;
+    });
+}
+
+/// \brief Fused generation and conversion for counter-based engines
+///
+/// \details
+/// The random integers are generated into stack tiles by
+/// `CounterEngine::generate` and converted to floating points directly from
+/// there, while they are still in the L1 cache. The results are identical to
+/// the generic version, which first copies them into a buffer.
+template <std::size_t K, typename Left, typename Right, typename RealType,
+    typename Generator>
+inline void u01_lr_distribution_impl(
+    CounterEngine<Generator> &rng, std::size_t n, RealType *r)
+{
+    u01_lr_distribution_impl<K, Left, Right>(rng, n, r,
+        std::integral_constant<bool,
+            std::is_same<typename CounterEngine<Generator>::result_type,
+                U01UIntType<CounterEngine<Generator>>>::value>());
+}
+
+template <std::size_t K, typename RealType, typename RNGType>
+inline void u01_distribution_impl(RNGType &rng, std::size_t n, RealType *r)
+{
+    u01_lr_distribution_impl<K, Closed, Open>(rng, n, r);
 }
 
 template <std::size_t K, typename RealType, typename RNGType>
 inline void u01_cc_distribution_impl(RNGType &rng, std::size_t n, RealType *r)
 {
-    U01UIntType<RNGType> s[K];
-    uniform_bits_distribution(rng, n, s);
-    u01_cc<U01UIntType<RNGType>, RealType>(n, s, r);
-    for (std::size_t i = 0; i != n; ++i)
-        r[i] = u01_cc<U01UIntType<RNGType>, RealType>(s[i]);
+    u01_lr_distribution_impl<K, Closed, Closed>(rng, n, r);
 }
 
 template <std::size_t K, typename RealType, typename RNGType>
 inline void u01_co_distribution_impl(RNGType &rng, std::size_t n, RealType *r)
 {
-    U01UIntType<RNGType> s[K];
-    uniform_bits_distribution(rng, n, s);
-    u01_co<U01UIntType<RNGType>, RealType>(n, s, r);
+    u01_lr_distribution_impl<K, Closed, Open>(rng, n, r);
 }
 
 template <std::size_t K, typename RealType, typename RNGType>
 inline void u01_oc_distribution_impl(RNGType &rng, std::size_t n, RealType *r)
 {
-    U01UIntType<RNGType> s[K];
-    uniform_bits_distribution(rng, n, s);
-    u01_oc<U01UIntType<RNGType>, RealType>(n, s, r);
+    u01_lr_distribution_impl<K, Open, Closed>(rng, n, r);
 }
 
 template <std::size_t K, typename RealType, typename RNGType>
 inline void u01_oo_distribution_impl(RNGType &rng, std::size_t n, RealType *r)
 {
-    U01UIntType<RNGType> s[K];
-    uniform_bits_distribution(rng, n, s);
-    u01_oo<U01UIntType<RNGType>, RealType>(n, s, r);
+    u01_lr_distribution_impl<K, Open, Open>(rng, n, r);
+}
+
+template <std::size_t K, typename RealType, typename RNGType, typename Op>
+inline void u01_distribution_tile_impl(
+    RNGType &rng, std::size_t n, RealType *r, std::size_t i, Op &op)
+{
+    u01_distribution_impl<K>(rng, n, r + i);
+    if (n != 0)
+        op(i, n);
+}
+
+template <std::size_t K, typename RealType, typename Generator, typename Op>
+inline void u01_distribution_tile_impl(CounterEngine<Generator> &rng,
+    std::size_t n, RealType *r, std::size_t i, Op &op, std::false_type)
+{
+    u01_distribution_impl<K>(rng, n, r + i);
+    if (n != 0)
+        op(i, n);
+}
+
+template <std::size_t K, typename RealType, typename Generator, typename Op>
+inline void u01_distribution_tile_impl(CounterEngine<Generator> &rng,
+    std::size_t n, RealType *r, std::size_t i, Op &op, std::true_type)
+{
+    using result_type = typename CounterEngine<Generator>::result_type;
+
+    rng.generate(n, [r, &i, &op](std::size_t k, const result_type *u) {
+        u01_lr<result_type, RealType, Closed, Open>(k, u, r + i);
+        op(i, k);
+        i += k;
+    });
+}
+
+template <std::size_t K, typename RealType, typename Generator, typename Op>
+inline void u01_distribution_tile_impl(CounterEngine<Generator> &rng,
+    std::size_t n, RealType *r, std::size_t i, Op &op)
+{
+    u01_distribution_tile_impl<K>(rng, n, r, i, op,
+        std::integral_constant<bool,
+            std::is_same<typename CounterEngine<Generator>::result_type,
+                U01UIntType<CounterEngine<Generator>>>::value>());
+}
+
+// Generate the same standard uniform random variates as u01_distribution,
+// calling op(i, k) in order as soon as each range [i, i + k) of r is written,
+// while it is still in the L1 cache. The ranges are the tiles of
+// CounterEngine::generate for counter-based engines, and blocks of at most
+// 1024 elements otherwise. Thus the results of a transformation applied by op
+// are the same as those of applying it to the whole array afterwards, as long
+// as each element is transformed independently of its position
+template <typename RealType, typename RNGType, typename Op>
+inline void u01_distribution_tile(
+    RNGType &rng, std::size_t n, RealType *r, Op &&op)
+{
+    const std::size_t k = 1024;
+    const std::size_t m = n / k;
+    const std::size_t l = n % k;
+    std::size_t i = 0;
+    for (std::size_t j = 0; j != m; ++j, i += k)
+        u01_distribution_tile_impl<k>(rng, k, r, i, op);
+    u01_distribution_tile_impl<k>(rng, l, r, i, op);
 }
 
 } // namespace vsmc::internal
@@ -33,6 +33,15 @@
 #define VSMC_SMP_BACKEND_BASE_HPP
 
 #include <vsmc/internal/common.hpp>
+#include <vsmc/core/weight.hpp>
+
+/// \brief The number of particles of each block processed by the SMP
+/// backends, whose states are prefetched while the previous block is
+/// processed
+/// \ingroup Config
+#ifndef VSMC_SMP_STREAM_SIZE
+#define VSMC_SMP_STREAM_SIZE 4096
+#endif
 
 #if VSMC_NO_RUNTIME_ASSERT
 #define VSMC_BACKEND_BASE_DESTRUCTOR_PREFIX
@@ -82,6 +91,144 @@
 namespace vsmc
 {
 
+namespace internal
+{
+
+template <typename T>
+class is_double_buffer_impl
+{
+    template <typename U>
+    static std::true_type test(
+        decltype(std::declval<const U &>().double_buffer()) *);
+
+    template <typename U>
+    static std::false_type test(...);
+
+    public:
+    static constexpr bool value = decltype(test<T>(nullptr))::value;
+}; // class is_double_buffer_impl
+
+// Whether a state may gather the particles into a double buffer, as
+// StateMatrix does
+template <typename T>
+class is_double_buffer
+    : public std::integral_constant<bool, is_double_buffer_impl<T>::value>
+{
+}; // class is_double_buffer
+
+template <typename T>
+class is_prefetch_impl
+{
+    template <typename U>
+    static std::true_type test(decltype(std::declval<const U &>().prefetch(
+        std::declval<SizeType<U>>(), std::declval<SizeType<U>>())) *);
+
+    template <typename U>
+    static std::false_type test(...);
+
+    public:
+    static constexpr bool value = decltype(test<T>(nullptr))::value;
+}; // class is_prefetch_impl
+
+// Whether a state can prefetch a range of particles, as StateMatrix does
+template <typename T>
+class is_prefetch
+    : public std::integral_constant<bool, is_prefetch_impl<T>::value>
+{
+}; // class is_prefetch
+
+template <typename StateType>
+inline void smp_prefetch_dispatch(const StateType &state,
+    SizeType<StateType> first, SizeType<StateType> last, std::true_type)
+{
+    state.prefetch(first, last);
+}
+
+template <typename StateType>
+inline void smp_prefetch_dispatch(const StateType &, SizeType<StateType>,
+    SizeType<StateType>, std::false_type)
+{
+}
+
+// Process the particles `first` to `last - 1` by calling `f(i, j)` for each
+// block `[i, j)` of `VSMC_SMP_STREAM_SIZE` particles, prefetching the states
+// of the next block before each call
+template <typename StateType, typename F>
+inline void smp_stream(const StateType &state, SizeType<StateType> first,
+    SizeType<StateType> last, F &&f)
+{
+    using size_type = SizeType<StateType>;
+
+    const size_type block = VSMC_SMP_STREAM_SIZE;
+    if (last - first <= block) {
+        f(first, last);
+        return;
+    }
+
+    smp_prefetch_dispatch(
+        state, first, first + block, is_prefetch<StateType>());
+    for (size_type i = first; i < last; i += block) {
+        const size_type j = std::min(i + block, last);
+        smp_prefetch_dispatch(state, j, std::min(j + block, last),
+            is_prefetch<StateType>());
+        f(i, j);
+    }
+}
+
+template <typename StateType, typename IntType>
+inline void smp_copy_dispatch(StateType &state, SizeType<StateType> first,
+    SizeType<StateType> last, const IntType *index, std::true_type)
+{
+    if (state.double_buffer()) {
+        state.gather(first, last, index);
+        return;
+    }
+    for (SizeType<StateType> i = first; i != last; ++i)
+        state.copy_particle(static_cast<SizeType<StateType>>(index[i]), i);
+}
+
+template <typename StateType, typename IntType>
+inline void smp_copy_dispatch(StateType &state, SizeType<StateType> first,
+    SizeType<StateType> last, const IntType *index, std::false_type)
+{
+    for (SizeType<StateType> i = first; i != last; ++i)
+        state.copy_particle(static_cast<SizeType<StateType>>(index[i]), i);
+}
+
+// Copy the particles `first` to `last - 1` from their parents, into the
+// double buffer if it is enabled, block by block
+template <typename StateType, typename IntType>
+inline void smp_copy(StateType &state, SizeType<StateType> first,
+    SizeType<StateType> last, const IntType *index)
+{
+    smp_stream(state, first, last,
+        [&state, index](SizeType<StateType> i, SizeType<StateType> j) {
+            smp_copy_dispatch(
+                state, i, j, index, is_double_buffer<StateType>());
+        });
+}
+
+template <typename StateType>
+inline void smp_copy_post_dispatch(StateType &state, std::true_type)
+{
+    if (state.double_buffer())
+        state.swap_buffer();
+}
+
+template <typename StateType>
+inline void smp_copy_post_dispatch(StateType &, std::false_type)
+{
+}
+
+// Swap the double buffer, if it is enabled, after all particles are copied
+template <typename StateType>
+inline void smp_copy_post(StateType &state)
+{
+    smp_copy_post_dispatch(state, is_double_buffer<StateType>());
+}
+
+} // namespace vsmc::internal
+
 /// \brief Template type parameter that cause the base class to use dynamic
 /// dispatch
 /// \ingroup SMP
@@ -368,8 +515,10 @@ template <typename T, typename Derived>
 class MonitorEvalBase
 {
     public:
-    void eval_sp(
-        std::size_t iter, std::size_t dim, SingleParticle<T> sp, double *r)
+    using result_type = WeightValueType<WeightType<T>>;
+
+    void eval_sp(std::size_t iter, std::size_t dim, SingleParticle<T> sp,
+        result_type *r)
     {
         eval_sp_dispatch(iter, dim, sp, r, &Derived::eval_sp);
     }
@@ -392,8 +541,8 @@ class MonitorEvalBase
 
     template <typename D>
     void eval_sp_dispatch(std::size_t iter, std::size_t dim,
-        SingleParticle<T> sp, double *r,
-        void (D::*)(std::size_t, std::size_t, SingleParticle<T>, double *))
+        SingleParticle<T> sp, result_type *r,
+        void (D::*)(std::size_t, std::size_t, SingleParticle<T>, result_type *))
     {
         static_cast<Derived *>(this)->eval_sp(iter, dim, sp, r);
     }
@@ -416,9 +565,9 @@ class MonitorEvalBase
 
     template <typename D>
     void eval_sp_dispatch(std::size_t iter, std::size_t dim,
-        SingleParticle<T> sp, double *r,
-        void (D::*)(std::size_t, std::size_t, SingleParticle<T>, double *)
-            const)
+        SingleParticle<T> sp, result_type *r,
+        void (D::*)(
+            std::size_t, std::size_t, SingleParticle<T>, result_type *) const)
     {
         static_cast<Derived *>(this)->eval_sp(iter, dim, sp, r);
     }
@@ -440,8 +589,8 @@ class MonitorEvalBase
     // static
 
     void eval_sp_dispatch(std::size_t iter, std::size_t dim,
-        SingleParticle<T> sp, double *r,
-        void (*)(std::size_t, std::size_t, SingleParticle<T>, double *))
+        SingleParticle<T> sp, result_type *r,
+        void (*)(std::size_t, std::size_t, SingleParticle<T>, result_type *))
     {
         Derived::eval_sp(iter, dim, sp, r);
     }
@@ -461,8 +610,8 @@ class MonitorEvalBase
     // base
 
     void eval_sp_dispatch(std::size_t, std::size_t, SingleParticle<T>,
-        double *, void (MonitorEvalBase::*)(std::size_t, std::size_t,
-                              SingleParticle<T>, double *))
+        result_type *, void (MonitorEvalBase::*)(std::size_t, std::size_t,
+                           SingleParticle<T>, result_type *))
     {
     }
 
@@ -483,7 +632,10 @@ template <typename T>
 class MonitorEvalBase<T, Virtual>
 {
     public:
-    virtual void eval_sp(std::size_t, std::size_t, SingleParticle<T>, double *)
+    using result_type = WeightValueType<WeightType<T>>;
+
+    virtual void eval_sp(
+        std::size_t, std::size_t, SingleParticle<T>, result_type *)
     {
     }
     virtual void eval_pre(std::size_t, Particle<T> &) {}
@@ -40,6 +40,23 @@ namespace vsmc
 
 VSMC_DEFINE_SMP_BACKEND_FORWARD(OMP)
 
+namespace internal
+{
+
+// Process the range of the particles of the calling thread in a parallel
+// region, block by block, see smp_stream
+template <typename StateType, typename F>
+inline void omp_stream(const StateType &state, SizeType<StateType> N, F &&f)
+{
+    using size_type = SizeType<StateType>;
+
+    const size_type np = static_cast<size_type>(::omp_get_num_threads());
+    const size_type id = static_cast<size_type>(::omp_get_thread_num());
+    smp_stream(state, N * id / np, N * (id + 1) / np, std::forward<F>(f));
+}
+
+} // namespace vsmc::internal
+
 /// \brief Particle::value_type subtype using OpenMP
 /// \ingroup OMP
 template <typename StateBase>
@@ -50,12 +67,25 @@ class StateOMP : public StateBase
 
     explicit StateOMP(size_type N) : StateBase(N) {}
 
+    template <typename S = StateBase,
+        typename = typename std::enable_if<
+            std::is_constructible<S, size_type, FirstTouch>::value>::type>
+    StateOMP(size_type N, FirstTouch touch) : StateBase(N, touch)
+    {
+    }
+
     template <typename IntType>
     void copy(size_type N, const IntType *src_idx)
     {
-#pragma omp parallel for default(shared)
-        for (size_type i = 0; i < N; ++i)
-            this->copy_particle(static_cast<size_type>(src_idx[i]), i);
+#pragma omp parallel default(shared)
+        {
+            const size_type np =
+                static_cast<size_type>(::omp_get_num_threads());
+            const size_type id = static_cast<size_type>(::omp_get_thread_num());
+            internal::smp_copy(
+                *this, N * id / np, N * (id + 1) / np, src_idx);
+        }
+        internal::smp_copy_post(*this);
     }
 }; // class StateOMP
 
@@ -72,9 +102,12 @@ class InitializeOMP : public InitializeBase<T, Derived>
         this->eval_param(particle, param);
         this->eval_pre(particle);
         std::size_t accept = 0;
-#pragma omp parallel for reduction(+ : accept) default(shared)
-        for (size_type i = 0; i < N; ++i)
-            accept += this->eval_sp(particle.sp(i));
+#pragma omp parallel reduction(+ : accept) default(shared)
+        internal::omp_stream(particle.value(), N,
+            [this, &particle, &accept](size_type first, size_type last) {
+                for (size_type i = first; i != last; ++i)
+                    accept += this->eval_sp(particle.sp(i));
+            });
         this->eval_post(particle);
 
         return accept;
@@ -96,9 +129,12 @@ class MoveOMP : public MoveBase<T, Derived>
         const size_type N = particle.size();
         this->eval_pre(iter, particle);
         std::size_t accept = 0;
-#pragma omp parallel for reduction(+ : accept) default(shared)
-        for (size_type i = 0; i < N; ++i)
-            accept += this->eval_sp(iter, particle.sp(i));
+#pragma omp parallel reduction(+ : accept) default(shared)
+        internal::omp_stream(particle.value(), N,
+            [this, iter, &particle, &accept](size_type first, size_type last) {
+                for (size_type i = first; i != last; ++i)
+                    accept += this->eval_sp(iter, particle.sp(i));
+            });
         this->eval_post(iter, particle);
 
         return accept;
@@ -114,17 +150,22 @@ template <typename T, typename Derived>
 class MonitorEvalOMP : public MonitorEvalBase<T, Derived>
 {
     public:
-    void operator()(
-        std::size_t iter, std::size_t dim, Particle<T> &particle, double *r)
+    using result_type = typename MonitorEvalBase<T, Derived>::result_type;
+
+    void operator()(std::size_t iter, std::size_t dim, Particle<T> &particle,
+        result_type *r)
     {
         using size_type = typename Particle<T>::size_type;
         const size_type N = particle.size();
         this->eval_pre(iter, particle);
-#pragma omp parallel for default(shared)
-        for (size_type i = 0; i < N; ++i) {
-            this->eval_sp(iter, dim, particle.sp(i),
-                r + static_cast<std::size_t>(i) * dim);
-        }
+#pragma omp parallel default(shared)
+        internal::omp_stream(particle.value(), N,
+            [this, iter, dim, &particle, r](size_type first, size_type last) {
+                for (size_type i = first; i != last; ++i) {
+                    this->eval_sp(iter, dim, particle.sp(i),
+                        r + static_cast<std::size_t>(i) * dim);
+                }
+            });
         this->eval_post(iter, particle);
     }
 
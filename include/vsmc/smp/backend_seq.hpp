@@ -57,8 +57,11 @@ class InitializeSEQ : public InitializeBase<T, Derived>
         this->eval_param(particle, param);
         this->eval_pre(particle);
         std::size_t accept = 0;
-        for (size_type i = 0; i != N; ++i)
-            accept += this->eval_sp(SingleParticle<T>(i, &particle));
+        internal::smp_stream(particle.value(), 0, N,
+            [this, &particle, &accept](size_type first, size_type last) {
+                for (size_type i = first; i != last; ++i)
+                    accept += this->eval_sp(SingleParticle<T>(i, &particle));
+            });
         this->eval_post(particle);
 
         return accept;
@@ -80,8 +83,13 @@ class MoveSEQ : public MoveBase<T, Derived>
         const size_type N = particle.size();
         this->eval_pre(iter, particle);
         std::size_t accept = 0;
-        for (size_type i = 0; i != N; ++i)
-            accept += this->eval_sp(iter, SingleParticle<T>(i, &particle));
+        internal::smp_stream(particle.value(), 0, N,
+            [this, iter, &particle, &accept](size_type first, size_type last) {
+                for (size_type i = first; i != last; ++i) {
+                    accept +=
+                        this->eval_sp(iter, SingleParticle<T>(i, &particle));
+                }
+            });
         this->eval_post(iter, particle);
 
         return accept;
@@ -97,16 +105,21 @@ template <typename T, typename Derived>
 class MonitorEvalSEQ : public MonitorEvalBase<T, Derived>
 {
     public:
-    void operator()(
-        std::size_t iter, std::size_t dim, Particle<T> &particle, double *r)
+    using result_type = typename MonitorEvalBase<T, Derived>::result_type;
+
+    void operator()(std::size_t iter, std::size_t dim, Particle<T> &particle,
+        result_type *r)
     {
         using size_type = typename Particle<T>::size_type;
         const size_type N = particle.size();
         this->eval_pre(iter, particle);
-        for (size_type i = 0; i != N; ++i) {
-            this->eval_sp(iter, dim, SingleParticle<T>(i, &particle),
-                r + static_cast<std::size_t>(i) * dim);
-        }
+        internal::smp_stream(particle.value(), 0, N,
+            [this, iter, dim, &particle, r](size_type first, size_type last) {
+                for (size_type i = first; i != last; ++i) {
+                    this->eval_sp(iter, dim, SingleParticle<T>(i, &particle),
+                        r + static_cast<std::size_t>(i) * dim);
+                }
+            });
         this->eval_post(iter, particle);
     }
 
@@ -63,6 +63,17 @@ VSMC_DEFINE_SMP_BACKEND_FORWARD(TBB)
 
 /// \brief Particle::value_type subtype using Intel Threading Building Blocks
 /// \ingroup TBB
+///
+/// \details
+/// If the double buffer of `StateBase`, e.g., StateMatrix, is enabled, then
+/// `parallel_copy_run` gathers the particles into it, and `copy` swaps it
+/// after the gathering.
+///
+/// Unless a partitioner is given, the loops of this backend use
+/// `tbb::static_partitioner` (TBB 2017 or later), which maps the same ranges
+/// of particles to the same threads as FirstTouchTBB, such that each thread
+/// processes the memory it first touched. The other partitioners balance the
+/// load dynamically but do not preserve this locality.
 template <typename StateBase>
 class StateTBB : public StateBase
 {
@@ -71,10 +82,18 @@ class StateTBB : public StateBase
 
     explicit StateTBB(size_type N) : StateBase(N) {}
 
+    template <typename S = StateBase,
+        typename = typename std::enable_if<
+            std::is_constructible<S, size_type, FirstTouch>::value>::type>
+    StateTBB(size_type N, FirstTouch touch) : StateBase(N, touch)
+    {
+    }
+
     template <typename IntType>
     void copy(size_type N, const IntType *index)
     {
         parallel_copy_run(index, ::tbb::blocked_range<size_type>(0, N));
+        internal::smp_copy_post(*this);
     }
 
     protected:
@@ -89,9 +108,7 @@ class StateTBB : public StateBase
 
         void operator()(const ::tbb::blocked_range<size_type> &range) const
         {
-            for (size_type i = range.begin(); i != range.end(); ++i) {
-                state_->copy_particle(static_cast<size_type>(index_[i]), i);
-            }
+            internal::smp_copy(*state_, range.begin(), range.end(), index_);
         }
 
         private:
@@ -103,7 +120,8 @@ class StateTBB : public StateBase
     void parallel_copy_run(
         const IntType *index, const ::tbb::blocked_range<size_type> &range)
     {
-        ::tbb::parallel_for(range, work_type<IntType>(this, index));
+        ::tbb::parallel_for(range, work_type<IntType>(this, index),
+            internal::TBBStaticPartitioner());
     }
 
     template <typename IntType>
@@ -199,8 +217,11 @@ class InitializeTBB : public InitializeBase<T, Derived>
 
         void operator()(const ::tbb::blocked_range<size_type> &range)
         {
-            for (size_type i = range.begin(); i != range.end(); ++i)
-                accept_ += wptr_->eval_sp(pptr_->sp(i));
+            internal::smp_stream(pptr_->value(), range.begin(), range.end(),
+                [this](size_type first, size_type last) {
+                    for (size_type i = first; i != last; ++i)
+                        accept_ += wptr_->eval_sp(pptr_->sp(i));
+                });
         }
 
         void join(const work_type &other) { accept_ += other.accept_; }
@@ -216,7 +237,8 @@ class InitializeTBB : public InitializeBase<T, Derived>
     std::size_t parallel_run(Particle<T> &particle, void *param,
         const ::tbb::blocked_range<typename Particle<T>::size_type> &range)
     {
-        VSMC_DEFINE_SMP_BACKEND_TBB_PARALLEL_RUN_INITIALIZE((range, work));
+        VSMC_DEFINE_SMP_BACKEND_TBB_PARALLEL_RUN_INITIALIZE(
+            (range, work, internal::TBBStaticPartitioner()));
     }
 
     std::size_t parallel_run(Particle<T> &particle, void *param,
@@ -310,8 +332,11 @@ class MoveTBB : public MoveBase<T, Derived>
 
         void operator()(const ::tbb::blocked_range<size_type> &range)
         {
-            for (size_type i = range.begin(); i != range.end(); ++i)
-                accept_ += wptr_->eval_sp(iter_, pptr_->sp(i));
+            internal::smp_stream(pptr_->value(), range.begin(), range.end(),
+                [this](size_type first, size_type last) {
+                    for (size_type i = first; i != last; ++i)
+                        accept_ += wptr_->eval_sp(iter_, pptr_->sp(i));
+                });
         }
 
         void join(const work_type &other) { accept_ += other.accept_; }
@@ -328,7 +353,8 @@ class MoveTBB : public MoveBase<T, Derived>
     std::size_t parallel_run(std::size_t iter, Particle<T> &particle,
         const ::tbb::blocked_range<typename Particle<T>::size_type> &range)
     {
-        VSMC_DEFINE_SMP_BACKEND_TBB_PARALLEL_RUN_MOVE((range, work));
+        VSMC_DEFINE_SMP_BACKEND_TBB_PARALLEL_RUN_MOVE(
+            (range, work, internal::TBBStaticPartitioner()));
     }
 
     std::size_t parallel_run(std::size_t iter, Particle<T> &particle,
@@ -391,8 +417,10 @@ template <typename T, typename Derived>
 class MonitorEvalTBB : public MonitorEvalBase<T, Derived>
 {
     public:
-    void operator()(
-        std::size_t iter, std::size_t dim, Particle<T> &particle, double *r)
+    using result_type = typename MonitorEvalBase<T, Derived>::result_type;
+
+    void operator()(std::size_t iter, std::size_t dim, Particle<T> &particle,
+        result_type *r)
     {
         parallel_run(iter, dim, particle, r,
             ::tbb::blocked_range<typename Particle<T>::size_type>(
@@ -408,17 +436,20 @@ class MonitorEvalTBB : public MonitorEvalBase<T, Derived>
         using size_type = typename Particle<T>::size_type;
 
         work_type(MonitorEvalTBB<T, Derived> *wptr, std::size_t iter,
-            std::size_t dim, Particle<T> *pptr, double *r)
+            std::size_t dim, Particle<T> *pptr, result_type *r)
             : wptr_(wptr), iter_(iter), dim_(dim), pptr_(pptr), r_(r)
         {
         }
 
         void operator()(const ::tbb::blocked_range<size_type> &range) const
         {
-            for (size_type i = range.begin(); i != range.end(); ++i) {
-                wptr_->eval_sp(iter_, dim_, pptr_->sp(i),
-                    r_ + static_cast<std::size_t>(i) * dim_);
-            }
+            internal::smp_stream(pptr_->value(), range.begin(), range.end(),
+                [this](size_type first, size_type last) {
+                    for (size_type i = first; i != last; ++i) {
+                        wptr_->eval_sp(iter_, dim_, pptr_->sp(i),
+                            r_ + static_cast<std::size_t>(i) * dim_);
+                    }
+                });
         }
 
         private:
@@ -426,18 +457,19 @@ class MonitorEvalTBB : public MonitorEvalBase<T, Derived>
         const std::size_t iter_;
         const std::size_t dim_;
         Particle<T> *const pptr_;
-        double *const r_;
+        result_type *const r_;
     }; // class work_type
 
     void parallel_run(std::size_t iter, std::size_t dim, Particle<T> &particle,
-        double *r,
+        result_type *r,
         const ::tbb::blocked_range<typename Particle<T>::size_type> &range)
     {
-        VSMC_DEFINE_SMP_BACKEND_TBB_PARALLEL_RUN_MONITOR_EVAL((range, work));
+        VSMC_DEFINE_SMP_BACKEND_TBB_PARALLEL_RUN_MONITOR_EVAL(
+            (range, work, internal::TBBStaticPartitioner()));
     }
 
     void parallel_run(std::size_t iter, std::size_t dim, Particle<T> &particle,
-        double *r,
+        result_type *r,
         const ::tbb::blocked_range<typename Particle<T>::size_type> &range,
         const ::tbb::auto_partitioner &partitioner)
     {
@@ -446,7 +478,7 @@ class MonitorEvalTBB : public MonitorEvalBase<T, Derived>
     }
 
     void parallel_run(std::size_t iter, std::size_t dim, Particle<T> &particle,
-        double *r,
+        result_type *r,
         const ::tbb::blocked_range<typename Particle<T>::size_type> &range,
         const ::tbb::simple_partitioner &partitioner)
     {
@@ -455,7 +487,7 @@ class MonitorEvalTBB : public MonitorEvalBase<T, Derived>
     }
 
     void parallel_run(std::size_t iter, std::size_t dim, Particle<T> &particle,
-        double *r,
+        result_type *r,
         const ::tbb::blocked_range<typename Particle<T>::size_type> &range,
         ::tbb::affinity_partitioner &partitioner)
     {
@@ -465,7 +497,7 @@ class MonitorEvalTBB : public MonitorEvalBase<T, Derived>
 
 #if __TBB_TASK_GROUP_CONTEXT
     void parallel_run(std::size_t iter, std::size_t dim, Particle<T> &particle,
-        double *r,
+        result_type *r,
         const ::tbb::blocked_range<typename Particle<T>::size_type> &range,
         const ::tbb::auto_partitioner &partitioner,
         ::tbb::task_group_context &context)
@@ -475,7 +507,7 @@ class MonitorEvalTBB : public MonitorEvalBase<T, Derived>
     }
 
     void parallel_run(std::size_t iter, std::size_t dim, Particle<T> &particle,
-        double *r,
+        result_type *r,
         const ::tbb::blocked_range<typename Particle<T>::size_type> &range,
         const ::tbb::simple_partitioner &partitioner,
         ::tbb::task_group_context &context)
@@ -485,7 +517,7 @@ class MonitorEvalTBB : public MonitorEvalBase<T, Derived>
     }
 
     void parallel_run(std::size_t iter, std::size_t dim, Particle<T> &particle,
-        double *r,
+        result_type *r,
         const ::tbb::blocked_range<typename Particle<T>::size_type> &range,
         ::tbb::affinity_partitioner &partitioner,
         ::tbb::task_group_context &context)
@@ -35,10 +35,13 @@
 #include <vsmc/internal/assert.hpp>
 #include <vsmc/internal/config.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdlib>
 #include <limits>
 #include <memory>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 #if VSMC_HAS_POSIX
@@ -47,6 +50,15 @@
 #include <malloc.h>
 #endif
 
+#if VSMC_HAS_POSIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if VSMC_HAS_NUMA
+#include <numaif.h>
+#endif
+
 #if VSMC_HAS_TBB_MALLOC
 #include <tbb/scalable_allocator.h>
 #endif
@@ -75,6 +87,28 @@
 #define VSMC_ALIGNMENT 32
 #endif
 
+/// \brief Size of huge pages used by AlignedMemoryPage
+/// \ingroup Config
+#ifndef VSMC_HUGE_PAGE_SIZE
+#define VSMC_HUGE_PAGE_SIZE 2097152
+#endif
+
+/// \brief Allocations smaller than this number of bytes are not mapped by
+/// AlignedMemoryPage
+/// \ingroup Config
+#ifndef VSMC_ALIGNED_MEMORY_PAGE_THRESHOLD
+#define VSMC_ALIGNED_MEMORY_PAGE_THRESHOLD VSMC_HUGE_PAGE_SIZE
+#endif
+
+#define VSMC_RUNTIME_WARNING_UTILITY_ALIGNED_MEMORY_MBIND(status)             \
+    VSMC_RUNTIME_WARNING((status == 0),                                       \
+        "**AlignedMemoryPage::aligned_malloc** mbind FAILED")
+
+#define VSMC_RUNTIME_WARNING_UTILITY_ALIGNED_MEMORY_FILE(fd)                  \
+    VSMC_RUNTIME_WARNING((fd != -1),                                          \
+        "**AlignedMemoryPage::aligned_malloc** FAILED TO CREATE A FILE IN "   \
+        "THE DIRECTORY OF MemoryFileDir")
+
 #define VSMC_RUNTIME_ASSERT_UTILITY_ALIGNED_MEMORY_POWER_OF_TWO(alignment)    \
     VSMC_RUNTIME_ASSERT(                                                      \
         (alignment != 0 && (alignment & (alignment - 1)) == 0),               \
@@ -233,6 +267,379 @@ class AlignedMemoryMKL
 
 #endif // VSMC_HAS_MKL
 
+#if VSMC_HAS_POSIX
+
+/// \brief Page types of memory mapped by AlignedMemoryPage
+/// \ingroup AlignedMemory
+enum MemoryPage {
+    PageDefault, ///< Pages of the system default size
+    PageHuge,    ///< Transparent huge pages, requested by `madvise`
+    PageHugeTLB, ///< Reserved huge pages, `MAP_HUGETLB`, or else `PageHuge`
+    PageFile     ///< Shared pages of an unlinked file in MemoryFileDir
+};               // enum MemoryPage
+
+/// \brief NUMA placement of memory mapped by AlignedMemoryPage
+/// \ingroup AlignedMemory
+enum MemoryNUMA {
+    NUMADefault,    ///< The policy of the calling thread, usually first touch
+    NUMAInterleave, ///< Pages interleaved across the nodes of NUMANodes
+    NUMABind        ///< Pages bound to the nodes of NUMANodes
+};                  // enum MemoryNUMA
+
+/// \brief The NUMA nodes used by AlignedMemoryPage
+/// \ingroup AlignedMemory
+///
+/// \details
+/// By default, all nodes allowed to the process are used. The nodes shall be
+/// set before any allocation that uses them. Without `VSMC_HAS_NUMA`, the
+/// nodes are recorded but not used.
+class NUMANodes
+{
+    public:
+    static NUMANodes &instance()
+    {
+        static NUMANodes nodes;
+
+        return nodes;
+    }
+
+    /// \brief Use all nodes allowed to the process
+    void reset()
+    {
+        std::fill(mask_, mask_ + size_, 0UL);
+#if VSMC_HAS_NUMA
+        if (::get_mempolicy(nullptr, mask_, maxnode(), nullptr,
+                MPOL_F_MEMS_ALLOWED) != 0) {
+            std::fill(mask_, mask_ + size_, 0UL);
+        }
+#endif
+    }
+
+    /// \brief Use the nodes in the range `[first, last)`
+    template <typename InputIter>
+    void set(InputIter first, InputIter last)
+    {
+        std::fill(mask_, mask_ + size_, 0UL);
+        for (; first != last; ++first)
+            add(static_cast<std::size_t>(*first));
+    }
+
+    /// \brief Add a node
+    void add(std::size_t node)
+    {
+        if (node < maxnode())
+            mask_[node / bits_] |= 1UL << (node % bits_);
+    }
+
+    /// \brief If no node is set, in which case the policy is not changed
+    bool empty() const
+    {
+        for (std::size_t i = 0; i != size_; ++i)
+            if (mask_[i] != 0)
+                return false;
+        return true;
+    }
+
+    /// \brief The node mask, as used by `mbind`
+    const unsigned long *mask() const { return mask_; }
+
+    /// \brief The number of bits of the node mask
+    unsigned long maxnode() const { return size_ * bits_; }
+
+    private:
+    static constexpr std::size_t size_ = 16;
+    static constexpr std::size_t bits_ =
+        static_cast<std::size_t>(std::numeric_limits<unsigned long>::digits);
+
+    unsigned long mask_[size_];
+
+    NUMANodes() { reset(); }
+
+    NUMANodes(const NUMANodes &) = delete;
+    NUMANodes &operator=(const NUMANodes &) = delete;
+}; // class NUMANodes
+
+/// \brief The directory of the files mapped by AlignedMemoryPage<PageFile>
+/// \ingroup AlignedMemory
+///
+/// \details
+/// By default, it is the value of the environment variable `TMPDIR`, or
+/// `/tmp` if it is not set. It shall be on a file system with enough space
+/// for the mapped containers. Each file is unlinked as soon as it is mapped
+/// and is removed when the memory is freed or the program exits.
+class MemoryFileDir
+{
+    public:
+    static MemoryFileDir &instance()
+    {
+        static MemoryFileDir dir;
+
+        return dir;
+    }
+
+    /// \brief Set the directory
+    void set(const std::string &path) { path_ = path; }
+
+    /// \brief The directory
+    const std::string &get() const { return path_; }
+
+    private:
+    std::string path_;
+
+    MemoryFileDir()
+    {
+        const char *tmpdir = std::getenv("TMPDIR");
+        path_ = tmpdir == nullptr ? "/tmp" : tmpdir;
+    }
+
+    MemoryFileDir(const MemoryFileDir &) = delete;
+    MemoryFileDir &operator=(const MemoryFileDir &) = delete;
+}; // class MemoryFileDir
+
+/// \brief Aligned memory using `mmap` with page and NUMA policies
+/// \ingroup AlignedMemory
+///
+/// \tparam Page The page type of the mapping
+/// \tparam NUMA The placement of the pages across NUMA nodes, which requires
+/// `VSMC_HAS_NUMA` and is ignored otherwise
+///
+/// \details
+/// Allocations of at least `VSMC_ALIGNED_MEMORY_PAGE_THRESHOLD` bytes are
+/// mapped with `mmap`, aligned to `VSMC_HUGE_PAGE_SIZE` if huge pages are
+/// requested, such that the state and weights of a large particle system
+/// causes fewer TLB misses and are placed on the NUMA nodes as required. The
+/// policies are applied before the pages are touched. Smaller allocations use
+/// `std::malloc`. For example, to use transparent huge pages interleaved
+/// across NUMA nodes for all vSMC containers, define the macro
+/// `VSMC_ALIGNED_MEMORY_TYPE` as
+/// `::vsmc::AlignedMemoryPage<::vsmc::PageHuge, ::vsmc::NUMAInterleave>`
+/// before including any vSMC header. The page policies are hints. If
+/// transparent huge pages are disabled or no huge page is reserved, normal
+/// pages are used.
+///
+/// With `PageFile`, the memory is a shared mapping of a temporary file, such
+/// that a container can be larger than the physical memory, and its pages
+/// are written back to the file instead of the swap. The mapping is advised
+/// to be read sequentially, and `memory_advise` can prefetch the ranges to
+/// be processed next. Usually only the largest containers are mapped this
+/// way, see `VSMC_STATE_MATRIX_MEMORY_TYPE` and `VSMC_WEIGHT_MEMORY_TYPE`.
+/// If the file cannot be created, a runtime warning is issued and the memory
+/// is allocated by `std::malloc`.
+template <MemoryPage Page, MemoryNUMA NUMA = NUMADefault>
+class AlignedMemoryPage
+{
+    public:
+    static void *aligned_malloc(std::size_t n, std::size_t alignment)
+    {
+        VSMC_RUNTIME_ASSERT_UTILITY_ALIGNED_MEMORY;
+
+        if (n == 0)
+            return nullptr;
+
+        const std::size_t offset = round_up(sizeof(header), alignment);
+        header h = {nullptr, 0};
+        if (n >= VSMC_ALIGNED_MEMORY_PAGE_THRESHOLD)
+            h = map(n + offset, alignment);
+        if (h.addr == nullptr) {
+            h.addr = std::malloc(n + offset + alignment);
+            if (h.addr == nullptr)
+                throw std::bad_alloc();
+        }
+
+        const std::size_t address = reinterpret_cast<std::size_t>(h.addr);
+        void *ptr = reinterpret_cast<void *>(
+            round_up(address + sizeof(header), alignment));
+        reinterpret_cast<header *>(ptr)[-1] = h;
+
+        return ptr;
+    }
+
+    static void aligned_free(void *ptr)
+    {
+        const header h = static_cast<header *>(ptr)[-1];
+        if (h.len == 0)
+            std::free(h.addr);
+        else
+            ::munmap(h.addr, h.len);
+    }
+
+    private:
+    struct header {
+        void *addr;
+        std::size_t len;
+    };
+
+    static std::size_t round_up(std::size_t n, std::size_t alignment)
+    {
+        return (n + alignment - 1) / alignment * alignment;
+    }
+
+    static header map(std::size_t n, std::size_t alignment)
+    {
+        header h = {nullptr, 0};
+        const int prot = PROT_READ | PROT_WRITE;
+        const int flags = MAP_PRIVATE | MAP_ANON;
+        const bool huge = Page == PageHuge || Page == PageHugeTLB;
+
+#ifdef MAP_HUGETLB
+        if (Page == PageHugeTLB && alignment <= VSMC_HUGE_PAGE_SIZE) {
+            const std::size_t len = round_up(n, VSMC_HUGE_PAGE_SIZE);
+            void *addr = ::mmap(nullptr, len, prot, flags | MAP_HUGETLB, -1, 0);
+            if (addr != MAP_FAILED) {
+                h.addr = addr;
+                h.len = len;
+                place(h);
+                return h;
+            }
+        }
+#endif
+
+        // Map more than needed and unmap the unaligned head and tail
+        const std::size_t page =
+            static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        std::size_t align = std::max(alignment, page);
+        if (huge) {
+            align = std::max(
+                align, static_cast<std::size_t>(VSMC_HUGE_PAGE_SIZE));
+        }
+        const std::size_t len = round_up(n, align);
+        void *addr = MAP_FAILED;
+        if (Page == PageFile) {
+            const int fd = file(len + align);
+            if (fd == -1)
+                return h;
+            addr = ::mmap(nullptr, len + align, prot, MAP_SHARED, fd, 0);
+            ::close(fd);
+        } else {
+            addr = ::mmap(nullptr, len + align, prot, flags, -1, 0);
+        }
+        if (addr == MAP_FAILED)
+            return h;
+        const std::size_t first = reinterpret_cast<std::size_t>(addr);
+        const std::size_t start = round_up(first, align);
+        const std::size_t last = first + len + align;
+        if (start != first)
+            ::munmap(addr, start - first);
+        if (start + len != last)
+            ::munmap(reinterpret_cast<void *>(start + len), last - start - len);
+        h.addr = reinterpret_cast<void *>(start);
+        h.len = len;
+#ifdef MADV_HUGEPAGE
+        if (huge)
+            ::madvise(h.addr, h.len, MADV_HUGEPAGE);
+#endif
+        if (Page == PageFile)
+            ::madvise(h.addr, h.len, MADV_SEQUENTIAL);
+        place(h);
+
+        return h;
+    }
+
+    // An unlinked file of n bytes, or -1 if it cannot be created
+    static int file(std::size_t n)
+    {
+        std::string path(MemoryFileDir::instance().get() + "/vsmc.XXXXXX");
+        std::vector<char> name(path.begin(), path.end());
+        name.push_back('\0');
+        const int fd = ::mkstemp(name.data());
+        VSMC_RUNTIME_WARNING_UTILITY_ALIGNED_MEMORY_FILE(fd);
+        if (fd == -1)
+            return fd;
+
+        ::unlink(name.data());
+        if (::ftruncate(fd, static_cast<off_t>(n)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+
+        return fd;
+    }
+
+#if VSMC_HAS_NUMA
+    static void place(const header &h)
+    {
+        if (NUMA == NUMADefault || NUMANodes::instance().empty())
+            return;
+
+        const int mode = NUMA == NUMAInterleave ? MPOL_INTERLEAVE : MPOL_BIND;
+        long status = ::mbind(h.addr, h.len, mode,
+            NUMANodes::instance().mask(), NUMANodes::instance().maxnode(), 0);
+        VSMC_RUNTIME_WARNING_UTILITY_ALIGNED_MEMORY_MBIND(status);
+    }
+#else  // VSMC_HAS_NUMA
+    static void place(const header &) {}
+#endif // VSMC_HAS_NUMA
+}; // class AlignedMemoryPage
+
+/// \brief Aligned memory mapped from temporary files
+/// \ingroup AlignedMemory
+using AlignedMemoryFile = AlignedMemoryPage<PageFile>;
+
+#endif // VSMC_HAS_POSIX
+
+namespace internal
+{
+
+// Whether the memory is mapped from files, such that prefetching its ranges
+// with memory_advise pays for the system calls
+template <typename Memory>
+class is_memory_file : public std::false_type
+{
+}; // class is_memory_file
+
+#if VSMC_HAS_POSIX
+template <MemoryNUMA NUMA>
+class is_memory_file<AlignedMemoryPage<PageFile, NUMA>> : public std::true_type
+{
+}; // class is_memory_file
+#endif // VSMC_HAS_POSIX
+
+} // namespace vsmc::internal
+
+/// \brief Advice on the use of a range of memory
+/// \ingroup AlignedMemory
+enum MemoryAdvice {
+    AdviceNormal,     ///< No special treatment
+    AdviceSequential, ///< Read sequentially, e.g., aggressive read ahead
+    AdviceRandom,     ///< Read randomly, e.g., no read ahead
+    AdviceWillNeed,   ///< Read soon, e.g., prefetch from the file
+    AdviceDontNeed    ///< Not read soon, release the pages, see below
+};                    // enum MemoryAdvice
+
+/// \brief Advise the system on the use of `n` bytes of memory from `ptr`
+/// \ingroup AlignedMemory
+///
+/// \details
+/// The range is extended to whole pages. It is a hint, which matters most
+/// for memory mapped from files, e.g., by AlignedMemoryFile. It does nothing
+/// on systems without `madvise`. With `AdviceDontNeed`, the pages of a file
+/// mapping are read again from the file when needed, while those of private
+/// anonymous memory are lost and read as zeros. Thus it shall only be used
+/// with memory mapped from files.
+#if VSMC_HAS_POSIX
+inline void memory_advise(const void *ptr, std::size_t n, MemoryAdvice advice)
+{
+    if (ptr == nullptr || n == 0)
+        return;
+
+    int adv = MADV_NORMAL;
+    switch (advice) {
+        case AdviceNormal: adv = MADV_NORMAL; break;
+        case AdviceSequential: adv = MADV_SEQUENTIAL; break;
+        case AdviceRandom: adv = MADV_RANDOM; break;
+        case AdviceWillNeed: adv = MADV_WILLNEED; break;
+        case AdviceDontNeed: adv = MADV_DONTNEED; break;
+    }
+    const std::size_t page =
+        static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t first = reinterpret_cast<std::size_t>(ptr);
+    const std::size_t start = first / page * page;
+    ::madvise(reinterpret_cast<void *>(start), first + n - start, adv);
+}
+#else  // VSMC_HAS_POSIX
+inline void memory_advise(const void *, std::size_t, MemoryAdvice) {}
+#endif // VSMC_HAS_POSIX
+
 /// \brief Default AlignedMemory type
 /// \ingroup AlignedMemory
 using AlignedMemory = VSMC_ALIGNED_MEMORY_TYPE;
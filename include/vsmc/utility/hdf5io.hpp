@@ -701,8 +701,56 @@ inline void hdf5store(const StateMatrix<Layout, Dim, T> &state,
     const std::string &file_name, const std::string &data_name,
     bool append = false)
 {
-    hdf5store_matrix<Layout, T>(
-        state.size(), state.dim(), file_name, data_name, state.data(), append);
+    if (state.stride() == (Layout == RowMajor ? state.dim() : state.size())) {
+        hdf5store_matrix<Layout, T>(state.size(), state.dim(), file_name,
+            data_name, state.data(), append);
+    } else {
+        Vector<T> data(state.size() * state.dim());
+        state.template read_state_matrix<Layout>(data.data());
+        hdf5store_matrix<Layout, T>(state.size(), state.dim(), file_name,
+            data_name, data.data(), append);
+    }
+}
+
+namespace internal
+{
+
+template <typename StateType>
+inline void hdf5store_state_tuple(const StateType &, const std::string &,
+    const std::string &, std::integral_constant<std::size_t, 0>)
+{
+}
+
+template <typename StateType, std::size_t Pos>
+inline void hdf5store_state_tuple(const StateType &state,
+    const std::string &file_name, const std::string &data_name,
+    std::integral_constant<std::size_t, Pos>)
+{
+    hdf5store_state_tuple(state, file_name, data_name,
+        std::integral_constant<std::size_t, Pos - 1>());
+    using value_type = typename StateType::template state_type<Pos - 1>;
+    Vector<value_type> data(state.size());
+    state.template read_state<Pos - 1>(data.data());
+    hdf5store_list_insert<value_type>(state.size(), file_name, data_name,
+        data.data(), "V" + std::to_string(Pos - 1));
+}
+
+} // namespace vsmc::internal
+
+/// \brief Store a StateTuple in the HDF5 format
+/// \ingroup HDF5IO
+///
+/// \details
+/// The state is stored as a list, whose elements are the fields named `V0`,
+/// `V1`, etc.
+template <MatrixLayout Layout, typename T, typename... Types>
+inline void hdf5store(const StateTuple<Layout, T, Types...> &state,
+    const std::string &file_name, const std::string &data_name,
+    bool append = false)
+{
+    hdf5store_list_empty(file_name, data_name, append);
+    internal::hdf5store_state_tuple(state, file_name, data_name,
+        std::integral_constant<std::size_t, sizeof...(Types) + 1>());
 }
 
 /// \brief Store a StateCL in the HDF5 format
@@ -732,8 +780,9 @@ inline void hdf5store(const Particle<T> &particle,
 {
     hdf5store_list_empty(file_name, data_name, append);
     hdf5store(particle.value(), file_name, data_name + "/value", true);
-    hdf5store_matrix<ColMajor, double>(particle.size(), 1, file_name,
-        data_name + "/weight", particle.weight().data(), true);
+    hdf5store_matrix<ColMajor, typename Particle<T>::weight_value_type>(
+        particle.size(), 1, file_name, data_name + "/weight",
+        particle.weight().data(), true);
 }
 
 /// \brief Store a Particle with StateCL value type in the HDF5 format
@@ -746,8 +795,9 @@ inline void hdf5store(const Particle<U> &particle,
     hdf5store_list_empty(file_name, data_name, append);
     hdf5store<Layout, T>(
         particle.value(), file_name, data_name + "/value", true);
-    hdf5store_matrix<ColMajor, double>(particle.size(), 1, file_name,
-        data_name + "/weight", particle.weight().data(), true);
+    hdf5store_matrix<ColMajor, typename Particle<U>::weight_value_type>(
+        particle.size(), 1, file_name, data_name + "/weight",
+        particle.weight().data(), true);
 }
 
 } // namespace vsmc
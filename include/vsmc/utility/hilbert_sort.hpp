@@ -0,0 +1,196 @@
+//============================================================================
+// vSMC/include/vsmc/utility/hilbert_sort.hpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c) 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#ifndef VSMC_UTILITY_HILBERT_SORT_HPP
+#define VSMC_UTILITY_HILBERT_SORT_HPP
+
+#include <vsmc/internal/common.hpp>
+#if VSMC_USE_TBB
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#endif
+
+namespace vsmc
+{
+
+namespace internal
+{
+
+// Skilling (2004), the transpose of the Hilbert index of the point x with
+// bits significant bits in each of the dim coordinates, interleaved into a
+// single key
+inline std::uint64_t hilbert_key(
+    std::size_t dim, std::size_t bits, std::uint32_t *x)
+{
+    const std::uint32_t m = static_cast<std::uint32_t>(1) << (bits - 1);
+
+    for (std::uint32_t q = m; q > 1; q >>= 1) {
+        const std::uint32_t p = q - 1;
+        for (std::size_t i = 0; i != dim; ++i) {
+            if (x[i] & q) {
+                x[0] ^= p;
+            } else {
+                std::uint32_t t = (x[0] ^ x[i]) & p;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+
+    for (std::size_t i = 1; i != dim; ++i)
+        x[i] ^= x[i - 1];
+    std::uint32_t t = 0;
+    for (std::uint32_t q = m; q > 1; q >>= 1)
+        if (x[dim - 1] & q)
+            t ^= q - 1;
+    for (std::size_t i = 0; i != dim; ++i)
+        x[i] ^= t;
+
+    std::uint64_t key = 0;
+    std::size_t n = 0;
+    for (std::size_t b = bits; b != 0; --b) {
+        for (std::size_t i = 0; i != dim; ++i) {
+            if (n++ == 64)
+                return key;
+            key = (key << 1) | ((x[i] >> (b - 1)) & 1);
+        }
+    }
+
+    return key;
+}
+
+template <typename RealType>
+inline void hilbert_sort_key(MatrixLayout layout, std::size_t dim,
+    const RealType *x, std::size_t ld, const double *loc, const double *scale,
+    std::size_t bits, std::size_t first, std::size_t last,
+    std::pair<std::uint64_t, std::size_t> *key)
+{
+    const double cells = static_cast<double>(static_cast<std::uint64_t>(1)
+        << bits);
+    const std::uint32_t cmax =
+        static_cast<std::uint32_t>((static_cast<std::uint64_t>(1) << bits) - 1);
+    Vector<std::uint32_t> c(dim);
+    for (std::size_t i = first; i != last; ++i) {
+        for (std::size_t j = 0; j != dim; ++j) {
+            const double v = static_cast<double>(
+                layout == RowMajor ? x[i * ld + j] : x[j * ld + i]);
+            const double u = 1 / (1 + std::exp(-(v - loc[j]) * scale[j]));
+            const double q = u * cells;
+            c[j] = q < cmax ? static_cast<std::uint32_t>(q) : cmax;
+        }
+        key[i].first = hilbert_key(dim, bits, c.data());
+        key[i].second = i;
+    }
+}
+
+} // namespace vsmc::internal
+
+/// \brief Sort points along the Hilbert space filling curve
+/// \ingroup HilbertSort
+///
+/// \details
+/// Each coordinate is mapped into \f$(0, 1)\f$ by the logistic function of
+/// its value standardized by the mean and standard deviation of the column,
+/// and quantized to \f$\min(32, \lfloor 64 / d\rfloor)\f$ bits, such that
+/// the Hilbert index of each point fits in 64 bits. For \f$d > 64\f$, only
+/// the leading 64 bits of the index are used. Points with the same
+/// index are ordered by their positions in the input. With
+/// `VSMC_USE_TBB`, the indices are computed and sorted in parallel.
+///
+/// \param layout The storage layout of `x`
+/// \param N The number of points
+/// \param dim The dimension of the points
+/// \param x An `N` by `dim` matrix of the points
+/// \param ld The leading dimension of `x`, no less than `dim` if `layout` is
+/// RowMajor and no less than `N` otherwise
+/// \param index The output. The `k`th point along the Hilbert curve is the
+/// `index[k]`th row of `x`.
+template <typename RealType, typename IntType>
+inline void hilbert_sort(MatrixLayout layout, std::size_t N, std::size_t dim,
+    const RealType *x, std::size_t ld, IntType *index)
+{
+    if (N == 0)
+        return;
+
+    if (dim == 0) {
+        for (std::size_t k = 0; k != N; ++k)
+            index[k] = static_cast<IntType>(k);
+        return;
+    }
+
+    Vector<double> loc(dim, 0);
+    Vector<double> scale(dim, 0);
+    for (std::size_t i = 0; i != N; ++i) {
+        for (std::size_t j = 0; j != dim; ++j) {
+            const double v = static_cast<double>(
+                layout == RowMajor ? x[i * ld + j] : x[j * ld + i]);
+            loc[j] += v;
+            scale[j] += v * v;
+        }
+    }
+    for (std::size_t j = 0; j != dim; ++j) {
+        loc[j] /= N;
+        const double var = scale[j] / N - loc[j] * loc[j];
+        scale[j] = var > 0 ? 1 / std::sqrt(var) : 1;
+    }
+
+    const std::size_t bits = dim > 64 ? 1 : (dim > 2 ? 64 / dim : 32);
+    Vector<std::pair<std::uint64_t, std::size_t>> key(N);
+#if VSMC_USE_TBB
+    ::tbb::parallel_for(::tbb::blocked_range<std::size_t>(0, N),
+        [&](const ::tbb::blocked_range<std::size_t> &range) {
+            internal::hilbert_sort_key(layout, dim, x, ld, loc.data(),
+                scale.data(), bits, range.begin(), range.end(), key.data());
+        });
+    ::tbb::parallel_sort(key.begin(), key.end());
+#else  // VSMC_USE_TBB
+    internal::hilbert_sort_key(layout, dim, x, ld, loc.data(), scale.data(),
+        bits, 0, N, key.data());
+    std::sort(key.begin(), key.end());
+#endif // VSMC_USE_TBB
+
+    for (std::size_t k = 0; k != N; ++k)
+        index[k] = static_cast<IntType>(key[k].second);
+}
+
+/// \brief Sort points of a contiguous matrix along the Hilbert space filling
+/// curve
+/// \ingroup HilbertSort
+template <typename RealType, typename IntType>
+inline void hilbert_sort(MatrixLayout layout, std::size_t N, std::size_t dim,
+    const RealType *x, IntType *index)
+{
+    hilbert_sort(layout, N, dim, x, layout == RowMajor ? dim : N, index);
+}
+
+} // namespace vsmc
+
+#endif // VSMC_UTILITY_HILBERT_SORT_HPP
@@ -0,0 +1,236 @@
+//============================================================================
+// vSMC/include/vsmc/utility/scratch_arena.hpp
+//----------------------------------------------------------------------------
+//                         vSMC: Scalable Monte Carlo
+//----------------------------------------------------------------------------
+// Copyright (c) 2013-2016, Yan Zhou
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//   Redistributions of source code must retain the above copyright notice,
+//   this list of conditions and the following disclaimer.
+//
+//   Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//============================================================================
+
+#ifndef VSMC_UTILITY_SCRATCH_ARENA_HPP
+#define VSMC_UTILITY_SCRATCH_ARENA_HPP
+
+#include <vsmc/internal/common.hpp>
+
+/// \brief Alignment of memory allocated by ScratchArena
+/// \ingroup Config
+#ifndef VSMC_SCRATCH_ARENA_ALIGNMENT
+#define VSMC_SCRATCH_ARENA_ALIGNMENT 64
+#endif
+
+namespace vsmc
+{
+
+/// \brief Bump pointer arena of scratch memory
+/// \ingroup ScratchArena
+///
+/// \details
+/// Memory is allocated by advancing an offset into a single block. An
+/// allocation that does not fit is served by a separate overflow block, such
+/// that pointers previously returned remain valid until `reset` or `rewind`.
+/// The arena records the peak usage, and `reset` grows the block to it.
+/// Therefore, once the arena has seen a typical cycle of allocations, say an
+/// iteration of Sampler, further cycles do not allocate any memory.
+///
+/// The memory is uninitialized and no destructor is ever called. The arena
+/// is not thread-safe. It shall be used by one thread at a time, e.g., in
+/// `eval_pre` and `eval_post` of the SMP base classes.
+class ScratchArena
+{
+    public:
+    /// \brief Position of the arena, to which it can be rewound
+    class mark_type
+    {
+        public:
+        mark_type(std::size_t offset, std::size_t overflow)
+            : offset_(offset), overflow_(overflow)
+        {
+        }
+
+        private:
+        std::size_t offset_;
+        std::size_t overflow_;
+
+        friend ScratchArena;
+    }; // class mark_type
+
+    /// \brief Construct an arena with a block of `capacity` bytes
+    explicit ScratchArena(std::size_t capacity = 0)
+        : offset_(0), overflow_size_(0), overflow_num_(0), peak_(0)
+    {
+        reserve(capacity);
+    }
+
+    /// \brief Construct an empty arena with the same capacity as `other`
+    ScratchArena(const ScratchArena &other)
+        : offset_(0), overflow_size_(0), overflow_num_(0), peak_(0)
+    {
+        reserve(other.capacity());
+    }
+
+    /// \brief The allocations and the memory are not assigned
+    ScratchArena &operator=(const ScratchArena &) { return *this; }
+
+    ScratchArena(ScratchArena &&) = default;
+
+    ScratchArena &operator=(ScratchArena &&) = default;
+
+    /// \brief Allocate uninitialized memory of `n` objects of type `T`
+    template <typename T>
+    T *allocate(std::size_t n)
+    {
+        static_assert(std::is_trivially_destructible<T>::value,
+            "**ScratchArena::allocate** USED WITH A TYPE NOT TRIVIALLY "
+            "DESTRUCTIBLE");
+        static_assert(alignof(T) <= VSMC_SCRATCH_ARENA_ALIGNMENT,
+            "**ScratchArena::allocate** USED WITH A TYPE OF ALIGNMENT "
+            "LARGER THAN VSMC_SCRATCH_ARENA_ALIGNMENT");
+
+        const std::size_t bytes = round_up(n * sizeof(T));
+        void *ptr = nullptr;
+        if (bytes <= block_.size() - offset_) {
+            ptr = block_.data() + offset_;
+            offset_ += bytes;
+        } else {
+            overflow_.emplace_back(bytes);
+            ptr = overflow_.back().data();
+            overflow_size_ += bytes;
+            ++overflow_num_;
+        }
+        peak_ = std::max(peak_, size());
+
+        return static_cast<T *>(ptr);
+    }
+
+    /// \brief The current position
+    mark_type mark() const { return mark_type(offset_, overflow_.size()); }
+
+    /// \brief Release the allocations made after a mark
+    void rewind(const mark_type &m)
+    {
+        offset_ = m.offset_;
+        while (overflow_.size() > m.overflow_) {
+            overflow_size_ -= overflow_.back().size();
+            overflow_.pop_back();
+        }
+    }
+
+    /// \brief Release all allocations, and grow the block to the peak usage
+    void reset()
+    {
+        offset_ = 0;
+        overflow_.clear();
+        overflow_size_ = 0;
+        if (peak_ > block_.size()) {
+            storage_type().swap(block_);
+            block_.resize(peak_);
+        }
+    }
+
+    /// \brief Grow the block to at least `bytes` bytes, immediately if the
+    /// arena is not in use, and at the next `reset` otherwise
+    void reserve(std::size_t bytes)
+    {
+        bytes = round_up(bytes);
+        if (bytes <= block_.size())
+            return;
+
+        peak_ = std::max(peak_, bytes);
+        if (size() == 0)
+            reset();
+    }
+
+    /// \brief The number of bytes in use
+    std::size_t size() const { return offset_ + overflow_size_; }
+
+    /// \brief The number of bytes of the block
+    std::size_t capacity() const { return block_.size(); }
+
+    /// \brief The maximum number of bytes in use, or reserved, so far
+    std::size_t peak() const { return peak_; }
+
+    /// \brief The number of allocations that did not fit in the block so far
+    std::size_t overflow() const { return overflow_num_; }
+
+    private:
+    using storage_type = std::vector<char,
+        internal::DefaultInitAllocator<
+            AlignedAllocator<char, VSMC_SCRATCH_ARENA_ALIGNMENT>>>;
+
+    std::size_t offset_;
+    std::size_t overflow_size_;
+    std::size_t overflow_num_;
+    std::size_t peak_;
+    storage_type block_;
+    std::vector<storage_type> overflow_;
+
+    static std::size_t round_up(std::size_t bytes)
+    {
+        const std::size_t alignment = VSMC_SCRATCH_ARENA_ALIGNMENT;
+
+        return (bytes + alignment - 1) / alignment * alignment;
+    }
+}; // class ScratchArena
+
+/// \brief Rewind a ScratchArena to its position at construction when out of
+/// scope (similar to a mutex lock guard)
+/// \ingroup ScratchArena
+class ScratchArenaGuard
+{
+    public:
+    explicit ScratchArenaGuard(ScratchArena &arena)
+        : arena_(arena), mark_(arena.mark())
+    {
+    }
+
+    ~ScratchArenaGuard() { arena_.rewind(mark_); }
+
+    ScratchArenaGuard(const ScratchArenaGuard &) = delete;
+    ScratchArenaGuard &operator=(const ScratchArenaGuard &) = delete;
+
+    private:
+    ScratchArena &arena_;
+    const ScratchArena::mark_type mark_;
+}; // class ScratchArenaGuard
+
+/// \brief Report the usage of a ScratchArena, in bytes
+/// \ingroup ScratchArena
+template <typename CharT, typename Traits>
+inline std::basic_ostream<CharT, Traits> &operator<<(
+    std::basic_ostream<CharT, Traits> &os, const ScratchArena &arena)
+{
+    if (!os.good())
+        return os;
+
+    os << "Size: " << arena.size() << ", Peak: " << arena.peak()
+       << ", Capacity: " << arena.capacity()
+       << ", Overflow: " << arena.overflow();
+
+    return os;
+}
+
+} // namespace vsmc
+
+#endif // VSMC_UTILITY_SCRATCH_ARENA_HPP
@@ -35,8 +35,10 @@
 #include <vsmc/internal/config.h>
 #include <vsmc/utility/aligned_memory.hpp>
 #include <vsmc/utility/covariance.hpp>
+#include <vsmc/utility/hilbert_sort.hpp>
 #include <vsmc/utility/program_option.hpp>
 #include <vsmc/utility/progress.hpp>
+#include <vsmc/utility/scratch_arena.hpp>
 #include <vsmc/utility/stop_watch.hpp>
 
 #if VSMC_HAS_HDF5
@@ -84,6 +84,10 @@
 /// \ingroup RNG
 /// \brief Distribution random varaites
 
+/// \defgroup HMC Hamiltonian Monte Carlo
+/// \ingroup RNG
+/// \brief Gradient based MCMC kernels
+
 /// \defgroup MKLRNG Intel Math Kernel Library
 /// \ingroup RNG
 /// \brief Random number generating using MKL RNG
@@ -96,6 +100,10 @@
 /// \ingroup RNG
 /// \brief Random number generating using Random123 Threefry RNG
 
+/// \defgroup QMC Quasi-Monte Carlo
+/// \ingroup RNG
+/// \brief Low discrepancy sequences
+
 /// \defgroup RandomWalk Random walk
 /// \ingroup RNG
 /// \brief Random walk MCMC kernels
@@ -146,6 +154,10 @@
 /// \ingroup Utility
 /// \brief Load and store objects in the HDF5 format
 
+/// \defgroup HilbertSort Hilbert curve
+/// \ingroup Utility
+/// \brief Sorting multivariate points along the Hilbert curve
+
 /// \defgroup MKL Intel Math Kernel Library
 /// \ingroup Utility
 /// \brief Resource management for Intel Math Kernel Library
@@ -158,6 +170,10 @@
 /// \ingroup Utility
 /// \brief Display progress while algorithms proceed
 
+/// \defgroup ScratchArena Scratch arena
+/// \ingroup Utility
+/// \brief Bump pointer allocation of temporary memory
+
 /// \defgroup SIMD SIMD
 /// \ingroup Utility
 /// \brief SIMD